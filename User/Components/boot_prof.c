@@ -0,0 +1,187 @@
+/**
+ ******************************************************************************
+ * @file    boot_prof.c
+ * @author  lingxing
+ * @brief   启动耗时剖析 (自动初始化逐项计时) + 非关键模块延后初始化
+ ******************************************************************************
+ * [实现]:
+ * - rt_init_profile_begin/end 覆盖内核 components.c 里的弱定义，
+ *   第一次回调时打开 DWT 并定为零点；计数 32 位，零点后约 25 s 内的时刻有效；
+ * - 延后初始化的描述符与普通 INIT_EXPORT 同属 .rti_fn 段，排在 rti_end 之后、
+ *   链接脚本的 __rt_init_end 之前，由 "defer" 线程遍历执行。
+ ******************************************************************************
+ */
+
+#include "boot_prof.h"
+#include "../../cubemx/Inc/main.h"
+#include "../My_Driver/bsp_dwt.h"
+#include "../My_App/app_static.h"
+#include <rthw.h>
+#include <string.h>
+
+#define BOOT_DEFER_STACK_SIZE 1024
+#define BOOT_DEFER_PRIORITY (RT_THREAD_PRIORITY_MAX - 5) /* 低于所有业务线程，高于日志线程 */
+#define BOOT_DEFER_TICK 5
+
+/* 描述符布局随内核配置变化：带名称 (RT_USING_INIT_PROFILE / RT_DEBUG_INIT) 或只有函数指针 */
+#if RT_DEBUG_INIT || defined(RT_USING_INIT_PROFILE)
+typedef struct rt_init_desc Boot_Desc_t;
+#define BOOT_DESC_FN(d) ((d)->fn)
+#define BOOT_DESC_NAME(d) ((d)->fn_name)
+extern const Boot_Desc_t __rt_init_desc_rti_end;
+#define BOOT_DESC_APP_END (&__rt_init_desc_rti_end)
+#else
+typedef init_fn_t Boot_Desc_t;
+#define BOOT_DESC_FN(d) (*(d))
+#define BOOT_DESC_NAME(d) "(deferred)"
+extern const Boot_Desc_t __rt_init_rti_end;
+#define BOOT_DESC_APP_END (&__rt_init_rti_end)
+#endif
+extern const uint8_t __rt_init_end[]; /* 链接脚本：.rti_fn 段结束 */
+
+typedef enum
+{
+    BOOT_KIND_INIT = 0, /* 启动路径上的自动初始化 */
+    BOOT_KIND_DEFER,    /* 延后初始化 */
+    BOOT_KIND_MARK,     /* 打点 */
+} Boot_Kind_t;
+
+typedef struct
+{
+    const char *name;
+    uint32_t start;  /* 相对零点的周期数 */
+    uint32_t cycles; /* 耗时 (打点为 0) */
+    int16_t result;
+    uint8_t kind;
+} Boot_Ent_t;
+
+static Boot_Ent_t boot_ent[BOOT_PROF_MAX];
+static uint16_t boot_num = 0;
+static uint32_t boot_t0 = 0;
+static uint32_t boot_begin = 0;
+static uint8_t boot_started = 0;
+
+APP_THREAD_DEFINE(defer_thread, BOOT_DEFER_STACK_SIZE);
+
+/**
+ * @brief  [内部函数] 相对零点的当前时刻 (周期数)，首次调用时打开 DWT 并定零点
+ */
+static uint32_t Boot_Prof_Now(void)
+{
+    if (!boot_started)
+    {
+        BSP_DWT_Init();
+        boot_t0 = DWT->CYCCNT;
+        boot_started = 1;
+    }
+    return DWT->CYCCNT - boot_t0;
+}
+
+/**
+ * @brief  [内部函数] 追加一条记录 (满了丢弃)
+ */
+static void Boot_Prof_Add(uint8_t kind, const char *name, uint32_t start, uint32_t cycles, int result)
+{
+    rt_base_t level = rt_hw_interrupt_disable();
+    if (boot_num < BOOT_PROF_MAX)
+    {
+        Boot_Ent_t *e = &boot_ent[boot_num++];
+        e->name = name;
+        e->start = start;
+        e->cycles = cycles;
+        e->result = (int16_t)result;
+        e->kind = kind;
+    }
+    rt_hw_interrupt_enable(level);
+}
+
+/* --- 内核回调 (覆盖 components.c 的弱定义) --- */
+void rt_init_profile_begin(void)
+{
+    boot_begin = Boot_Prof_Now();
+}
+
+void rt_init_profile_end(const char *fn_name, int result)
+{
+    Boot_Prof_Add(BOOT_KIND_INIT, fn_name, boot_begin, Boot_Prof_Now() - boot_begin, result);
+}
+
+/**
+ * @brief  记录一个时间点 (同名只记第一次)
+ * @param  name: 字符串常量
+ */
+void Boot_Prof_Mark(const char *name)
+{
+    for (uint16_t i = 0; i < boot_num; i++)
+    {
+        if (boot_ent[i].kind == BOOT_KIND_MARK && strcmp(boot_ent[i].name, name) == 0)
+            return;
+    }
+    Boot_Prof_Add(BOOT_KIND_MARK, name, Boot_Prof_Now(), 0, 0);
+}
+
+/**
+ * @brief 延后初始化线程：依次执行 INIT_DEFERRED_EXPORT 的函数后退出
+ */
+static void defer_proc(void *parameter)
+{
+    const Boot_Desc_t *d = BOOT_DESC_APP_END + 1;
+
+    for (; (const uint8_t *)d < __rt_init_end; d++)
+    {
+        uint32_t start = Boot_Prof_Now();
+        int result = BOOT_DESC_FN(d)();
+        Boot_Prof_Add(BOOT_KIND_DEFER, BOOT_DESC_NAME(d), start, Boot_Prof_Now() - start, result);
+    }
+    Boot_Prof_Mark("deferred done");
+}
+
+/**
+ * @brief 启动延后初始化线程
+ * @note  等级 "6.9" 排在所有 APP 级初始化之后、rti_end ("6.end") 之前
+ */
+static int Boot_Defer_Start(void)
+{
+    rt_thread_t tid = APP_THREAD_CREATE(defer_thread, "defer", defer_proc, RT_NULL, BOOT_DEFER_PRIORITY,
+                                        BOOT_DEFER_TICK);
+    if (tid == RT_NULL)
+        return -RT_ERROR;
+
+    rt_thread_startup(tid);
+    return RT_EOK;
+}
+INIT_EXPORT(Boot_Defer_Start, "6.9");
+
+/**
+ * @brief  [内部函数] 周期数换算为微秒 (64 位中间量，不受 ns 计数溢出影响)
+ */
+static uint32_t Boot_Prof_Us(uint32_t cycles)
+{
+    return (uint32_t)((uint64_t)cycles * 1000000u / SystemCoreClock);
+}
+
+/**
+ * @brief  msh 命令：启动耗时
+ */
+static void boot(int argc, char **argv)
+{
+    static const char *const kind_name[] = {"init", "defer", "mark"};
+    uint32_t init_us = 0;
+
+    rt_kprintf("  start ms    dur us   ret  kind   name\n");
+    rt_kprintf("---------- --------- ----- -----  ----------------\n");
+    for (uint16_t i = 0; i < boot_num; i++)
+    {
+        const Boot_Ent_t *e = &boot_ent[i];
+        uint32_t start_us = Boot_Prof_Us(e->start);
+        uint32_t dur_us = Boot_Prof_Us(e->cycles);
+
+        rt_kprintf("%6u.%03u %9u %5d %-5s  %s\n", (unsigned)(start_us / 1000), (unsigned)(start_us % 1000),
+                   (unsigned)dur_us, (int)e->result, kind_name[e->kind], e->name);
+        if (e->kind == BOOT_KIND_INIT)
+            init_us += dur_us;
+    }
+    rt_kprintf("init functions on the boot path: %u.%03u ms total (%u records)\n", (unsigned)(init_us / 1000),
+               (unsigned)(init_us % 1000), (unsigned)boot_num);
+}
+MSH_CMD_EXPORT(boot, boot time profile of auto-init functions and marks);
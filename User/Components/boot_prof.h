@@ -0,0 +1,36 @@
+/**
+ ******************************************************************************
+ * @file    boot_prof.h
+ * @author  lingxing
+ * @brief   启动耗时剖析 (自动初始化逐项计时) + 非关键模块延后初始化
+ ******************************************************************************
+ * @usage 使用说明:
+ * 1. 需打开 RT_USING_INIT_PROFILE (rtconfig.h)：内核在每个 INIT_xxx_EXPORT 函数
+ *    前后回调本模块，用 DWT 记录起止时刻与返回值。
+ * 2. 关键节点打点：Boot_Prof_Mark("ready");  同名只记第一次。
+ * 3. 不影响出发的模块用 INIT_DEFERRED_EXPORT(fn) 代替 INIT_APP_EXPORT：
+ *    所有 APP 级初始化结束后由低优先级 "defer" 线程依次执行，不占启动关键路径。
+ * 4. msh: boot   打印各初始化函数的 起始时刻 / 耗时 / 返回值、延后初始化与打点。
+ *
+ * [计时口径]:
+ * 时间零点为第一个板级初始化函数开始时 (DWT 在此时打开)，之前的时钟配置与
+ * HAL_Init 不在统计内；延后初始化与其他线程并发运行，耗时含被抢占时间。
+ ******************************************************************************
+ */
+
+#ifndef __BOOT_PROF_H
+#define __BOOT_PROF_H
+
+#include <rtthread.h>
+#include <stdint.h>
+
+#define BOOT_PROF_MAX 48 /* 记录条数上限 (初始化函数 + 延后初始化 + 打点) */
+
+/* 延后初始化：段名排在 rti_end ("6.end") 之后，rt_components_init 不会执行 */
+#ifndef INIT_DEFERRED_EXPORT
+#define INIT_DEFERRED_EXPORT(fn) INIT_EXPORT(fn, "7")
+#endif
+
+void Boot_Prof_Mark(const char *name);
+
+#endif /* __BOOT_PROF_H */
@@ -0,0 +1,326 @@
+/**
+ ******************************************************************************
+ * @file    cpu_load.c
+ * @author  lingxing
+ * @brief   线程 CPU 占用统计 (cputime 组件计时，调度/中断钩子累计)
+ ******************************************************************************
+ * [实现]:
+ * - 计时源为 cputime 组件 (cputime_cortexm.c 注册的 DWT->CYCCNT)，
+ *   只取低 32 位做差，两次结算间隔远小于回绕周期 (168 MHz 下约 25 s)；
+ * - 调度钩子在切换时把 "上一次结算 -> 现在" 记给被切出的线程，
+ *   扣除这段时间里累加的中断时间；
+ * - 中断进出钩子只在最外层 (nest == 1) 计时；若切换发生在中断里，
+ *   先把已过去的中断时间结算掉，保证每段线程时间扣除的中断都落在段内。
+ * 钩子均在关中断状态下被内核调用，统计量无需再加锁。
+ ******************************************************************************
+ */
+
+#include "cpu_load.h"
+#include <rthw.h>
+#include <drivers/cputime.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CPU_LOAD_IDLE_NAME "tidle0"
+
+typedef struct
+{
+    rt_thread_t thread;
+    uint64_t cycles;
+} Cpu_Slot_t;
+
+static Cpu_Slot_t cpu_slot[CPU_LOAD_THREADS_MAX];
+static uint16_t cpu_slot_num = 0;
+
+static uint64_t cpu_total = 0;     /* 已结算的总时间 */
+static uint64_t cpu_isr = 0;       /* 已结算的中断时间 */
+static uint64_t cpu_other = 0;     /* 统计表满后其余线程的时间 */
+static uint32_t cpu_switches = 0;
+static uint32_t cpu_slice_start;   /* 当前线程本段起点 */
+static uint64_t cpu_slice_isr;     /* 本段起点时的 cpu_isr */
+static uint32_t cpu_isr_start;     /* 最外层中断起点 */
+
+/* 挂在本模块之后的钩子 (Cpu_Load_Chain) */
+static void (*volatile chain_sched)(struct rt_thread *from, struct rt_thread *to) = RT_NULL;
+static void (*volatile chain_isr_enter)(void) = RT_NULL;
+static void (*volatile chain_isr_leave)(void) = RT_NULL;
+
+static inline uint32_t Cpu_Load_Now(void)
+{
+    return (uint32_t)clock_cpu_gettime();
+}
+
+/**
+ * @brief  [内部函数] 查找 / 分配线程的统计槽位 (表满返回 RT_NULL)
+ */
+static Cpu_Slot_t *Cpu_Load_Slot(rt_thread_t thread)
+{
+    for (uint16_t i = 0; i < cpu_slot_num; i++)
+    {
+        if (cpu_slot[i].thread == thread)
+            return &cpu_slot[i];
+    }
+    if (cpu_slot_num >= CPU_LOAD_THREADS_MAX)
+        return RT_NULL;
+
+    cpu_slot[cpu_slot_num].thread = thread;
+    cpu_slot[cpu_slot_num].cycles = 0;
+    return &cpu_slot[cpu_slot_num++];
+}
+
+/**
+ * @brief  [内部函数] 把本段时间结算给 thread，并开始新的一段 (须在关中断时调用)
+ */
+static void Cpu_Load_Settle(rt_thread_t thread, uint32_t now)
+{
+    if (rt_interrupt_get_nest() > 0)
+    {
+        cpu_isr += now - cpu_isr_start;
+        cpu_isr_start = now;
+    }
+
+    uint32_t span = now - cpu_slice_start;
+    uint64_t isr = cpu_isr - cpu_slice_isr;
+    uint32_t run = (isr < span) ? span - (uint32_t)isr : 0;
+
+    Cpu_Slot_t *s = Cpu_Load_Slot(thread);
+    if (s != RT_NULL)
+        s->cycles += run;
+    else
+        cpu_other += run;
+
+    cpu_total += span;
+    cpu_slice_start = now;
+    cpu_slice_isr = cpu_isr;
+}
+
+/* --- 内核钩子 --- */
+static void Cpu_Load_Hook_Switch(struct rt_thread *from, struct rt_thread *to)
+{
+    Cpu_Load_Settle(from, Cpu_Load_Now());
+    cpu_switches++;
+
+    if (chain_sched)
+        chain_sched(from, to);
+}
+
+static void Cpu_Load_Hook_IsrEnter(void)
+{
+    /* 内核先 nest++ 再调钩子 */
+    if (rt_interrupt_get_nest() == 1)
+        cpu_isr_start = Cpu_Load_Now();
+
+    if (chain_isr_enter)
+        chain_isr_enter();
+}
+
+static void Cpu_Load_Hook_IsrLeave(void)
+{
+    /* 内核先调钩子再 nest-- */
+    if (rt_interrupt_get_nest() == 1)
+        cpu_isr += Cpu_Load_Now() - cpu_isr_start;
+
+    if (chain_isr_leave)
+        chain_isr_leave();
+}
+
+/**
+ * @brief  在本模块的钩子之后挂接其他模块的钩子，传 RT_NULL 摘除
+ */
+void Cpu_Load_Chain(void (*sched)(struct rt_thread *from, struct rt_thread *to),
+                    void (*isr_enter)(void), void (*isr_leave)(void))
+{
+    rt_base_t level = rt_hw_interrupt_disable();
+    chain_sched = sched;
+    chain_isr_enter = isr_enter;
+    chain_isr_leave = isr_leave;
+    rt_hw_interrupt_enable(level);
+}
+
+/**
+ * @brief  取一份累计统计快照 (结算到当前时刻，并清理已删除线程的槽位)
+ */
+void Cpu_Load_Snapshot(Cpu_Load_Snap_t *snap)
+{
+    rt_object_t live[CPU_LOAD_THREADS_MAX * 2];
+    int live_num = rt_object_get_pointers(RT_Object_Class_Thread, live, CPU_LOAD_THREADS_MAX * 2);
+
+    rt_base_t level = rt_hw_interrupt_disable();
+    Cpu_Load_Settle(rt_thread_self(), Cpu_Load_Now());
+
+    uint16_t keep = 0;
+    snap->num = 0;
+    for (uint16_t i = 0; i < cpu_slot_num; i++)
+    {
+        rt_thread_t t = cpu_slot[i].thread;
+        int alive = 0;
+        for (int k = 0; k < live_num; k++)
+        {
+            if ((rt_thread_t)live[k] == t)
+            {
+                alive = 1;
+                break;
+            }
+        }
+
+        if (!alive)
+        {
+            /* 线程已删除，时间并入 other，腾出槽位 */
+            cpu_other += cpu_slot[i].cycles;
+            continue;
+        }
+
+        cpu_slot[keep++] = cpu_slot[i];
+        Cpu_Load_Thread_t *th = &snap->th[snap->num++];
+        memcpy(th->name, t->name, RT_NAME_MAX);
+        th->priority = t->current_priority;
+        th->cycles = cpu_slot[i].cycles;
+    }
+    cpu_slot_num = keep;
+
+    snap->total = cpu_total;
+    snap->isr = cpu_isr;
+    snap->other = cpu_other;
+    snap->switches = cpu_switches;
+    rt_hw_interrupt_enable(level);
+}
+
+/**
+ * @brief  [内部函数] 按名称取线程累计时间 (名称按 RT_NAME_MAX 截断比较)
+ */
+static uint64_t Cpu_Load_Find(const Cpu_Load_Snap_t *snap, const char *name)
+{
+    for (uint16_t i = 0; i < snap->num; i++)
+    {
+        if (strncmp(snap->th[i].name, name, RT_NAME_MAX) == 0)
+            return snap->th[i].cycles;
+    }
+    return 0;
+}
+
+/**
+ * @brief  两次快照之间某线程的占用率
+ * @return 千分比
+ */
+uint16_t Cpu_Load_Thread_Permille(const Cpu_Load_Snap_t *prev, const Cpu_Load_Snap_t *now, const char *name)
+{
+    uint64_t span = now->total - prev->total;
+    if (span == 0)
+        return 0;
+    return (uint16_t)((Cpu_Load_Find(now, name) - Cpu_Load_Find(prev, name)) * 1000 / span);
+}
+
+/**
+ * @brief  两次快照之间的总占用率 (1000 - 空闲线程占比)
+ * @return 千分比
+ */
+uint16_t Cpu_Load_Busy_Permille(const Cpu_Load_Snap_t *prev, const Cpu_Load_Snap_t *now)
+{
+    if (now->total == prev->total)
+        return 0;
+    return 1000 - Cpu_Load_Thread_Permille(prev, now, CPU_LOAD_IDLE_NAME);
+}
+
+/**
+ * @brief 挂上调度 / 中断钩子，从此刻开始统计
+ */
+int Cpu_Load_Init(void)
+{
+    rt_base_t level = rt_hw_interrupt_disable();
+    cpu_slice_start = Cpu_Load_Now();
+    cpu_slice_isr = cpu_isr;
+    rt_scheduler_sethook(Cpu_Load_Hook_Switch);
+    rt_interrupt_enter_sethook(Cpu_Load_Hook_IsrEnter);
+    rt_interrupt_leave_sethook(Cpu_Load_Hook_IsrLeave);
+    rt_hw_interrupt_enable(level);
+
+    if (clock_cpu_getres() == 0)
+        rt_kprintf("[cpu_load] no cputime source, load will read 0\n");
+    return RT_EOK;
+}
+INIT_COMPONENT_EXPORT(Cpu_Load_Init);
+
+/* --- msh --- */
+
+/**
+ * @brief  [内部函数] 千分比打印为 xx.x
+ */
+static void Cpu_Load_Print_Permille(uint32_t pm)
+{
+    rt_kprintf("%3u.%u", (unsigned)(pm / 10), (unsigned)(pm % 10));
+}
+
+/**
+ * @brief  msh 命令：线程 CPU 占用
+ * @usage  top [n] [ms]   每 ms 毫秒刷新一次，共 n 次
+ */
+static void top(int argc, char **argv)
+{
+    static Cpu_Load_Snap_t prev, now; /* 两份快照近 1 KB，不放 shell 栈上 */
+    int n = (argc >= 2) ? atoi(argv[1]) : 1;
+    int ms = (argc >= 3) ? atoi(argv[2]) : 1000;
+
+    if (n <= 0)
+        n = 1;
+    if (ms < 100)
+        ms = 100;
+
+    Cpu_Load_Snapshot(&prev);
+    for (int round = 0; round < n; round++)
+    {
+        rt_thread_mdelay(ms);
+        Cpu_Load_Snapshot(&now);
+
+        uint64_t span = now.total - prev.total;
+        float ns_per = clock_cpu_getres();
+        if (span == 0)
+        {
+            rt_kprintf("top: no cputime source\n");
+            return;
+        }
+
+        if (n > 1)
+            rt_kprintf("\033[2J\033[H"); /* 多次刷新时清屏 */
+
+        rt_kprintf("CPU ");
+        Cpu_Load_Print_Permille(Cpu_Load_Busy_Permille(&prev, &now));
+        rt_kprintf("%% busy, ISR ");
+        Cpu_Load_Print_Permille((uint32_t)((now.isr - prev.isr) * 1000 / span));
+        rt_kprintf("%%, %u switches/s, window %d ms\n",
+                   (unsigned)((uint64_t)(now.switches - prev.switches) * 1000 / ms), ms);
+        rt_kprintf("%-*.*s pri   cpu%%  runtime ms\n", RT_NAME_MAX, RT_NAME_MAX, "thread");
+        rt_kprintf("-------- ---  ------  ----------\n");
+
+        /* 按窗口内占用从高到低输出 */
+        uint8_t order[CPU_LOAD_THREADS_MAX];
+        uint32_t pm[CPU_LOAD_THREADS_MAX];
+        for (uint16_t i = 0; i < now.num; i++)
+        {
+            pm[i] = Cpu_Load_Thread_Permille(&prev, &now, now.th[i].name);
+            uint16_t k = i;
+            while (k > 0 && pm[order[k - 1]] < pm[i])
+            {
+                order[k] = order[k - 1];
+                k--;
+            }
+            order[k] = (uint8_t)i;
+        }
+
+        for (uint16_t i = 0; i < now.num; i++)
+        {
+            const Cpu_Load_Thread_t *th = &now.th[order[i]];
+            rt_kprintf("%-*.*s %3u  ", RT_NAME_MAX, RT_NAME_MAX, th->name, (unsigned)th->priority);
+            Cpu_Load_Print_Permille(pm[order[i]]);
+            rt_kprintf("  %10u\n", (unsigned)(th->cycles * ns_per / 1000000.0f));
+        }
+        if (now.other != prev.other)
+        {
+            rt_kprintf("%-*.*s      ", RT_NAME_MAX, RT_NAME_MAX, "other");
+            Cpu_Load_Print_Permille((uint32_t)((now.other - prev.other) * 1000 / span));
+            rt_kprintf("\n");
+        }
+
+        prev = now;
+    }
+}
+MSH_CMD_EXPORT(top, per-thread CPU load: top [n] [ms]);
@@ -0,0 +1,62 @@
+/**
+ ******************************************************************************
+ * @file    cpu_load.h
+ * @author  lingxing
+ * @brief   线程 CPU 占用统计 (cputime 组件计时，调度/中断钩子累计)
+ ******************************************************************************
+ * @usage 使用说明:
+ * 1. msh: top [n] [ms]   每 ms 毫秒 (默认 1000) 刷新一次，共 n 次 (默认 1)
+ *    显示各线程占用率 / 累计运行时间、中断占用、空闲占比与每秒切换次数。
+ * 2. 代码采样 (如遥测)：相隔一段时间各取一次快照，再按名称计算窗口内占用：
+ *      static Cpu_Load_Snap_t a, b;
+ *      Cpu_Load_Snapshot(&a);  ...  Cpu_Load_Snapshot(&b);
+ *      uint16_t busy = Cpu_Load_Busy_Permille(&a, &b);
+ *      uint16_t move = Cpu_Load_Thread_Permille(&a, &b, "move_proc");
+ *
+ * [计时口径]:
+ * - 线程时间在每次切换时结算，已扣除其间的中断时间；
+ * - 中断时间只统计调用了 rt_interrupt_enter/leave 的中断 (外设中断与 SysTick)，
+ *   嵌套中断按最外层计一次；步进比较中断 TIM1_CC 默认不包裹 (MOTOR_CC_IRQ_HOOK)，
+ *   其耗时计入被打断的线程 / 中断 (步进开销另见 ccm 命令的 step isr 统计)；
+ * - 空闲占比即 tidle0 线程的占用。
+ *
+ * [钩子复用]:
+ * RT-Thread 的调度与中断钩子各只有一个槽位，本模块常驻占用；
+ * 其他模块 (trace_rec) 通过 Cpu_Load_Chain 挂在后面，不要直接调用 rt_xxx_sethook。
+ ******************************************************************************
+ */
+
+#ifndef __CPU_LOAD_H
+#define __CPU_LOAD_H
+
+#include <rtthread.h>
+#include <stdint.h>
+
+#define CPU_LOAD_THREADS_MAX 16 /* 统计的线程数上限，超出的线程计入 "other" */
+
+typedef struct
+{
+    char name[RT_NAME_MAX];
+    uint8_t priority;
+    uint64_t cycles; /* 累计运行时间 (cputime 计数) */
+} Cpu_Load_Thread_t;
+
+typedef struct
+{
+    uint64_t total;    /* 累计总时间 = 各线程 + other + isr */
+    uint64_t isr;      /* 累计中断时间 */
+    uint64_t other;    /* 超出统计表的线程 */
+    uint32_t switches; /* 累计线程切换次数 */
+    uint16_t num;      /* th[] 有效条数 */
+    Cpu_Load_Thread_t th[CPU_LOAD_THREADS_MAX];
+} Cpu_Load_Snap_t;
+
+int Cpu_Load_Init(void);
+void Cpu_Load_Snapshot(Cpu_Load_Snap_t *snap);
+uint16_t Cpu_Load_Thread_Permille(const Cpu_Load_Snap_t *prev, const Cpu_Load_Snap_t *now, const char *name);
+uint16_t Cpu_Load_Busy_Permille(const Cpu_Load_Snap_t *prev, const Cpu_Load_Snap_t *now);
+
+void Cpu_Load_Chain(void (*sched)(struct rt_thread *from, struct rt_thread *to),
+                    void (*isr_enter)(void), void (*isr_leave)(void));
+
+#endif /* __CPU_LOAD_H */
@@ -0,0 +1,102 @@
+/**
+ ******************************************************************************
+ * @file    frame_pool.c
+ * @author  lingxing
+ * @brief   串口接收帧的定长内存池 (消息队列只传帧指针，零拷贝)
+ ******************************************************************************
+ * [实现]:
+ * 直接用内核 rt_mempool：定长块、申请 / 释放都是关中断摘链表头，O(1) 且中断里可用。
+ * 之前消息队列只传长度，消费者回头读驱动里唯一的 rx_buffer，线程没来得及解析时下一帧
+ * 的 DMA 已经在覆盖它；现在每帧独占一个块，可以有多帧在途。
+ ******************************************************************************
+ */
+
+#include "frame_pool.h"
+#include "../My_App/app_static.h"
+#include <rthw.h>
+#include <string.h>
+
+#define DBG_TAG "frame"
+#define DBG_LVL DBG_INFO
+#include <rtdbg.h>
+#include "log_async.h"
+
+static rt_mp_t frame_mp = RT_NULL;
+APP_MP_DEFINE(frame_mp, sizeof(Frame_t), FRAME_POOL_BLOCKS);
+
+static volatile uint32_t frame_fail = 0;     /* 池空导致的申请失败 */
+static volatile uint32_t frame_min_free = 0; /* 历史最少空闲块数 */
+
+/**
+ * @brief  初始化帧内存池 (须早于各串口的 BSP_UART_Init)
+ */
+int Frame_Pool_Init(void)
+{
+    frame_mp = APP_MP_CREATE(frame_mp, "mp_frm");
+    if (frame_mp == RT_NULL)
+    {
+        LOG_E("frame pool init failed");
+        return -1;
+    }
+    frame_min_free = frame_mp->block_free_count;
+    return 0;
+}
+INIT_COMPONENT_EXPORT(Frame_Pool_Init);
+
+/**
+ * @brief  申请一个帧块 (不阻塞，中断里可用)
+ * @return 帧块，池空或未初始化返回 RT_NULL
+ */
+Frame_t *Frame_Alloc(void)
+{
+    if (frame_mp == RT_NULL)
+        return RT_NULL;
+
+    Frame_t *f = (Frame_t *)rt_mp_alloc(frame_mp, 0);
+    rt_base_t level = rt_hw_interrupt_disable();
+    if (f == RT_NULL)
+        frame_fail++;
+    else if (frame_mp->block_free_count < frame_min_free)
+        frame_min_free = frame_mp->block_free_count;
+    rt_hw_interrupt_enable(level);
+
+    if (f != RT_NULL)
+        f->len = 0;
+    return f;
+}
+
+/**
+ * @brief  归还帧块 (中断里可用)
+ */
+void Frame_Free(Frame_t *f)
+{
+    if (f != RT_NULL)
+        rt_mp_free(f);
+}
+
+/**
+ * @brief  msh 命令：帧内存池使用情况
+ * @usage  frames [reset]
+ */
+static void frames(int argc, char **argv)
+{
+    if (frame_mp == RT_NULL)
+    {
+        rt_kprintf("frame pool not initialized\n");
+        return;
+    }
+
+    if (argc > 1 && strcmp(argv[1], "reset") == 0)
+    {
+        rt_base_t level = rt_hw_interrupt_disable();
+        frame_fail = 0;
+        frame_min_free = frame_mp->block_free_count;
+        rt_hw_interrupt_enable(level);
+        return;
+    }
+
+    rt_kprintf("blocks %u x %u bytes, free %u, min free %u, alloc fail %u\n", (unsigned)frame_mp->block_total_count,
+               (unsigned)sizeof(Frame_t), (unsigned)frame_mp->block_free_count, (unsigned)frame_min_free,
+               (unsigned)frame_fail);
+}
+MSH_CMD_EXPORT(frames, frame pool usage: frames [reset]);
@@ -0,0 +1,47 @@
+/**
+ ******************************************************************************
+ * @file    frame_pool.h
+ * @author  lingxing
+ * @brief   串口接收帧的定长内存池 (消息队列只传帧指针，零拷贝)
+ ******************************************************************************
+ * @usage 使用说明:
+ * 1. 生产者 (串口空闲中断)：DMA 直接收进一个帧块，收完把块指针投进消息队列，
+ *    再申请新块接着收；中断里只能用不阻塞的 Frame_Alloc。
+ *      Frame_t *f = Frame_Alloc();
+ *      ... 填 f->data / f->len ...
+ *      if (rt_mq_send(mq, &f, sizeof(f)) != RT_EOK) Frame_Free(f);
+ * 2. 消费者 (线程)：收到的是块指针，解析完必须归还：
+ *      Frame_t *f;
+ *      if (rt_mq_recv(mq, &f, sizeof(f), RT_WAITING_FOREVER) == RT_EOK) { Parse(f->data, f->len); Frame_Free(f); }
+ * 3. msh: frames         打印池容量、当前空闲、历史最少空闲、申请失败次数
+ *         frames reset   清零最少空闲与失败计数
+ *
+ * [约定]:
+ * - 块在 SRAM (DMA 要写)，不能放 CCM；
+ * - 一个块同一时刻只有一个主人：DMA -> 队列 -> 消费线程 -> 归还，谁拿到谁负责 Frame_Free；
+ * - 池空时生产者丢掉新帧、沿用手里的块，不会阻塞中断。
+ ******************************************************************************
+ */
+
+#ifndef __FRAME_POOL_H
+#define __FRAME_POOL_H
+
+#include <rtthread.h>
+#include <stdint.h>
+
+#define FRAME_DATA_SIZE 128  /* 单帧数据区 (= 串口 DMA 接收长度) */
+#define FRAME_POOL_BLOCKS 16 /* 3 路接收各占 1 块在 DMA 上，其余为在途帧 */
+
+/* 帧块 */
+typedef struct
+{
+    uint16_t len; /* 有效字节数 */
+    uint16_t reserved;
+    uint8_t data[FRAME_DATA_SIZE];
+} Frame_t;
+
+int Frame_Pool_Init(void);
+Frame_t *Frame_Alloc(void);
+void Frame_Free(Frame_t *f);
+
+#endif /* __FRAME_POOL_H */
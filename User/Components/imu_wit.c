@@ -54,11 +54,14 @@ void IMU_Init(void)
  * @brief  核心解析函数 (手动解析 0x55 协议)
  * @param  p_data: 串口原始数据指针
  * @param  len:    数据长度
+ * @return 角度帧个数
  */
-void IMU_ParsePacket(uint8_t *p_data, uint16_t len)
+uint16_t IMU_ParsePacket(uint8_t *p_data, uint16_t len)
 {
+    uint16_t angles = 0;
+
     if (p_data == NULL || len < 11)
-        return;
+        return 0;
 
     /* 寻找包头 0x55 */
     for (uint16_t i = 0; i <= (len - 11); i++)
@@ -80,12 +83,14 @@ void IMU_ParsePacket(uint8_t *p_data, uint16_t len)
                 g_imu_data.acc.x = (int16_t)(p_data[i + 3] << 8 | p_data[i + 2]) / 32768.0f * 16.0f;
                 g_imu_data.acc.y = (int16_t)(p_data[i + 5] << 8 | p_data[i + 4]) / 32768.0f * 16.0f;
                 g_imu_data.acc.z = (int16_t)(p_data[i + 7] << 8 | p_data[i + 6]) / 32768.0f * 16.0f;
+                g_imu_data.update |= IMU_UPD_ACC;
                 break;
 
             case 0x52: /* 角速度 */
                 g_imu_data.gyro.x = (int16_t)(p_data[i + 3] << 8 | p_data[i + 2]) / 32768.0f * 2000.0f;
                 g_imu_data.gyro.y = (int16_t)(p_data[i + 5] << 8 | p_data[i + 4]) / 32768.0f * 2000.0f;
                 g_imu_data.gyro.z = (int16_t)(p_data[i + 7] << 8 | p_data[i + 6]) / 32768.0f * 2000.0f;
+                g_imu_data.update |= IMU_UPD_GYRO;
                 break;
 
             case 0x53: /* 角度 */
@@ -108,12 +113,19 @@ void IMU_ParsePacket(uint8_t *p_data, uint16_t len)
                 g_imu_data.pitch = raw_pitch;
                 g_imu_data.yaw = continuous - g_yaw_offset;
                 g_imu_data.yaw_continuous = continuous;
+                g_imu_data.update |= IMU_UPD_ANGLE;
+                angles++;
                 break;
             }
+
+            default:
+                g_imu_data.update |= IMU_UPD_OTHER;
+                break;
             }
             i += 10; /* 跳过已处理包 */
         }
     }
+    return angles;
 }
 
 float IMU_GetYaw(void) { return g_imu_data.yaw; }
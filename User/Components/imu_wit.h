@@ -6,8 +6,8 @@
  ******************************************************************************
  * @usage 使用说明:
  * 1. 初始化: IMU_Init();
- * 2. 数据输入 (在 bsp_uart.c 中自动调用):
- *    IMU_ParsePacket(uart->rx_buffer, uart->rx_len);
+ * 2. 数据输入 (在 imu_proc 线程中调用):
+ *    IMU_ParsePacket(f->data, f->len);   (f 为 imu_mq 收到的帧块，见 frame_pool.h)
  *    // 参数 1: 串口接收缓冲区的首地址
  *    // 参数 2: 本次实际收到的字节长度
  * 3. 获取数据: float yaw = IMU_GetYaw();
@@ -21,6 +21,12 @@
 #include <stdbool.h>
 #include <stddef.h>
 
+/* 数据更新标志 (IMU_Data_t.update) */
+#define IMU_UPD_ACC 0x01   /* 0x51 加速度 */
+#define IMU_UPD_GYRO 0x02  /* 0x52 角速度 */
+#define IMU_UPD_ANGLE 0x04 /* 0x53 角度 */
+#define IMU_UPD_OTHER 0x80 /* 其他类型 (时间/磁场/四元数等，不解析) */
+
 /* IMU 数据结构体 */
 typedef struct
 {
@@ -40,6 +46,8 @@ typedef struct
     } gyro;
 
     float temp;
+
+    uint8_t update; /* 解析到的帧类型 (IMU_UPD_x 按位或)，由调用方读取后清零 */
 } IMU_Data_t;
 
 extern IMU_Data_t g_imu_data;
@@ -50,9 +58,11 @@ void IMU_Init(void);
  * @brief  解析维特智能原始数据序列
  * @param  p_data: 串口接收到的原始字节数组 (通常传入串口 DMA 的缓冲区指针)
  * @param  len:    本次解析的数据字节数
- * @note   函数会自动寻找 0x55 包头，如校验通过则更新全局角度、加速度、角速度数据。
+ * @return 本次解析到的角度帧 (0x53) 个数 (一次空闲中断可能合并了多组输出)
+ * @note   函数会自动寻找 0x55 包头，如校验通过则更新全局角度、加速度、角速度数据，
+ *         并在 g_imu_data.update 中置位对应的 IMU_UPD_x 标志。
  */
-void IMU_ParsePacket(uint8_t *p_data, uint16_t len);
+uint16_t IMU_ParsePacket(uint8_t *p_data, uint16_t len);
 
 /* --- 数据获取 --- */
 float IMU_GetYaw(void);
@@ -0,0 +1,247 @@
+/**
+ ******************************************************************************
+ * @file    irq_lat.c
+ * @author  lingxing
+ * @brief   外设中断延迟 / 执行时间测量 (按中断号统计最坏值)
+ ******************************************************************************
+ * [实现]:
+ * 入口 / 出口都在中断上下文，start / stop / reset 在线程里关中断完成，
+ * 线程能运行时所有中断都已退出，嵌套栈一定为空，开关不会让出入口配对错位。
+ * 统计表按中断号直接索引，放 CCM (见 bsp_ccm.h)。
+ ******************************************************************************
+ */
+
+#include "irq_lat.h"
+#include "../My_Driver/bsp_ccm.h"
+#include "../My_Driver/bsp_dwt.h"
+#include <rthw.h>
+#include <string.h>
+
+#define IRQ_LAT_BLOCK_NONE (-2)   /* 只有压栈开销 */
+#define IRQ_LAT_BLOCK_THREAD (-1) /* 线程里关中断的临界区 */
+#define IRQ_LAT_CC_FLAGS (TIM_SR_CC1IF | TIM_SR_CC2IF | TIM_SR_CC3IF | TIM_SR_CC4IF)
+
+typedef struct
+{
+    uint32_t count;
+    uint32_t exec_max; /* 独占执行时间 (周期) */
+    uint64_t exec_sum;
+    uint32_t lat_count;
+    uint32_t lat_max; /* 事件 -> 进入的延迟 (周期) */
+    uint64_t lat_sum;
+    int16_t blocker; /* 最坏延迟时的堵塞者：中断号 / IRQ_LAT_BLOCK_xxx */
+} Irq_Lat_Rec_t;
+
+typedef struct
+{
+    uint32_t start;
+    uint32_t child; /* 被更高优先级中断抢占的时间 */
+    int16_t irq;
+} Irq_Lat_Frame_t;
+
+static Irq_Lat_Rec_t irq_rec[IRQ_LAT_IRQ_NUM] CCM_BSS;
+static Irq_Lat_Frame_t irq_frame[IRQ_LAT_NEST_MAX] CCM_BSS;
+static uint8_t irq_depth = 0;
+static volatile uint8_t irq_on = 0;
+
+static uint32_t irq_last_leave = 0; /* 最近一次退出中断的时刻 */
+static int16_t irq_last_irq = IRQ_LAT_BLOCK_NONE;
+
+/**
+ * @brief  [内部函数] 比较中断：挂起通道中最早的 "CNT - CCR"，换算为内核周期
+ * @return 延迟周期；lat_ticks 返回计数值
+ */
+static uint32_t Irq_Lat_Tim(TIM_TypeDef *tim, uint8_t clk_div, uint32_t *lat_ticks)
+{
+    uint32_t cnt = tim->CNT;
+    uint32_t pend = tim->SR & tim->DIER & IRQ_LAT_CC_FLAGS;
+    const volatile uint32_t *ccr = &tim->CCR1;
+    uint32_t ticks = 0;
+
+    for (uint32_t ch = 0; ch < 4; ch++)
+    {
+        if (pend & (TIM_SR_CC1IF << ch))
+        {
+            uint32_t d = (cnt - ccr[ch]) & 0xFFFFu;
+            if (d > ticks)
+                ticks = d;
+        }
+    }
+    *lat_ticks = ticks;
+    return ticks * (tim->PSC + 1) * clk_div;
+}
+
+/**
+ * @brief  中断入口
+ * @param  tim: 比较中断所属定时器，RT_NULL 表示不测延迟
+ * @param  clk_div: 内核时钟 / 定时器时钟
+ */
+void Irq_Lat_Enter(TIM_TypeDef *tim, uint8_t clk_div)
+{
+    if (!irq_on)
+        return;
+
+    uint32_t now = DWT->CYCCNT;
+    int16_t irq = (int16_t)(__get_IPSR() - 16);
+    uint8_t d = irq_depth++;
+
+    if (d < IRQ_LAT_NEST_MAX)
+    {
+        irq_frame[d].start = now;
+        irq_frame[d].child = 0;
+        irq_frame[d].irq = irq;
+    }
+
+    if (tim != RT_NULL && irq >= 0 && irq < IRQ_LAT_IRQ_NUM)
+    {
+        uint32_t ticks;
+        uint32_t lat = Irq_Lat_Tim(tim, clk_div, &ticks);
+        Irq_Lat_Rec_t *r = &irq_rec[irq];
+
+        r->lat_count++;
+        r->lat_sum += lat;
+        if (lat > r->lat_max)
+        {
+            r->lat_max = lat;
+            if ((int32_t)(irq_last_leave - (now - lat)) > 0)
+                r->blocker = irq_last_irq;
+            else
+                r->blocker = (ticks >= 2) ? IRQ_LAT_BLOCK_THREAD : IRQ_LAT_BLOCK_NONE;
+        }
+    }
+}
+
+/**
+ * @brief  中断出口
+ */
+void Irq_Lat_Leave(void)
+{
+    if (!irq_on || irq_depth == 0)
+        return;
+
+    uint32_t now = DWT->CYCCNT;
+    uint8_t d = --irq_depth;
+    if (d >= IRQ_LAT_NEST_MAX)
+        return;
+
+    Irq_Lat_Frame_t *f = &irq_frame[d];
+    uint32_t wall = now - f->start;
+    uint32_t exec = wall - f->child;
+    if (d > 0 && d - 1 < IRQ_LAT_NEST_MAX)
+        irq_frame[d - 1].child += wall;
+
+    if (f->irq >= 0 && f->irq < IRQ_LAT_IRQ_NUM)
+    {
+        Irq_Lat_Rec_t *r = &irq_rec[f->irq];
+        r->count++;
+        r->exec_sum += exec;
+        if (exec > r->exec_max)
+            r->exec_max = exec;
+    }
+    irq_last_leave = now;
+    irq_last_irq = f->irq;
+}
+
+/**
+ * @brief  清零并开始记录
+ */
+void Irq_Lat_Start(void)
+{
+    BSP_DWT_Init();
+
+    rt_base_t level = rt_hw_interrupt_disable();
+    memset(irq_rec, 0, sizeof(irq_rec));
+    irq_depth = 0;
+    irq_last_leave = DWT->CYCCNT;
+    irq_last_irq = IRQ_LAT_BLOCK_NONE;
+    irq_on = 1;
+    rt_hw_interrupt_enable(level);
+}
+
+/**
+ * @brief  停止记录 (保留结果)
+ */
+void Irq_Lat_Stop(void)
+{
+    rt_base_t level = rt_hw_interrupt_disable();
+    irq_on = 0;
+    rt_hw_interrupt_enable(level);
+}
+
+/* 打印用名称 (stm32f4xx_it.c 里接入测量的中断) */
+static const struct
+{
+    IRQn_Type irq;
+    const char *name;
+} irq_names[] = {
+    {TIM1_CC_IRQn, "TIM1_CC"},         {TIM2_IRQn, "TIM2"},
+    {USART1_IRQn, "USART1"},           {USART3_IRQn, "USART3"},
+    {USART6_IRQn, "USART6"},           {DMA1_Stream1_IRQn, "DMA1_S1 u3rx"},
+    {DMA1_Stream3_IRQn, "DMA1_S3 u3tx"}, {DMA1_Stream5_IRQn, "DMA1_S5 u2rx"},
+    {DMA1_Stream6_IRQn, "DMA1_S6 u2tx"}, {DMA2_Stream1_IRQn, "DMA2_S1 u6rx"},
+    {DMA2_Stream2_IRQn, "DMA2_S2 u1rx"}, {DMA2_Stream6_IRQn, "DMA2_S6 u6tx"},
+    {DMA2_Stream7_IRQn, "DMA2_S7 u1tx"},
+};
+
+static const char *Irq_Lat_Name(int16_t irq)
+{
+    if (irq == IRQ_LAT_BLOCK_NONE)
+        return "none";
+    if (irq == IRQ_LAT_BLOCK_THREAD)
+        return "thread";
+    for (uint32_t i = 0; i < sizeof(irq_names) / sizeof(irq_names[0]); i++)
+    {
+        if (irq_names[i].irq == irq)
+            return irq_names[i].name;
+    }
+    return "?";
+}
+
+/**
+ * @brief  msh 命令：中断延迟与执行时间
+ * @usage  irqlat [start | stop | reset]
+ */
+static void irqlat(int argc, char **argv)
+{
+    static Irq_Lat_Rec_t snap[IRQ_LAT_IRQ_NUM];
+
+    if (argc > 1)
+    {
+        if (strcmp(argv[1], "start") == 0 || strcmp(argv[1], "reset") == 0)
+            Irq_Lat_Start();
+        else if (strcmp(argv[1], "stop") == 0)
+            Irq_Lat_Stop();
+        else
+            rt_kprintf("usage: irqlat [start | stop | reset]\n");
+        return;
+    }
+
+    rt_base_t level = rt_hw_interrupt_disable();
+    memcpy(snap, irq_rec, sizeof(snap));
+    rt_hw_interrupt_enable(level);
+
+    rt_kprintf("recording: %s (times in ns)\n", irq_on ? "on" : "off");
+    rt_kprintf("irq              prio      count exec avg exec max  lat avg  lat max  blocked by\n");
+    for (int16_t i = 0; i < IRQ_LAT_IRQ_NUM; i++)
+    {
+        const Irq_Lat_Rec_t *r = &snap[i];
+        if (r->count == 0 && r->lat_count == 0)
+            continue;
+
+        uint32_t exec_avg = r->count ? (uint32_t)(r->exec_sum / r->count) : 0;
+        rt_kprintf("%-3d %-12s %4u %10u %8u %8u", i, Irq_Lat_Name(i), (unsigned)NVIC_GetPriority((IRQn_Type)i),
+                   (unsigned)r->count, (unsigned)BSP_DWT_CyclesToNs(exec_avg),
+                   (unsigned)BSP_DWT_CyclesToNs(r->exec_max));
+        if (r->lat_count)
+        {
+            uint32_t lat_avg = (uint32_t)(r->lat_sum / r->lat_count);
+            rt_kprintf(" %8u %8u  %s\n", (unsigned)BSP_DWT_CyclesToNs(lat_avg),
+                       (unsigned)BSP_DWT_CyclesToNs(r->lat_max), Irq_Lat_Name(r->blocker));
+        }
+        else
+        {
+            rt_kprintf("        -        -\n");
+        }
+    }
+}
+MSH_CMD_EXPORT(irqlat, IRQ latency and execution time: irqlat [start | stop | reset]);
@@ -0,0 +1,75 @@
+/**
+ ******************************************************************************
+ * @file    irq_lat.h
+ * @author  lingxing
+ * @brief   外设中断延迟 / 执行时间测量 (按中断号统计最坏值)
+ ******************************************************************************
+ * @usage 使用说明:
+ * 1. 中断入口 (rt_interrupt_enter 之后) 与出口 (rt_interrupt_leave 之前) 各放一个宏：
+ *      IRQ_LAT_ENTER();                 普通中断：只记执行时间
+ *      IRQ_LAT_ENTER_TIM(TIM1, 1);      比较中断：另记 "比较匹配 -> 进入中断" 的延迟
+ *      IRQ_LAT_LEAVE();
+ *    第二个参数为内核时钟 / 定时器时钟 (TIM1 在 APB2 上为 1，TIM2 在 APB1 上为 2)。
+ * 2. msh: irqlat start | stop | reset   默认不记录，start 后才累计 (清零上次结果)
+ *         irqlat                         打印各中断的优先级、次数、执行时间与最坏延迟
+ *
+ * [口径]:
+ * - 延迟：进入中断时读 CNT，与触发的 CCR 相减 (多个通道同时挂起取最早的)，
+ *   分辨率为一个计数周期 (8MHz 档 125ns)；包含硬件压栈和 rt_interrupt_enter 的十几个周期。
+ * - 执行时间：出入口之间扣除被更高优先级中断抢占的部分 (独占时间)，
+ *   即它在同级 / 低级中断前面 "堵" 住的时间。
+ * - 最坏延迟同时记下 "堵塞者"：比较匹配之后、进入本中断之前最后退出的中断；
+ *   没有则为 thread (线程里关中断的临界区) 或 none (只有压栈开销)。
+ * - 串口 / DMA 事件没有硬件时间戳，只统计执行时间。
+ *
+ * [优先级规划] (暂定：按各中断的时间要求推出来的，还没有上车的 irqlat 实测数据；
+ *  以下分级与容忍度都待实测确认，数据出来前不要当作结论引用)
+ * (cubemx.ioc，NVIC_PRIORITYGROUP_4：4 位抢占优先级，无子优先级)
+ *   0  TIM1_CC          步进比较中断。输出翻转由硬件完成，中断只需在下一个比较点之前
+ *                       把 CCR 推过去；来晚了就错过比较点，要等 16 位计数回绕一整圈
+ *                       (8MHz 档 8.2ms) 才翻转，表现为丢步 / 顿挫。执行时间短，必须能
+ *                       抢占其余所有外设中断。
+ *   1  (预留)           TIM2 (motor_5) 比较中断。
+ *   2  USART1/2/6 空闲中断与各自的 DMA 接收流，以及 USART3 (只发不收)。字节由 DMA 搬运，
+ *                       空闲中断只处理帧边界：USARTx_IRQHandler 先调 BSP_UART_IdleCallback
+ *                       (清 IDLE、AbortReceive、Frame_Alloc 换块、rt_mq_send 投块指针、
+ *                       重启 DMA 接收)，再由 HAL_UART_IRQHandler 处理错误标志；
+ *                       预计容忍度是一帧的间隔 (ms 级)。同级是为了空闲中断与 DMA 半满 / 满
+ *                       中断不互相抢占，同一缓冲不会被两处交错处理。
+ *   3  DMA 发送流        只释放发送缓冲，最不紧急。
+ *   15 SysTick / PendSV 内核。
+ * 内核临界区用 PRIMASK 关全部中断，所以任何级别都能调用 IPC 接口；代价是线程临界区同样会
+ * 推迟步进中断，这部分在统计里记为 "thread"。
+ * 原先全部为 0 级，串口空闲中断 (上面那一整段：AbortReceive 要等 DMA 流停下，外加
+ * rt_mq_send) 会整段排在步进中断前面。待上车用 irqlat 验证：TIM1_CC 的堵塞者里不应再
+ * 出现串口 / DMA，且 USART 空闲中断的执行时间远小于一帧间隔；拿到数据后把数值补在这里。
+ ******************************************************************************
+ */
+
+#ifndef __IRQ_LAT_H
+#define __IRQ_LAT_H
+
+#include <rtthread.h>
+#include <stdint.h>
+#include "../../cubemx/Inc/main.h"
+
+#define IRQ_LAT_ENABLE 1   /* 0：宏为空，不占任何开销 */
+#define IRQ_LAT_IRQ_NUM 82 /* F407 外设中断个数 */
+#define IRQ_LAT_NEST_MAX 8 /* 记录的最大嵌套深度 */
+
+#if IRQ_LAT_ENABLE
+#define IRQ_LAT_ENTER() Irq_Lat_Enter(RT_NULL, 0)
+#define IRQ_LAT_ENTER_TIM(tim, clk_div) Irq_Lat_Enter((tim), (clk_div))
+#define IRQ_LAT_LEAVE() Irq_Lat_Leave()
+#else
+#define IRQ_LAT_ENTER()
+#define IRQ_LAT_ENTER_TIM(tim, clk_div)
+#define IRQ_LAT_LEAVE()
+#endif
+
+void Irq_Lat_Enter(TIM_TypeDef *tim, uint8_t clk_div);
+void Irq_Lat_Leave(void);
+void Irq_Lat_Start(void);
+void Irq_Lat_Stop(void);
+
+#endif /* __IRQ_LAT_H */
@@ -0,0 +1,230 @@
+/**
+ ******************************************************************************
+ * @file    log_async.c
+ * @author  lingxing
+ * @brief   异步延迟格式化日志 (替换 rtdbg 的 LOG_D / LOG_I / LOG_W)
+ ******************************************************************************
+ * [实现]:
+ * 多生产者 / 单消费者环形缓冲，无锁：
+ * - 生产者用原子加法 (LDREX/STREX) 领取全局序号 idx，再用 CAS 把槽位 idx % N 的 seq
+ *   从 "已提交的旧记录" 改成 "idx 写入中" 才开始写，写完把 seq 置为 "idx 已提交"。
+ *   槽位正被别的生产者写 (它被本调用抢占了)，或已被更新的序号领走时，本条直接放弃：
+ *   写入期间槽位只属于一个生产者，不会出现两次调用的字段混在一条记录里。
+ * - 消费者按序号顺序取：seq 为期望序号的已提交状态才拷贝，拷贝后再核对一次 seq，
+ *   拷贝期间被新记录领走则计入丢失；已被更新的序号占用说明本条被覆盖，直接跳过；
+ *   尚未提交则等下一轮，连续 LOG_ASYNC_STALL_ROUNDS 轮仍未提交 (生产者放弃了本条) 也跳过。
+ * - 生产者不唤醒任何线程 (rt_event_send 会关中断并触发调度，开销远超记录本身)，
+ *   输出线程按 LOG_ASYNC_PERIOD_MS 周期轮询。
+ ******************************************************************************
+ */
+
+#include "log_async.h"
+#include "../My_Driver/bsp_dwt.h"
+#include "../My_App/app_static.h"
+#include <rtthread.h>
+#include <stdarg.h>
+#include <stdlib.h>
+
+#define LOG_ASYNC_STACK_SIZE 1024
+#define LOG_ASYNC_PRIORITY (RT_THREAD_PRIORITY_MAX - 4) /* 低于所有业务与 shell 线程，高于 idle */
+#define LOG_ASYNC_TICK 5
+#define LOG_ASYNC_PERIOD_MS 20 /* 输出线程轮询周期 */
+#define LOG_ASYNC_STALL_ROUNDS 3 /* 同一条记录最多等几轮 */
+
+#define LOG_ASYNC_MASK (LOG_ASYNC_RING_SIZE - 1)
+
+/* 槽位 seq 编码：(序号 + 1) << 1，最低位置 1 表示该序号正在写入；初值 0 即 "序号 -1 已提交" (空槽) */
+#define LOG_SEQ(idx) (((idx) + 1u) << 1)
+#define LOG_SEQ_BUSY 1u
+
+typedef struct
+{
+    volatile uint32_t seq; /* 槽位归属，见 LOG_SEQ */
+    uint32_t tick;         /* 记录时刻 (系统节拍) */
+    const char *tag;
+    const char *fmt;
+    char level;
+    uint8_t argc;
+    uintptr_t argv[LOG_ASYNC_ARGS_MAX]; /* 原始参数，每个一个机器字 */
+} Log_Entry_t;
+
+static Log_Entry_t log_ring[LOG_ASYNC_RING_SIZE];
+static volatile uint32_t log_head = 0; /* 下一个待领取的序号 (生产者) */
+static uint32_t log_tail = 0;          /* 下一个待输出的序号 (消费者) */
+static uint32_t log_lost = 0;          /* 被覆盖或放弃而未输出的记录数 */
+static uint32_t log_stall = 0;         /* 当前记录已等待的轮数 */
+
+APP_THREAD_DEFINE(log_thread, LOG_ASYNC_STACK_SIZE);
+
+/**
+ * @brief  记录一条日志 (由 LOG_D / LOG_I / LOG_W 宏调用)
+ * @param  argc: 参数个数，由宏在编译期算出
+ * @note   可在任意线程与中断中调用；不格式化、不加锁、不唤醒线程。
+ *         领不到槽位时丢弃本条，由输出线程计入丢失
+ */
+void Log_Async_Push(char level, const char *tag, uint32_t argc, const char *fmt, ...)
+{
+    uint32_t idx = __atomic_fetch_add(&log_head, 1, __ATOMIC_RELAXED);
+    Log_Entry_t *e = &log_ring[idx & LOG_ASYNC_MASK];
+    uint32_t seq = LOG_SEQ(idx);
+    uint32_t old = __atomic_load_n(&e->seq, __ATOMIC_RELAXED);
+    va_list args;
+
+    /* 只从已提交的旧记录手里接过槽位；CAS 失败说明期间被别人领走，重新判断 */
+    do
+    {
+        if ((old & LOG_SEQ_BUSY) || (int32_t)(old - seq) >= 0)
+            return;
+    } while (!__atomic_compare_exchange_n(&e->seq, &old, seq | LOG_SEQ_BUSY, 1, __ATOMIC_ACQUIRE,
+                                          __ATOMIC_RELAXED));
+
+    e->tick = rt_tick_get();
+    e->tag = tag;
+    e->fmt = fmt;
+    e->level = level;
+    e->argc = (uint8_t)argc;
+
+    /* 整数、字符、指针在 AAPCS 下都按一个 32 位字传递，原样搬运即可 */
+    va_start(args, fmt);
+    for (uint32_t i = 0; i < argc; i++)
+        e->argv[i] = va_arg(args, uintptr_t);
+    va_end(args);
+
+    /* 写入中的槽位别人领不走，直接提交 */
+    __atomic_store_n(&e->seq, seq, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief  [内部函数] 格式化输出一条记录
+ */
+static void Log_Async_Print(const Log_Entry_t *e)
+{
+    uint32_t ms = (uint32_t)((uint64_t)e->tick * 1000 / RT_TICK_PER_SECOND);
+    const uintptr_t *a = e->argv;
+
+    rt_kprintf("[%u.%03u %c/%s] ", (unsigned)(ms / 1000), (unsigned)(ms % 1000), e->level, e->tag);
+    /* 多传的参数会被忽略，未用到的槽位内容无关紧要 */
+    rt_kprintf(e->fmt, a[0], a[1], a[2], a[3], a[4], a[5]);
+    rt_kprintf("\n");
+}
+
+/**
+ * @brief  [内部函数] 输出缓冲区中所有已提交的记录
+ * @return 本次输出的条数
+ * @note   单消费者：只允许输出线程调用
+ */
+static uint32_t Log_Async_Flush(void)
+{
+    uint32_t printed = 0;
+
+    while (log_tail != __atomic_load_n(&log_head, __ATOMIC_ACQUIRE))
+    {
+        uint32_t head = __atomic_load_n(&log_head, __ATOMIC_ACQUIRE);
+        if (head - log_tail > LOG_ASYNC_RING_SIZE)
+        {
+            /* 输出跟不上，最旧的记录已被覆盖 */
+            log_lost += head - log_tail - LOG_ASYNC_RING_SIZE;
+            log_tail = head - LOG_ASYNC_RING_SIZE;
+            log_stall = 0;
+        }
+
+        Log_Entry_t *slot = &log_ring[log_tail & LOG_ASYNC_MASK];
+        uint32_t seq = LOG_SEQ(log_tail);
+        uint32_t cur = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+        if (cur != seq)
+        {
+            /* 本条还在写或还没领到槽位 (生产者被抢占)，等下一轮；
+               已被更新的序号占用，或等了几轮仍未提交 (生产者放弃)，跳过 */
+            if ((int32_t)((cur & ~LOG_SEQ_BUSY) - seq) <= 0 && ++log_stall < LOG_ASYNC_STALL_ROUNDS)
+                break;
+            log_lost++;
+            log_tail++;
+            log_stall = 0;
+            continue;
+        }
+
+        Log_Entry_t copy = *slot;
+        log_tail++;
+        log_stall = 0;
+        if (__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != seq)
+        {
+            log_lost++; /* 拷贝途中被新记录领走 */
+            continue;
+        }
+
+        if (log_lost)
+        {
+            rt_kprintf("[log] %u messages lost\n", (unsigned)log_lost);
+            log_lost = 0;
+        }
+        Log_Async_Print(&copy);
+        printed++;
+    }
+
+    return printed;
+}
+
+/**
+ * @brief 日志输出线程入口
+ */
+static void log_async_proc(void *parameter)
+{
+    while (1)
+    {
+        Log_Async_Flush();
+        rt_thread_mdelay(LOG_ASYNC_PERIOD_MS);
+    }
+}
+
+/**
+ * @brief 初始化日志输出线程 (组件级，先于各 App 线程启动)
+ */
+int Log_Async_Init(void)
+{
+    rt_thread_t tid = APP_THREAD_CREATE(log_thread, "log", log_async_proc, RT_NULL, LOG_ASYNC_PRIORITY,
+                                        LOG_ASYNC_TICK);
+    if (tid == RT_NULL)
+        return -RT_ERROR;
+
+    rt_thread_startup(tid);
+    return RT_EOK;
+}
+INIT_COMPONENT_EXPORT(Log_Async_Init);
+
+/**
+ * @brief  msh 命令：用 DWT 对比同步 / 异步日志的单次调用开销
+ * @usage  log_bench [n]   各记录 n 条 (默认 16，不超过缓冲区容量)
+ * @note   同步一侧按 rtdbg 的 dbg_log_line 展开 (行头 + 正文 + 换行三次 rt_kprintf)，
+ *         会真实输出到控制台
+ */
+static void log_bench(int argc, char **argv)
+{
+    uint32_t n = (argc >= 2) ? (uint32_t)atoi(argv[1]) : 16;
+    uint32_t t0, sync_cyc, async_cyc;
+
+    if (n == 0 || n > LOG_ASYNC_RING_SIZE / 2)
+        n = 16;
+
+    BSP_DWT_Init();
+    rt_thread_mdelay(2 * LOG_ASYNC_PERIOD_MS); /* 等输出线程清空缓冲区，避免覆盖别人的记录 */
+
+    t0 = BSP_DWT_GetCycles();
+    for (uint32_t i = 0; i < n; i++)
+    {
+        rt_kprintf("[D/bench] ");
+        rt_kprintf("sync  #%d x=%d y=%d", (int)i, (int)(i * 3), -(int)i);
+        rt_kprintf("\n");
+    }
+    sync_cyc = (BSP_DWT_GetCycles() - t0) / n;
+
+    t0 = BSP_DWT_GetCycles();
+    for (uint32_t i = 0; i < n; i++)
+        Log_Async_Push('D', "bench", 3, "async #%d x=%d y=%d", (int)i, (int)(i * 3), -(int)i);
+    async_cyc = (BSP_DWT_GetCycles() - t0) / n;
+
+    rt_thread_mdelay(2 * LOG_ASYNC_PERIOD_MS); /* 让测试记录先输出完 */
+    rt_kprintf("log_bench x%u: sync %u cycles (%u ns), async %u cycles (%u ns) per call\n",
+               (unsigned)n, (unsigned)sync_cyc, (unsigned)BSP_DWT_CyclesToNs(sync_cyc),
+               (unsigned)async_cyc, (unsigned)BSP_DWT_CyclesToNs(async_cyc));
+}
+MSH_CMD_EXPORT(log_bench, compare sync and async log cost in DWT cycles: log_bench [n]);
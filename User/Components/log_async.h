@@ -0,0 +1,67 @@
+/**
+ ******************************************************************************
+ * @file    log_async.h
+ * @author  lingxing
+ * @brief   异步延迟格式化日志 (替换 rtdbg 的 LOG_D / LOG_I / LOG_W)
+ ******************************************************************************
+ * @usage 使用说明:
+ * 1. 在模块里 #include <rtdbg.h> 之后再 #include "../Components/log_async.h"，
+ *    原有 LOG_D / LOG_I / LOG_W 调用不用改，自动改走异步通道；LOG_E 仍同步输出
+ *    (出错时往往紧接着复位或卡死，必须立即落到串口上)。
+ * 2. 调用方只记录 格式串指针 + 原始参数 (每个参数一个 32 位字) + 时间戳，
+ *    由最低优先级的 "log" 线程稍后统一格式化输出，输出行首带记录时刻：
+ *    [12.345 I/app.move] ...
+ *
+ * [限制]:
+ * - 最多 LOG_ASYNC_ARGS_MAX 个参数，每个参数按 32 位字保存：整数、字符、指针都可以，
+ *   不支持 double (rt_kprintf 本来也不支持 %f，请按项目惯例打印定点整数)；
+ * - %s 参数只保存指针，必须是字符串常量或生命周期足够长的缓冲区；
+ * - 缓冲区满时覆盖最旧的记录，输出线程会打印丢失条数。
+ ******************************************************************************
+ */
+
+#ifndef __LOG_ASYNC_H
+#define __LOG_ASYNC_H
+
+#include <stdint.h>
+
+#define LOG_ASYNC_ARGS_MAX 6   /* 单条日志参数个数上限 */
+#define LOG_ASYNC_RING_SIZE 64 /* 缓冲区条数，必须为 2 的幂 */
+
+int Log_Async_Init(void);
+void Log_Async_Push(char level, const char *tag, uint32_t argc, const char *fmt, ...)
+    __attribute__((format(printf, 4, 5)));
+
+/* 参数个数 (不含格式串)，超过 LOG_ASYNC_ARGS_MAX 在编译期报错 */
+#define LOG_ASYNC_NARG(...) LOG_ASYNC_NARG_(__VA_ARGS__, LOG_ASYNC_TOO_MANY_ARGS, 6, 5, 4, 3, 2, 1, 0)
+#define LOG_ASYNC_NARG_(_fmt, _1, _2, _3, _4, _5, _6, _7, N, ...) N
+
+#define LOG_ASYNC(level, ...) Log_Async_Push(level, DBG_TAG, LOG_ASYNC_NARG(__VA_ARGS__), __VA_ARGS__)
+
+/* 按模块 DBG_LVL 重新定义 rtdbg 的日志宏 (LOG_E / LOG_RAW 保持原样)；
+ * 关闭 RT_DEBUG 时 rtdbg 已把它们定义为空，这里不再打开 */
+#if defined(DBG_LVL) && (defined(DBG_ENABLE) || defined(RT_SIMULATOR))
+#undef LOG_D
+#undef LOG_I
+#undef LOG_W
+
+#if (DBG_LVL >= DBG_LOG)
+#define LOG_D(...) LOG_ASYNC('D', __VA_ARGS__)
+#else
+#define LOG_D(...)
+#endif
+
+#if (DBG_LVL >= DBG_INFO)
+#define LOG_I(...) LOG_ASYNC('I', __VA_ARGS__)
+#else
+#define LOG_I(...)
+#endif
+
+#if (DBG_LVL >= DBG_WARNING)
+#define LOG_W(...) LOG_ASYNC('W', __VA_ARGS__)
+#else
+#define LOG_W(...)
+#endif
+#endif /* DBG_LVL && DBG_ENABLE */
+
+#endif /* __LOG_ASYNC_H */
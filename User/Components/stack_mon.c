@@ -0,0 +1,198 @@
+/**
+ ******************************************************************************
+ * @file    stack_mon.c
+ * @author  lingxing
+ * @brief   线程栈水位监视 (空闲钩子周期扫描 '#' 填充，记录峰值并给出建议栈大小)
+ ******************************************************************************
+ * [实现]:
+ * 内核创建线程时把整个栈填成 '#'，栈向下生长，从栈底 (stack_addr) 往上数
+ * 仍为 '#' 的字节就是从未用到的部分。扫描放在空闲钩子里并按周期限速，
+ * 只占空闲时间，不影响任何业务线程；空闲线程栈很小，临时数组都放静态区。
+ ******************************************************************************
+ */
+
+#include "stack_mon.h"
+#include <string.h>
+
+#define DBG_TAG "stack"
+#define DBG_LVL DBG_INFO
+#include <rtdbg.h>
+#include "log_async.h"
+
+#define STACK_MON_FILL 0x23232323u /* 四个 '#' */
+
+typedef struct
+{
+    rt_thread_t thread;
+    char name[RT_NAME_MAX + 1]; /* 带结束符 */
+    uint32_t size;
+    uint32_t peak;
+    uint8_t warned;
+} Stack_Slot_t;
+
+static Stack_Slot_t stack_slot[STACK_MON_THREADS_MAX];
+static uint16_t stack_slot_num = 0;
+static rt_object_t stack_live[STACK_MON_THREADS_MAX];
+static rt_tick_t stack_last_scan = 0;
+
+/* 告警用的线程名副本：异步日志只存 %s 的指针，而槽位表每次扫描都会压缩挪动，
+ * 所以告警时把名字拷到这里再交给日志。每个槽位最多告警一次，环形复用前日志早已输出 */
+static char stack_warn_name[STACK_MON_THREADS_MAX][RT_NAME_MAX + 1];
+static uint16_t stack_warn_next = 0;
+
+/**
+ * @brief  [内部函数] 计算栈从未使用过的字节数 (从栈底往上数填充字)
+ */
+static uint32_t Stack_Mon_Free(const rt_thread_t thread)
+{
+    const uint32_t *p = (const uint32_t *)thread->stack_addr;
+    const uint32_t *end = (const uint32_t *)((uint8_t *)thread->stack_addr + thread->stack_size);
+
+    while (p < end && *p == STACK_MON_FILL)
+        p++;
+    return (uint32_t)((const uint8_t *)p - (const uint8_t *)thread->stack_addr);
+}
+
+/**
+ * @brief  [内部函数] 按峰值计算需要的栈大小 (未取整)
+ */
+static uint32_t Stack_Mon_Need(uint32_t peak)
+{
+    uint32_t margin = peak * STACK_MON_MARGIN_PCT / 100;
+    if (margin < STACK_MON_MARGIN_MIN)
+        margin = STACK_MON_MARGIN_MIN;
+    return peak + margin;
+}
+
+/**
+ * @brief  [内部函数] 查找 / 分配线程槽位 (表满返回 RT_NULL)
+ */
+static Stack_Slot_t *Stack_Mon_Slot(rt_thread_t thread)
+{
+    for (uint16_t i = 0; i < stack_slot_num; i++)
+    {
+        if (stack_slot[i].thread == thread)
+            return &stack_slot[i];
+    }
+    if (stack_slot_num >= STACK_MON_THREADS_MAX)
+        return RT_NULL;
+
+    Stack_Slot_t *s = &stack_slot[stack_slot_num++];
+    memset(s, 0, sizeof(*s));
+    s->thread = thread;
+    rt_strncpy(s->name, thread->name, RT_NAME_MAX);
+    s->size = thread->stack_size;
+    return s;
+}
+
+/**
+ * @brief  [内部函数] 扫描一遍所有线程，更新峰值；已删除线程的槽位被回收
+ * @note   只在空闲钩子里调用 (槽位表唯一的修改者)；增删槽位在调度锁内完成，
+ *         读者 (Stack_Mon_Get) 同样加调度锁即可看到完整的表，逐个扫栈则不加锁
+ */
+static void Stack_Mon_Scan(void)
+{
+    int n = rt_object_get_pointers(RT_Object_Class_Thread, stack_live, STACK_MON_THREADS_MAX);
+
+    rt_enter_critical();
+    uint16_t keep = 0;
+    for (uint16_t i = 0; i < stack_slot_num; i++)
+    {
+        for (int k = 0; k < n; k++)
+        {
+            if ((rt_thread_t)stack_live[k] == stack_slot[i].thread)
+            {
+                stack_slot[keep++] = stack_slot[i];
+                break;
+            }
+        }
+    }
+    stack_slot_num = keep;
+    for (int k = 0; k < n; k++)
+        Stack_Mon_Slot((rt_thread_t)stack_live[k]);
+    rt_exit_critical();
+
+    for (uint16_t i = 0; i < stack_slot_num; i++)
+    {
+        Stack_Slot_t *s = &stack_slot[i];
+        uint32_t used = s->size - Stack_Mon_Free(s->thread);
+        if (used > s->peak)
+            s->peak = used;
+
+        if (!s->warned && Stack_Mon_Need(s->peak) > s->size)
+        {
+            s->warned = 1;
+            char *name = stack_warn_name[stack_warn_next];
+            stack_warn_next = (stack_warn_next + 1) % STACK_MON_THREADS_MAX;
+            memcpy(name, s->name, sizeof(s->name));
+            LOG_W("%s stack peak %u / %u bytes, below safety margin", name, (unsigned)s->peak,
+                  (unsigned)s->size);
+        }
+    }
+}
+
+/**
+ * @brief  [内部函数] 空闲钩子：按周期限速扫描
+ */
+static void Stack_Mon_Idle_Hook(void)
+{
+    rt_tick_t now = rt_tick_get();
+    if (now - stack_last_scan < rt_tick_from_millisecond(STACK_MON_PERIOD_MS))
+        return;
+    stack_last_scan = now;
+
+    Stack_Mon_Scan();
+}
+
+/**
+ * @brief  读取各线程栈水位
+ * @return 写入 info 的条数
+ */
+int Stack_Mon_Get(Stack_Mon_Info_t *info, int max)
+{
+    int n = 0;
+    rt_enter_critical();
+    for (uint16_t i = 0; i < stack_slot_num && n < max; i++, n++)
+    {
+        const Stack_Slot_t *s = &stack_slot[i];
+        memcpy(info[n].name, s->name, RT_NAME_MAX);
+        info[n].size = s->size;
+        info[n].peak = s->peak;
+        info[n].recommend = RT_ALIGN(Stack_Mon_Need(s->peak), 64);
+    }
+    rt_exit_critical();
+    return n;
+}
+
+/**
+ * @brief 注册空闲钩子，上电即开始监视
+ */
+int Stack_Mon_Init(void)
+{
+    return rt_thread_idle_sethook(Stack_Mon_Idle_Hook);
+}
+INIT_COMPONENT_EXPORT(Stack_Mon_Init);
+
+/**
+ * @brief  msh 命令：栈水位与建议大小 (峰值最多滞后一个扫描周期)
+ */
+static void stack(int argc, char **argv)
+{
+    static Stack_Mon_Info_t info[STACK_MON_THREADS_MAX];
+    int32_t spare = 0;
+    int n = Stack_Mon_Get(info, STACK_MON_THREADS_MAX);
+
+    rt_kprintf("%-*.*s  size  peak  used  recommend\n", RT_NAME_MAX, RT_NAME_MAX, "thread");
+    rt_kprintf("-------- ----- ----- ----  ---------\n");
+    for (int i = 0; i < n; i++)
+    {
+        uint32_t pct = info[i].peak * 100 / info[i].size;
+        rt_kprintf("%-*.*s %5u %5u %3u%%  %9u%s\n", RT_NAME_MAX, RT_NAME_MAX, info[i].name,
+                   (unsigned)info[i].size, (unsigned)info[i].peak, (unsigned)pct, (unsigned)info[i].recommend,
+                   (Stack_Mon_Need(info[i].peak) > info[i].size) ? "  LOW" : "");
+        spare += (int32_t)info[i].size - (int32_t)info[i].recommend;
+    }
+    rt_kprintf("total size - recommend: %d bytes (margin %d%%, min %d bytes)\n", (int)spare,
+               STACK_MON_MARGIN_PCT, STACK_MON_MARGIN_MIN);
+}
+MSH_CMD_EXPORT(stack, thread stack high-water marks and recommended sizes);
@@ -0,0 +1,37 @@
+/**
+ ******************************************************************************
+ * @file    stack_mon.h
+ * @author  lingxing
+ * @brief   线程栈水位监视 (空闲钩子周期扫描 '#' 填充，记录峰值并给出建议栈大小)
+ ******************************************************************************
+ * @usage 使用说明:
+ * 1. 上电自动运行，无需调用；某线程余量低于安全裕量时打一条 LOG_W (每线程一次)。
+ * 2. msh: stack   打印各线程 栈大小 / 峰值 / 占用率 / 建议大小 与可回收的总字节数。
+ *    建议值 = 峰值 + max(峰值 x STACK_MON_MARGIN_PCT%, STACK_MON_MARGIN_MIN)，按 64 字节取整。
+ *    峰值只代表运行至今出现过的最深调用，缩减前请先跑完整场任务 (含出错重试路径)。
+ ******************************************************************************
+ */
+
+#ifndef __STACK_MON_H
+#define __STACK_MON_H
+
+#include <rtthread.h>
+#include <stdint.h>
+
+#define STACK_MON_THREADS_MAX 20 /* 监视线程数上限 */
+#define STACK_MON_PERIOD_MS 500  /* 扫描周期 */
+#define STACK_MON_MARGIN_PCT 25  /* 安全裕量：峰值的百分比 */
+#define STACK_MON_MARGIN_MIN 128 /* 安全裕量下限 (字节)，覆盖中断压栈与浮点上下文 */
+
+typedef struct
+{
+    char name[RT_NAME_MAX];
+    uint32_t size;      /* 栈大小 */
+    uint32_t peak;      /* 峰值使用量 */
+    uint32_t recommend; /* 建议栈大小 */
+} Stack_Mon_Info_t;
+
+int Stack_Mon_Init(void);
+int Stack_Mon_Get(Stack_Mon_Info_t *info, int max);
+
+#endif /* __STACK_MON_H */
@@ -0,0 +1,311 @@
+/**
+ ******************************************************************************
+ * @file    trace_rec.c
+ * @author  lingxing
+ * @brief   内核事件追踪记录器 (调度/中断/IPC 钩子 + 用户标记，DWT 时间戳)
+ ******************************************************************************
+ * [实现]:
+ * - 钩子只在 trace start 期间挂上，停止后摘除，平时零开销；
+ * - 事件写入与 log_async 相同：原子加法领取序号，写满后覆盖最旧事件 (飞行记录仪)；
+ * - 导出前先停止记录，缓冲区冻结后再拼名称表，不与钩子竞争。
+ ******************************************************************************
+ */
+
+#include "trace_rec.h"
+#include "cpu_load.h"
+#include "../../cubemx/Inc/main.h"
+#include "../My_Driver/bsp_dwt.h"
+#include "../My_Driver/bsp_uart.h"
+#include "../My_App/app_telem_proc.h"
+#include <rtthread.h>
+#include <string.h>
+
+#define TRACE_MASK (TRACE_BUF_EVENTS - 1)
+#define TRACE_NAMES_MAX 64   /* 名称表上限 (线程 + IPC 对象 + 标记) */
+#define TRACE_OBJ_SCAN_MAX 24 /* 每类内核对象最多扫描个数 */
+#define TRACE_UART_CHUNK 1024 /* 经 USART3 导出时单次阻塞发送的字节数 */
+
+static Trace_Ev_t trace_buf[TRACE_BUF_EVENTS];
+static volatile uint32_t trace_head = 0; /* 累计事件数 (下一个待领取序号) */
+static volatile uint8_t trace_on = 0;
+static uint8_t trace_irq = 1; /* 记录中断进出 */
+static uint8_t trace_ipc = 1; /* 记录 IPC 操作 */
+
+static Trace_Name_t trace_names[TRACE_NAMES_MAX];
+static uint16_t trace_name_num = 0;
+
+/**
+ * @brief  [内部函数] 写入一条事件 (线程与中断上下文均可)
+ */
+static void Trace_Put(uint8_t type, const void *obj)
+{
+    uint32_t idx = __atomic_fetch_add(&trace_head, 1, __ATOMIC_RELAXED);
+    Trace_Ev_t *e = &trace_buf[idx & TRACE_MASK];
+
+    e->cyc = DWT->CYCCNT;
+    e->type = type;
+    e->irq = (uint8_t)__get_IPSR(); /* 0 表示线程上下文 */
+    e->reserved = 0;
+    e->obj = (uint32_t)obj;
+}
+
+/* --- 内核钩子 --- */
+static void Trace_Hook_Switch(struct rt_thread *from, struct rt_thread *to)
+{
+    Trace_Put(TRACE_EV_SWITCH, to);
+}
+
+static void Trace_Hook_IsrEnter(void)
+{
+    Trace_Put(TRACE_EV_ISR_ENTER, RT_NULL);
+}
+
+static void Trace_Hook_IsrExit(void)
+{
+    Trace_Put(TRACE_EV_ISR_EXIT, RT_NULL);
+}
+
+static void Trace_Hook_Try(struct rt_object *object)
+{
+    Trace_Put(TRACE_EV_IPC_TRY, object);
+}
+
+static void Trace_Hook_Take(struct rt_object *object)
+{
+    Trace_Put(TRACE_EV_IPC_TAKE, object);
+}
+
+static void Trace_Hook_Put(struct rt_object *object)
+{
+    Trace_Put(TRACE_EV_IPC_PUT, object);
+}
+
+/**
+ * @brief  [内部函数] 挂上 / 摘除钩子
+ */
+static void Trace_Set_Hooks(uint8_t on)
+{
+    /* 调度与中断钩子槽位由 cpu_load 常驻占用，挂在它后面 */
+    Cpu_Load_Chain(on ? Trace_Hook_Switch : RT_NULL,
+                   (on && trace_irq) ? Trace_Hook_IsrEnter : RT_NULL,
+                   (on && trace_irq) ? Trace_Hook_IsrExit : RT_NULL);
+    rt_object_trytake_sethook((on && trace_ipc) ? Trace_Hook_Try : RT_NULL);
+    rt_object_take_sethook((on && trace_ipc) ? Trace_Hook_Take : RT_NULL);
+    rt_object_put_sethook((on && trace_ipc) ? Trace_Hook_Put : RT_NULL);
+}
+
+/**
+ * @brief  开始记录 (清空缓冲区)
+ * @param  irq: 1 记录中断进出 (步进中断密集时会很快写满缓冲区)
+ * @param  ipc: 1 记录 IPC 操作
+ */
+void Trace_Start(uint8_t irq, uint8_t ipc)
+{
+    Trace_Stop();
+    BSP_DWT_Init();
+
+    trace_irq = irq;
+    trace_ipc = ipc;
+    trace_head = 0;
+
+    /* 首个事件记下当前线程，上位机据此知道时间线起点谁在运行 */
+    Trace_Put(TRACE_EV_SWITCH, rt_thread_self());
+    trace_on = 1;
+    Trace_Set_Hooks(1);
+}
+
+/**
+ * @brief  停止记录 (冻结缓冲区)
+ */
+void Trace_Stop(void)
+{
+    Trace_Set_Hooks(0);
+    trace_on = 0;
+}
+
+/**
+ * @brief  记录用户事件 (TRACE_BEGIN / TRACE_END / TRACE_MARK 宏)
+ * @param  obj: 名称字符串常量
+ */
+void Trace_Event(uint8_t type, const void *obj)
+{
+    if (trace_on)
+        Trace_Put(type, obj);
+}
+
+/* ========================================================================== */
+/*                          导出 (Dump)                                        */
+/* ========================================================================== */
+
+/**
+ * @brief  [内部函数] 追加一条名称 (按地址去重)
+ */
+static void Trace_Name_Add(uint32_t obj, uint8_t kind, const char *name)
+{
+    for (uint16_t i = 0; i < trace_name_num; i++)
+    {
+        if (trace_names[i].obj == obj)
+            return;
+    }
+    if (trace_name_num >= TRACE_NAMES_MAX)
+        return;
+
+    Trace_Name_t *n = &trace_names[trace_name_num++];
+    n->obj = obj;
+    n->kind = kind;
+    strncpy(n->name, name, TRACE_NAME_LEN);
+}
+
+/**
+ * @brief  [内部函数] 收集名称表：存活的线程与 IPC 对象 + 缓冲区里出现过的标记
+ */
+static void Trace_Collect_Names(uint32_t first, uint32_t count)
+{
+    static const uint8_t ipc_class[] = {RT_Object_Class_Semaphore, RT_Object_Class_Mutex, RT_Object_Class_Event,
+                                        RT_Object_Class_MailBox, RT_Object_Class_MessageQueue};
+    rt_object_t objs[TRACE_OBJ_SCAN_MAX];
+
+    trace_name_num = 0;
+
+    int n = rt_object_get_pointers(RT_Object_Class_Thread, objs, TRACE_OBJ_SCAN_MAX);
+    for (int i = 0; i < n; i++)
+        Trace_Name_Add((uint32_t)objs[i], TRACE_NAME_THREAD, objs[i]->name);
+
+    for (uint32_t c = 0; c < sizeof(ipc_class); c++)
+    {
+        n = rt_object_get_pointers((enum rt_object_class_type)ipc_class[c], objs, TRACE_OBJ_SCAN_MAX);
+        for (int i = 0; i < n; i++)
+            Trace_Name_Add((uint32_t)objs[i], TRACE_NAME_IPC, objs[i]->name);
+    }
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const Trace_Ev_t *e = &trace_buf[(first + i) & TRACE_MASK];
+        if (e->type == TRACE_EV_BEGIN || e->type == TRACE_EV_END || e->type == TRACE_EV_MARK)
+            Trace_Name_Add(e->obj, TRACE_NAME_MARK, (const char *)e->obj);
+    }
+}
+
+typedef void (*Trace_Write_t)(const uint8_t *data, uint32_t len);
+
+/* 十六进制输出的行内计数 */
+static uint32_t trace_hex_col = 0;
+
+/**
+ * @brief  [内部函数] 十六进制写到控制台 (每行 32 字节)
+ */
+static void Trace_Write_Hex(const uint8_t *data, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; i++)
+    {
+        rt_kprintf("%02x", data[i]);
+        if (++trace_hex_col == 32)
+        {
+            rt_kprintf("\n");
+            trace_hex_col = 0;
+        }
+    }
+}
+
+/**
+ * @brief  [内部函数] 二进制写到 USART3 (阻塞，分块发送)
+ */
+static void Trace_Write_Uart(const uint8_t *data, uint32_t len)
+{
+    while (len > 0)
+    {
+        uint16_t n = (len > TRACE_UART_CHUNK) ? TRACE_UART_CHUNK : (uint16_t)len;
+        BSP_UART_Send(&uart3_telem, (uint8_t *)data, n);
+        data += n;
+        len -= n;
+    }
+}
+
+/**
+ * @brief  [内部函数] 按导出格式写出 头 + 名称表 + 事件 (从最旧到最新)
+ */
+static void Trace_Dump(Trace_Write_t write)
+{
+    uint32_t total = trace_head;
+    uint32_t count = (total > TRACE_BUF_EVENTS) ? TRACE_BUF_EVENTS : total;
+    uint32_t first = total - count;
+    Trace_Hdr_t hdr;
+
+    Trace_Collect_Names(first, count);
+
+    memcpy(hdr.magic, "RTTR", 4);
+    hdr.version = 1;
+    hdr.ev_size = sizeof(Trace_Ev_t);
+    hdr.core_hz = SystemCoreClock;
+    hdr.count = count;
+    hdr.lost = first;
+    hdr.name_count = trace_name_num;
+    hdr.name_size = sizeof(Trace_Name_t);
+
+    write((const uint8_t *)&hdr, sizeof(hdr));
+    write((const uint8_t *)trace_names, trace_name_num * sizeof(Trace_Name_t));
+
+    /* 环形缓冲可能回绕，分两段写 */
+    uint32_t start = first & TRACE_MASK;
+    uint32_t part = (start + count > TRACE_BUF_EVENTS) ? (TRACE_BUF_EVENTS - start) : count;
+    write((const uint8_t *)&trace_buf[start], part * sizeof(Trace_Ev_t));
+    write((const uint8_t *)&trace_buf[0], (count - part) * sizeof(Trace_Ev_t));
+}
+
+/**
+ * @brief  msh 命令：内核追踪
+ * @usage  trace start [noirq] [noipc] | stop | dump [uart3]
+ */
+static void trace(int argc, char **argv)
+{
+    if (argc >= 2 && strcmp(argv[1], "start") == 0)
+    {
+        uint8_t irq = 1, ipc = 1;
+        for (int i = 2; i < argc; i++)
+        {
+            if (strcmp(argv[i], "noirq") == 0)
+                irq = 0;
+            else if (strcmp(argv[i], "noipc") == 0)
+                ipc = 0;
+        }
+        Trace_Start(irq, ipc);
+        rt_kprintf("trace started (irq %s, ipc %s)\n", irq ? "on" : "off", ipc ? "on" : "off");
+    }
+    else if (argc >= 2 && strcmp(argv[1], "stop") == 0)
+    {
+        Trace_Stop();
+        rt_kprintf("trace stopped: %u events\n", (unsigned)trace_head);
+    }
+    else if (argc >= 2 && strcmp(argv[1], "dump") == 0)
+    {
+        Trace_Stop();
+        if (argc >= 3 && strcmp(argv[2], "uart3") == 0)
+        {
+            /* 与遥测共用 USART3：先让遥测发完手上的记录并暂停 */
+            App_Telem_Pause(1);
+            Trace_Dump(Trace_Write_Uart);
+            App_Telem_Pause(0);
+            rt_kprintf("trace dumped to USART3\n");
+        }
+        else
+        {
+            rt_kprintf("TRACE BEGIN\n");
+            trace_hex_col = 0;
+            Trace_Dump(Trace_Write_Hex);
+            rt_kprintf("%sTRACE END\n", trace_hex_col ? "\n" : "");
+        }
+    }
+    else if (argc == 1)
+    {
+        uint32_t total = trace_head;
+        rt_kprintf("trace %s: %u events recorded, %u kept (buffer %d), irq %s, ipc %s\n",
+                   trace_on ? "running" : "stopped", (unsigned)total,
+                   (unsigned)((total > TRACE_BUF_EVENTS) ? TRACE_BUF_EVENTS : total), TRACE_BUF_EVENTS,
+                   trace_irq ? "on" : "off", trace_ipc ? "on" : "off");
+    }
+    else
+    {
+        rt_kprintf("Usage: trace [start [noirq] [noipc] | stop | dump [uart3]]\n");
+    }
+}
+MSH_CMD_EXPORT(trace, kernel trace recorder: trace [start|stop|dump [uart3]]);
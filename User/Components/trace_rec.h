@@ -0,0 +1,86 @@
+/**
+ ******************************************************************************
+ * @file    trace_rec.h
+ * @author  lingxing
+ * @brief   内核事件追踪记录器 (调度/中断/IPC 钩子 + 用户标记，DWT 时间戳)
+ ******************************************************************************
+ * @usage 使用说明:
+ * 1. msh: trace start [noirq] [noipc]  开始记录 (环形缓冲，写满后覆盖最旧事件)
+ *         trace stop                    停止记录 (冻结缓冲区，准备导出)
+ *         trace dump [uart3]            导出：默认十六进制打印到控制台，uart3 为二进制经遥测口发出
+ *         trace                         显示状态
+ *    步进比较中断 TIM1_CC 默认不产生中断事件，要看它须把 MOTOR_CC_IRQ_HOOK 置 1 重新编译。
+ * 2. 代码标记: TRACE_BEGIN("move"); ... TRACE_END("move");  或单点 TRACE_MARK("qr ok");
+ *    名称必须是字符串常量 (只记录指针，导出时再取字符串)。
+ * 3. 上位机: python3 tools/trace2chrome.py dump.bin -o trace.json，用 chrome://tracing 或
+ *    ui.perfetto.dev 打开。
+ *
+ * [导出格式] 小端：
+ *   Trace_Hdr_t | Trace_Name_t x name_count | Trace_Ev_t x count (按时间先后)
+ ******************************************************************************
+ */
+
+#ifndef __TRACE_REC_H
+#define __TRACE_REC_H
+
+#include <stdint.h>
+
+#define TRACE_BUF_EVENTS 1024 /* 缓冲区事件数 (12 字节/事件)，必须为 2 的幂 */
+#define TRACE_NAME_LEN 15     /* 名称表字符串长度 (不含类型字节) */
+
+/* 事件类型 */
+typedef enum
+{
+    TRACE_EV_SWITCH = 1, /* 线程切换，obj = 切入线程 */
+    TRACE_EV_ISR_ENTER,  /* 进入中断 */
+    TRACE_EV_ISR_EXIT,   /* 退出中断 */
+    TRACE_EV_IPC_TRY,    /* 尝试获取 IPC 对象 (可能阻塞)，obj = 对象 */
+    TRACE_EV_IPC_TAKE,   /* 获取到 IPC 对象 */
+    TRACE_EV_IPC_PUT,    /* 释放/发送 IPC 对象 */
+    TRACE_EV_BEGIN,      /* 用户区间开始，obj = 名称 */
+    TRACE_EV_END,        /* 用户区间结束 */
+    TRACE_EV_MARK,       /* 用户单点标记 */
+} Trace_Ev_Type_t;
+
+/* 名称表条目类型 */
+#define TRACE_NAME_THREAD 1
+#define TRACE_NAME_IPC 2
+#define TRACE_NAME_MARK 3
+
+typedef struct
+{
+    uint32_t cyc;      /* DWT->CYCCNT */
+    uint8_t type;      /* Trace_Ev_Type_t */
+    uint8_t irq;       /* 事件发生时的 IPSR 异常号 (IRQn + 16)，0 为线程上下文 */
+    uint16_t reserved;
+    uint32_t obj;      /* 线程 / IPC 对象 / 标记名称的地址 */
+} Trace_Ev_t;
+
+typedef struct
+{
+    char magic[4];       /* "RTTR" */
+    uint16_t version;    /* 1 */
+    uint16_t ev_size;    /* sizeof(Trace_Ev_t) */
+    uint32_t core_hz;    /* DWT 计数频率 */
+    uint32_t count;      /* 导出事件数 */
+    uint32_t lost;       /* 被覆盖的事件数 */
+    uint16_t name_count; /* 名称表条目数 */
+    uint16_t name_size;  /* sizeof(Trace_Name_t) */
+} Trace_Hdr_t;
+
+typedef struct
+{
+    uint32_t obj;
+    uint8_t kind; /* TRACE_NAME_xxx */
+    char name[TRACE_NAME_LEN];
+} Trace_Name_t;
+
+void Trace_Start(uint8_t irq, uint8_t ipc);
+void Trace_Stop(void);
+void Trace_Event(uint8_t type, const void *obj);
+
+#define TRACE_BEGIN(name) Trace_Event(TRACE_EV_BEGIN, name)
+#define TRACE_END(name) Trace_Event(TRACE_EV_END, name)
+#define TRACE_MARK(name) Trace_Event(TRACE_EV_MARK, name)
+
+#endif /* __TRACE_REC_H */
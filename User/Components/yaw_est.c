@@ -0,0 +1,147 @@
+/**
+ ******************************************************************************
+ * @file    yaw_est.c
+ * @author  lingxing
+ * @brief   航向估计器 (陀螺积分 + 绝对角互补滤波 + 静止零偏学习)
+ ******************************************************************************
+ */
+
+#include "yaw_est.h"
+
+/**
+ * @brief  [内部函数] 限幅
+ */
+static float Yaw_Est_Clamp(float v, float max)
+{
+    return (v > max) ? max : (v < -max) ? -max : v;
+}
+
+/**
+ * @brief  初始化估计器
+ * @param  tau: 互补滤波时间常数 (s)，越大越相信陀螺
+ * @param  learn_tau: 静止学习时间常数 (s)，越大零偏/漂移率估计越平稳，收敛越慢
+ */
+void Yaw_Est_Init(Yaw_Est_t *est, float tau, float learn_tau)
+{
+    est->tau = tau;
+    est->learn_tau = learn_tau;
+    est->yaw = 0.0f;
+    est->rate = 0.0f;
+    est->dt = 0.0f;
+    est->stamp = 0;
+    est->ready = 0;
+    est->has_gyro = 0;
+
+    est->still = 0;
+    est->still_ok = 0;
+    est->has_abs = 0;
+    est->bias = 0.0f;
+    est->drift = 0.0f;
+    est->drift_acc = 0.0f;
+    est->last_abs = 0.0f;
+    est->still_time = 0.0f;
+}
+
+/**
+ * @brief  设置底盘静止状态
+ * @param  still: 1 表示底盘已停稳 (由调用方负责去掉刹停后的晃动时间)
+ */
+void Yaw_Est_SetStill(Yaw_Est_t *est, uint8_t still)
+{
+    est->still = still;
+}
+
+/**
+ * @brief  陀螺积分 (每帧角速度调用一次)
+ * @param  rate: Z 轴角速度原始值 (度/s，逆时针为正)
+ * @param  t_ms: 帧到达时刻 (ms)
+ * @note   按梯形积分；首帧或断流后只记录时刻与角速度，不积分。
+ *         静止且读数不超过 YAW_EST_STILL_RATE 时更新零偏估计。
+ */
+void Yaw_Est_Predict(Yaw_Est_t *est, float rate, uint32_t t_ms)
+{
+    float dt = est->has_gyro ? (float)(int32_t)(t_ms - est->stamp) / 1000.0f : 0.0f;
+
+    if (dt < 0.0f || dt > YAW_EST_DT_MAX)
+        dt = 0.0f;
+
+    /* 静止时读数明显不为零说明车身仍在晃动 (或被外力转动)，本帧不作为静止样本 */
+    est->still_ok = est->still && rate - est->bias <= YAW_EST_STILL_RATE && rate - est->bias >= -YAW_EST_STILL_RATE;
+    if (est->still_ok && dt > 0.0f)
+    {
+        est->bias += (dt / (est->learn_tau + dt)) * (rate - est->bias);
+        est->bias = Yaw_Est_Clamp(est->bias, YAW_EST_BIAS_MAX);
+    }
+
+    rate -= est->bias;
+    if (est->ready)
+        est->yaw += 0.5f * (est->rate + rate) * dt;
+
+    est->dt = dt;
+    est->rate = rate;
+    est->stamp = t_ms;
+    est->has_gyro = 1;
+}
+
+/**
+ * @brief  绝对角校正 (每帧角度调用一次)
+ * @param  yaw_abs: 绝对航向原始值 (连续角，度)
+ * @note   先扣除累计漂移再参与互补滤波；收不到角速度时退化为直接采用绝对角
+ */
+void Yaw_Est_Correct(Yaw_Est_t *est, float yaw_abs)
+{
+    float dt = est->has_gyro ? est->dt : 0.0f;
+    uint8_t still = est->has_gyro ? est->still_ok : est->still;
+
+    if (est->has_abs)
+    {
+        if (still)
+        {
+            /* 静止：绝对角的任何变化都是漂移 */
+            float d_abs = yaw_abs - est->last_abs;
+            est->drift_acc += d_abs;
+            if (dt > 0.0f)
+            {
+                est->drift += (dt / (est->learn_tau + dt)) * (d_abs / dt - est->drift);
+                est->drift = Yaw_Est_Clamp(est->drift, YAW_EST_DRIFT_MAX);
+                est->still_time += dt;
+            }
+        }
+        else if (est->still_time >= est->learn_tau)
+        {
+            /* 运动：按已收敛的漂移率外推 */
+            est->drift_acc += est->drift * dt;
+        }
+    }
+    est->last_abs = yaw_abs;
+    est->has_abs = 1;
+
+    yaw_abs -= est->drift_acc;
+    if (!est->ready || dt <= 0.0f)
+    {
+        est->yaw = yaw_abs;
+        est->ready = 1;
+        return;
+    }
+
+    est->yaw += (dt / (est->tau + dt)) * (yaw_abs - est->yaw);
+}
+
+/**
+ * @brief  按最近一帧角速度把估计值外推到指定时刻
+ * @param  t_ms: 目标时刻 (ms)，通常为控制线程本拍的 rt_tick
+ */
+float Yaw_Est_At(const Yaw_Est_t *est, uint32_t t_ms)
+{
+    if (!est->has_gyro)
+        return est->yaw;
+
+    /* 取时刻与收帧存在竞争，目标时刻可能略早于帧时刻 */
+    float dt = (float)(int32_t)(t_ms - est->stamp) / 1000.0f;
+    if (dt < 0.0f)
+        dt = 0.0f;
+    if (dt > YAW_EST_DT_MAX)
+        dt = YAW_EST_DT_MAX;
+
+    return est->yaw + est->rate * dt;
+}
@@ -0,0 +1,62 @@
+/**
+ ******************************************************************************
+ * @file    yaw_est.h
+ * @author  lingxing
+ * @brief   航向估计器 (陀螺积分 + 绝对角互补滤波 + 静止零偏学习)
+ ******************************************************************************
+ * @usage 使用说明:
+ * 1. 初始化: Yaw_Est_Init(&est, 0.3f, 10.0f);        // 互补滤波时间常数 / 静止学习时间常数 (s)
+ * 2. 每收到一帧角速度: Yaw_Est_Predict(&est, gz, t_ms); // gz: 度/s, t_ms: 帧到达时刻
+ * 3. 每收到一帧角度:   Yaw_Est_Correct(&est, yaw);      // yaw: 连续绝对角 (度)
+ * 4. 取值: Yaw_Est_At(&est, t_ms) 按角速度外推到指定时刻
+ * 5. 底盘确认静止时: Yaw_Est_SetStill(&est, 1)，开始运动前置 0
+ *
+ * [思路]:
+ * 陀螺积分响应快、无量化台阶，但会漂移；0x53 角度输出不漂移，但有滞后且量化为 180/32768 度。
+ * 以陀螺积分为主干，绝对角只以 dt / (tau + dt) 的比例慢慢拉回，高频取陀螺、低频取角度。
+ *
+ * 模块自身的角度输出也有缓慢漂移。静止时真实航向不变，因此：
+ * - 陀螺读数的均值即零偏 bias，之后积分前先扣除；
+ * - 绝对角的变化全部计入漂移补偿 drift_acc，同时学习漂移率 drift；
+ *   运动中无法区分转动与漂移，按学到的 drift 外推补偿。
+ ******************************************************************************
+ */
+
+#ifndef __YAW_EST_H
+#define __YAW_EST_H
+
+#include <stdint.h>
+
+#define YAW_EST_DT_MAX 0.1f     /* 两帧间隔超过此值 (s) 视为断流，不做积分 */
+#define YAW_EST_BIAS_MAX 2.0f   /* 陀螺零偏估计上限 (度/s) */
+#define YAW_EST_DRIFT_MAX 0.05f /* 绝对角漂移率估计上限 (度/s，即 3 度/分钟) */
+#define YAW_EST_STILL_RATE 1.0f /* 静止时扣零偏后的角速度超过此值 (度/s) 视为仍在晃动 */
+
+typedef struct
+{
+    float tau;        /* 互补滤波时间常数 (s) */
+    float learn_tau;  /* 静止学习时间常数 (s) */
+    float yaw;        /* 估计航向 (连续角，度) */
+    float rate;       /* 最近一帧角速度，已扣除零偏 (度/s) */
+    float dt;         /* 最近一次积分步长 (s)，供校正系数使用 */
+    uint32_t stamp;   /* 最近一帧角速度的到达时刻 (ms) */
+    uint8_t ready;    /* 0: 尚未收到绝对角，估计值无效 */
+    uint8_t has_gyro; /* 是否已收到过角速度 (决定 stamp 是否有效) */
+
+    uint8_t still;    /* 1: 底盘静止，学习零偏与漂移率 */
+    uint8_t still_ok; /* 最近一帧角速度是否确认静止 (读数未超过 YAW_EST_STILL_RATE) */
+    uint8_t has_abs;  /* 是否已收到过绝对角 (决定 last_abs 是否有效) */
+    float bias;       /* 陀螺零偏估计 (度/s) */
+    float drift;      /* 绝对角漂移率估计 (度/s) */
+    float drift_acc;  /* 已从绝对角中扣除的累计漂移 (度) */
+    float last_abs;   /* 上一帧绝对角原始值 (度) */
+    float still_time; /* 累计静止学习时长 (s)，学习未收敛前不外推漂移率 */
+} Yaw_Est_t;
+
+void Yaw_Est_Init(Yaw_Est_t *est, float tau, float learn_tau);
+void Yaw_Est_SetStill(Yaw_Est_t *est, uint8_t still);
+void Yaw_Est_Predict(Yaw_Est_t *est, float rate, uint32_t t_ms);
+void Yaw_Est_Correct(Yaw_Est_t *est, float yaw_abs);
+float Yaw_Est_At(const Yaw_Est_t *est, uint32_t t_ms);
+
+#endif /* __YAW_EST_H */
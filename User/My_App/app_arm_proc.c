@@ -11,20 +11,13 @@
 #define DBG_TAG "app.arm"
 #define DBG_LVL DBG_INFO
 #include <rtdbg.h>
+#include "../Components/log_async.h"
 #include <stdlib.h>
 
 /*
- * =======================================================================
- * 机械臂下降距离参数 (用户可调 - 脉冲数)
- * =======================================================================
- * 这里的数值代表从最高点(HOME)向下运行的距离
+ * 机械臂下降距离与转盘角度已移至 app_param.h (默认值) / g_param (运行时值)，
+ * 可通过 msh `param set dist_floor 15200` 在线调整并 `param save` 保存。
  */
-#define DIST_PLATE 8000  /* 到原料区(货架)下降距离 */
-#define DIST_CAR 4000    /* 到车内转盘下降距离 */
-#define DIST_STACK 10000 /* 到暂存区二层(码垛)下降距离 */
-#define DIST_FLOOR 15000 /* 到地面(加工区/暂存一层)下降距离 */
-
-/* 爪子角度参数已移至 app_param.h 统一管理 */
 
 extern Motor_t motor_5; /* 升降步进电机 */
 
@@ -42,7 +35,7 @@ static void Arm_Move_Dist(int32_t dist, uint8_t is_down)
     BSP_Motor_ResetSteps(&motor_5);
 
     /* 启动电机：正向速度向下，反向速度向上 */
-    BSP_Motor_SetSpeed(&motor_5, is_down ? 5000 : -5000);
+    BSP_Motor_SetRate(&motor_5, is_down ? ARM_LIFT_RATE : -ARM_LIFT_RATE);
 
     /* 等待走完指定脉冲数 */
     while (abs(BSP_Motor_GetSteps(&motor_5)) < dist)
@@ -63,13 +56,13 @@ void Arm_Pick_From_Raw(void)
     Servo_SetAngle(SERVO_ARM, CLAW_OPEN);
     rt_thread_mdelay(300);
 
-    Arm_Move_Dist(DIST_PLATE, 1); // 下降
+    Arm_Move_Dist(g_param.dist_plate, 1); // 下降
     rt_thread_mdelay(200);
 
     Servo_SetAngle(SERVO_ARM, CLAW_CLOSE);
     rt_thread_mdelay(500);
 
-    Arm_Move_Dist(DIST_PLATE, 0); // 原路返回最高点
+    Arm_Move_Dist(g_param.dist_plate, 0); // 原路返回最高点
     rt_event_send(&mission_event, EV_ARM_FINISHED);
 }
 
@@ -78,7 +71,7 @@ void Arm_Pick_From_Raw(void)
  */
 void Arm_Place_To_Car(uint8_t tray_num)
 {
-    float tray_angles[] = {0.0, PLATE_RED, PLATE_GREEN, PLATE_BLUE};
+    float tray_angles[] = {0.0, g_param.plate_red, g_param.plate_green, g_param.plate_blue};
     float target_angle = (tray_num <= 3) ? tray_angles[tray_num] : 17.0;
 
     LOG_I("Action: [Car] Placing to Tray %d...", tray_num);
@@ -86,13 +79,13 @@ void Arm_Place_To_Car(uint8_t tray_num)
     Servo_SetAngle(SERVO_PLATE, target_angle);
     rt_thread_mdelay(500);
 
-    Arm_Move_Dist(DIST_CAR, 1); // 下降
+    Arm_Move_Dist(g_param.dist_car, 1); // 下降
     rt_thread_mdelay(200);
 
     Servo_SetAngle(SERVO_ARM, CLAW_OPEN);
     rt_thread_mdelay(400);
 
-    Arm_Move_Dist(DIST_CAR, 0); // 返回最高点
+    Arm_Move_Dist(g_param.dist_car, 0); // 返回最高点
     rt_event_send(&mission_event, EV_ARM_FINISHED);
 }
 
@@ -101,7 +94,7 @@ void Arm_Place_To_Car(uint8_t tray_num)
  */
 void Arm_Pick_From_Car(uint8_t tray_num)
 {
-    float tray_angles[] = {0.0, PLATE_RED, PLATE_GREEN, PLATE_BLUE};
+    float tray_angles[] = {0.0, g_param.plate_red, g_param.plate_green, g_param.plate_blue};
     float target_angle = (tray_num <= 3) ? tray_angles[tray_num] : 17.0;
 
     // LOG_I("Action: [Car] Picking from Tray %d...", tray_num);
@@ -110,13 +103,13 @@ void Arm_Pick_From_Car(uint8_t tray_num)
     Servo_SetAngle(SERVO_ARM, CLAW_OPEN);
     rt_thread_mdelay(500);
 
-    Arm_Move_Dist(DIST_CAR, 1); // 下降
+    Arm_Move_Dist(g_param.dist_car, 1); // 下降
     rt_thread_mdelay(200);
 
     Servo_SetAngle(SERVO_ARM, CLAW_CLOSE);
     rt_thread_mdelay(500);
 
-    Arm_Move_Dist(DIST_CAR, 0); // 返回最高点
+    Arm_Move_Dist(g_param.dist_car, 0); // 返回最高点
     rt_event_send(&mission_event, EV_ARM_FINISHED);
 }
 
@@ -129,13 +122,13 @@ void Arm_Place_To_Floor(void)
     Servo_SetAngle(SERVO_BASE, 0); // 回归正前方 (对标原厂 0 度)
     rt_thread_mdelay(400);
 
-    Arm_Move_Dist(DIST_FLOOR, 1); // 下降
+    Arm_Move_Dist(g_param.dist_floor, 1); // 下降
     rt_thread_mdelay(200);
 
     Servo_SetAngle(SERVO_ARM, CLAW_OPEN);
     rt_thread_mdelay(400);
 
-    Arm_Move_Dist(DIST_FLOOR, 0); // 返回最高点
+    Arm_Move_Dist(g_param.dist_floor, 0); // 返回最高点
     rt_event_send(&mission_event, EV_ARM_FINISHED);
 }
 
@@ -149,13 +142,13 @@ void Arm_Pick_From_Floor(void)
     Servo_SetAngle(SERVO_ARM, CLAW_OPEN);
     rt_thread_mdelay(300);
 
-    Arm_Move_Dist(DIST_FLOOR, 1); // 下降
+    Arm_Move_Dist(g_param.dist_floor, 1); // 下降
     rt_thread_mdelay(200);
 
     Servo_SetAngle(SERVO_ARM, CLAW_CLOSE);
     rt_thread_mdelay(500);
 
-    Arm_Move_Dist(DIST_FLOOR, 0); // 返回最高点
+    Arm_Move_Dist(g_param.dist_floor, 0); // 返回最高点
     rt_event_send(&mission_event, EV_ARM_FINISHED);
 }
 
@@ -168,13 +161,13 @@ void Arm_Place_To_Stack(void)
     Servo_SetAngle(SERVO_BASE, 0); // 面向前方码放区
     rt_thread_mdelay(400);
 
-    Arm_Move_Dist(DIST_STACK, 1); // 下降到二层高度
+    Arm_Move_Dist(g_param.dist_stack, 1); // 下降到二层高度
     rt_thread_mdelay(200);
 
     Servo_SetAngle(SERVO_ARM, CLAW_OPEN);
     rt_thread_mdelay(400);
 
-    Arm_Move_Dist(DIST_STACK, 0); // 返回最高点
+    Arm_Move_Dist(g_param.dist_stack, 0); // 返回最高点
     rt_event_send(&mission_event, EV_ARM_FINISHED);
 }
 
@@ -185,7 +178,7 @@ void Arm_Reset_Pos(void)
 {
     Servo_SetAngle(SERVO_ARM, CLAW_OPEN);
     Servo_SetAngle(SERVO_BASE, 0);
-    Servo_SetAngle(SERVO_PLATE, PLATE_RED);
+    Servo_SetAngle(SERVO_PLATE, g_param.plate_red);
     /*
      * 注意：复位时由于不知道当前确切位置，建议手动将手臂抬到最高。
      * 或者此处逻辑可以改为持续向上跑直到撞到限位开关（如果有）。
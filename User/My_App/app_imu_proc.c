@@ -5,22 +5,239 @@
  * [专业架构思路]:
  * 1. 异步化：由串口中断通过信号量唤醒，避开 while(1) 盲目轮询造成的资源消费。
  * 2. 独立化：采样与解析独立成线程，确保姿态数据不因业务繁重而丢失或跳变。
+ * 3. 上电配置：线程启动时用 wit_c_sdk 协商波特率、设置 200Hz 输出 (只保留角速度/角度帧)，
+ *    并实测帧率确认配置生效，之后才进入常规解析循环。
  *
  */
 
 #include "app_imu_proc.h"
+#include "app_param.h"
+#include "app_static.h"
 #include "../Components/imu_wit.h"
+#include "../Components/wit_c_sdk.h"
+#include "../Components/yaw_est.h"
 #include "../My_Driver/bsp_uart.h"
 
+#define DBG_TAG "app.imu"
+#define DBG_LVL DBG_LOG
+#include <rtdbg.h>
+#include "../Components/log_async.h"
+
 #define IMU_STACK_SIZE 2048
 #define IMU_PRIORITY 10
 #define IMU_TICK 5
 
+/* 上电配置 (波特率协商 + 输出频率/内容) */
+#define IMU_SETUP_ADDR 0x50                     /* 维特模块默认地址 */
+#define IMU_SETUP_BAUD_DEFAULT 115200           /* 探测失败时保持的波特率 (与 CubeMX 配置一致) */
+#define IMU_SETUP_PROBE_MS 100                  /* 每个候选波特率的探测时长 */
+#define IMU_SETUP_VERIFY_MS 500                 /* 配置后测量帧率的时长 */
+#define IMU_SETUP_RATE_HZ 200                   /* 目标输出频率 */
+#define IMU_SETUP_RATE_MIN 0.9f                 /* 实测帧率不低于目标的比例 */
+#define IMU_SETUP_CONTENT (RSW_GYRO | RSW_ANGLE) /* 只输出 0x52 角速度 + 0x53 角度 */
+
+/* 候选波特率 (由高到低)。前 IMU_BAUD_TARGETS 个可作为协商目标：
+ * 200Hz x 22 字节约 4.4kB/s，目标波特率至少留 2 倍余量；其余仅用于探测模块当前波特率 */
+static const struct
+{
+    uint32_t baud;
+    int32_t index; /* WIT_BAUD_x */
+} imu_baud_table[] = {
+    {230400, WIT_BAUD_230400},
+    {115200, WIT_BAUD_115200},
+    {57600, WIT_BAUD_57600},
+    {38400, WIT_BAUD_38400},
+    {9600, WIT_BAUD_9600},
+};
+#define IMU_BAUD_NUM (sizeof(imu_baud_table) / sizeof(imu_baud_table[0]))
+#define IMU_BAUD_TARGETS 2
+
 App_IMU_Data_t imu_app_data = {0};   /* 全局共享姿态数据 */
 rt_mq_t imu_mq = RT_NULL;            /* 消息队列：数据解耦的中枢 */
 rt_mutex_t imu_data_mutex = RT_NULL; /* 互斥锁：保护全局姿态数据 */
 
 static rt_thread_t imu_thread = RT_NULL;
+APP_THREAD_DEFINE(imu_thread, IMU_STACK_SIZE);
+APP_MQ_DEFINE(imu_mq, sizeof(Frame_t *), 10);
+APP_MUTEX_DEFINE(imu_data_mutex);
+static Yaw_Est_t yaw_est; /* 航向估计器 (仅在 imu_proc 中更新，读取需持有 imu_data_mutex) */
+static volatile uint8_t imu_still = 0;     /* 底盘指令静止 (由运动层设置) */
+static volatile rt_tick_t imu_still_tick = 0; /* 进入静止的时刻 */
+
+/**
+ * @brief  [内部函数] 接收并处理一批串口数据
+ * @param  timeout: 等待时长 (tick)
+ * @param  upd: 输出，本批数据中解析到的帧类型 (IMU_UPD_x)，可为 RT_NULL
+ * @param  angles: 输出，本批数据中的角度帧个数，可为 RT_NULL
+ * @return RT_EOK: 处理了一批 (可能一帧都没解析出来); -RT_ETIMEOUT: 队列里没有数据
+ */
+static rt_err_t IMU_Pump(rt_int32_t timeout, uint8_t *upd, uint16_t *angles)
+{
+    Frame_t *f;
+
+    /* 1. 等待消息队列：只有串口收完一帧数据，此线程才会被唤醒 (消费者模式) */
+    if (rt_mq_recv(imu_mq, &f, sizeof(f), timeout) != RT_EOK)
+        return -RT_ETIMEOUT;
+
+    rt_tick_t stamp = rt_tick_get(); /* 帧到达时刻 (线程优先级较高，近似空闲中断时刻) */
+
+    /* 2. 在线程环境中执行复杂的包解析 */
+    g_imu_data.update = 0;
+    uint16_t n = IMU_ParsePacket(f->data, f->len);
+    Frame_Free(f);
+
+    /* 3. 使用互斥锁保护共享数据更新 */
+    rt_mutex_take(imu_data_mutex, RT_WAITING_FOREVER);
+    Yaw_Est_SetStill(&yaw_est, imu_still && stamp - imu_still_tick >= rt_tick_from_millisecond(IMU_STILL_SETTLE_MS));
+    if (g_imu_data.update & IMU_UPD_GYRO)
+        Yaw_Est_Predict(&yaw_est, g_imu_data.gyro.z, (uint32_t)stamp);
+    if (g_imu_data.update & IMU_UPD_ANGLE)
+        Yaw_Est_Correct(&yaw_est, g_imu_data.yaw);
+
+    imu_app_data.yaw = g_imu_data.yaw;
+    imu_app_data.yaw_total = g_imu_data.yaw_continuous;
+    imu_app_data.yaw_est = yaw_est.yaw;
+    imu_app_data.yaw_rate = yaw_est.rate;
+    imu_app_data.stamp = (rt_tick_t)yaw_est.stamp;
+    imu_app_data.gyro_bias = yaw_est.bias;
+    imu_app_data.drift_dpm = yaw_est.drift * 60.0f;
+    rt_mutex_release(imu_data_mutex);
+
+    if (upd != RT_NULL)
+        *upd = g_imu_data.update;
+    if (angles != RT_NULL)
+        *angles = n;
+    return RT_EOK;
+}
+
+/**
+ * @brief  [内部函数] 统计一段时间内的角度帧数，换算为输出频率 (数据照常更新姿态)
+ * @param  extra: 输出是否收到了 IMU_SETUP_CONTENT 以外的帧类型
+ * @return 实测输出频率 (Hz)
+ */
+static uint32_t IMU_Measure_Rate(uint32_t ms, uint8_t *extra)
+{
+    /* 先处理掉测量开始前已排队的数据 (例如切换波特率之前收到的帧)，直到队列取空 */
+    while (IMU_Pump(0, RT_NULL, RT_NULL) == RT_EOK)
+        ;
+
+    rt_tick_t start = rt_tick_get();
+    rt_tick_t span = rt_tick_from_millisecond(ms);
+    uint32_t frames = 0;
+
+    *extra = 0;
+    while (rt_tick_get() - start < span)
+    {
+        uint8_t upd;
+        uint16_t angles;
+        if (IMU_Pump((rt_int32_t)(span - (rt_tick_get() - start)), &upd, &angles) != RT_EOK)
+            continue;
+        frames += angles; /* 按帧计：一次空闲中断合并多组输出时不少算 */
+        if (upd & (IMU_UPD_ACC | IMU_UPD_OTHER))
+            *extra = 1;
+    }
+
+    return frames * 1000 / ms;
+}
+
+static void IMU_Wit_Write(uint8_t *data, uint32_t len)
+{
+    BSP_UART_Send(&uart2_imu, data, (uint16_t)len);
+}
+
+static void IMU_Wit_Delay(uint16_t ms)
+{
+    rt_thread_mdelay(ms);
+}
+
+/**
+ * @brief  [内部函数] 逐个候选波特率探测模块当前波特率，主控停在探测到的波特率上
+ * @return imu_baud_table 下标，没有响应返回 -1 (此时主控停在最后一个候选)
+ */
+static int IMU_Probe(void)
+{
+    uint8_t extra;
+
+    for (uint32_t i = 0; i < IMU_BAUD_NUM; i++)
+    {
+        BSP_UART_SetBaud(&uart2_imu, imu_baud_table[i].baud);
+        if (IMU_Measure_Rate(IMU_SETUP_PROBE_MS, &extra) > 0)
+            return (int)i;
+    }
+    return -1;
+}
+
+/**
+ * @brief  [内部函数] 上电配置：探测当前波特率 -> 写输出内容/频率 -> 由高到低协商波特率 -> 实测帧率验证
+ * @note   模块已是目标配置 (上次验证后已保存) 时不写任何参数；协商全部失败时重新探测，
+ *         主控停在模块实际所在的波特率照常解析 (探测不到则保持默认波特率)
+ */
+static void IMU_Setup(void)
+{
+    uint32_t rate = 0;
+    uint8_t extra = 0;
+    int cur;
+
+    WitInit(WIT_PROTOCOL_NORMAL, IMU_SETUP_ADDR);
+    WitSerialWriteRegister(IMU_Wit_Write);
+    WitDelayMsRegister(IMU_Wit_Delay);
+
+    /* 1. 探测模块当前波特率 */
+    cur = IMU_Probe();
+    if (cur < 0)
+    {
+        LOG_W("IMU not responding, keep %d baud", IMU_SETUP_BAUD_DEFAULT);
+        BSP_UART_SetBaud(&uart2_imu, IMU_SETUP_BAUD_DEFAULT);
+        return;
+    }
+
+    /* 2. 已是目标配置则直接使用 */
+    if (cur == 0)
+    {
+        rate = IMU_Measure_Rate(IMU_SETUP_VERIFY_MS, &extra);
+        if (rate >= IMU_SETUP_RATE_HZ * IMU_SETUP_RATE_MIN && !extra)
+        {
+            LOG_I("IMU ready: %d baud, %d Hz", imu_baud_table[cur].baud, rate);
+            return;
+        }
+    }
+
+    /* 3. 在当前波特率下写输出内容、带宽与频率 */
+    WitSetContent(IMU_SETUP_CONTENT);
+    WitSetBandwidth(BANDWIDTH_94HZ);
+    WitSetOutputRate(RRATE_200HZ);
+
+    /* 4. 由高到低尝试目标波特率，实测帧率达标后保存到模块 */
+    for (int t = 0; t < IMU_BAUD_TARGETS; t++)
+    {
+        if (t != cur)
+        {
+            WitSetUartBaud(imu_baud_table[t].index);
+            rt_thread_mdelay(20); /* 等待命令发完、模块切换 */
+            BSP_UART_SetBaud(&uart2_imu, imu_baud_table[t].baud);
+            cur = t;
+        }
+
+        rate = IMU_Measure_Rate(IMU_SETUP_VERIFY_MS, &extra);
+        if (rate >= IMU_SETUP_RATE_HZ * IMU_SETUP_RATE_MIN && !extra)
+        {
+            WitSaveParameter();
+            LOG_I("IMU configured: %d baud, %d Hz", imu_baud_table[cur].baud, rate);
+            return;
+        }
+        LOG_W("IMU unstable at %d baud (%d Hz)", imu_baud_table[cur].baud, rate);
+    }
+
+    /* 5. 都不达标：改波特率的命令可能丢了，模块仍在旧波特率；重新探测，让主控跟上模块 */
+    cur = IMU_Probe();
+    if (cur < 0)
+    {
+        LOG_E("IMU setup failed and lost, keep %d baud", IMU_SETUP_BAUD_DEFAULT);
+        BSP_UART_SetBaud(&uart2_imu, IMU_SETUP_BAUD_DEFAULT);
+        return;
+    }
+    LOG_E("IMU setup failed, running at %d baud", imu_baud_table[cur].baud);
+}
 
 /**
  * @brief  IMU 处理线程入口 (Proc)
@@ -28,22 +245,12 @@ static rt_thread_t imu_thread = RT_NULL;
 static void imu_proc(void *parameter)
 {
     IMU_Init(); /* 组件层初始化 */
+    Yaw_Est_Init(&yaw_est, YAW_EST_TAU, YAW_EST_LEARN_TAU);
+    IMU_Setup();
 
     while (1)
     {
-        uint32_t rx_len;
-        /* 1. 等待消息队列：只有串口收完一帧数据，此线程才会被唤醒 (消费者模式) */
-        if (rt_mq_recv(imu_mq, &rx_len, sizeof(rx_len), RT_WAITING_FOREVER) == RT_EOK)
-        {
-            /* 2. 在线程环境中执行复杂的包解析 */
-            IMU_ParsePacket(uart2_imu.rx_buffer, (uint16_t)rx_len);
-
-            /* 3. 使用互斥锁保护共享数据更新 */
-            rt_mutex_take(imu_data_mutex, RT_WAITING_FOREVER);
-            imu_app_data.yaw = g_imu_data.yaw;
-            imu_app_data.yaw_total = g_imu_data.yaw_continuous;
-            rt_mutex_release(imu_data_mutex);
-        }
+        IMU_Pump(RT_WAITING_FOREVER, RT_NULL, RT_NULL);
     }
 }
 
@@ -53,18 +260,14 @@ static void imu_proc(void *parameter)
 int App_IMU_Init(void)
 {
     /* [避坑]: 必须先创建通信对象 (MQ + Mutex) */
-    imu_mq = rt_mq_create("mq_imu", sizeof(uint32_t), 10, RT_IPC_FLAG_FIFO);
-    imu_data_mutex = rt_mutex_create("mux_imu", RT_IPC_FLAG_FIFO);
+    imu_mq = APP_MQ_CREATE(imu_mq, "mq_imu", RT_IPC_FLAG_FIFO);
+    imu_data_mutex = APP_MUTEX_CREATE(imu_data_mutex, "mux_imu", RT_IPC_FLAG_FIFO);
 
-    imu_thread = rt_thread_create("imu_proc",
-                                  imu_proc,
-                                  RT_NULL,
-                                  IMU_STACK_SIZE,
-                                  IMU_PRIORITY,
-                                  IMU_TICK);
+    imu_thread = APP_THREAD_CREATE(imu_thread, "imu_proc", imu_proc, RT_NULL, IMU_PRIORITY, IMU_TICK);
 
     if (imu_thread != RT_NULL && imu_mq != RT_NULL && imu_data_mutex != RT_NULL)
     {
+        BSP_UART_Init(&uart2_imu); /* 队列就绪后才开接收 (帧内存池已在组件初始化阶段建好) */
         rt_thread_startup(imu_thread);
         return 0;
     }
@@ -72,5 +275,64 @@ int App_IMU_Init(void)
     return -1;
 }
 
+/**
+ * @brief  [API] 读取融合航向与角速度 (按角速度外推到调用时刻)
+ */
+void App_IMU_Get_Heading(float *yaw, float *rate)
+{
+    rt_mutex_take(imu_data_mutex, RT_WAITING_FOREVER);
+    *yaw = Yaw_Est_At(&yaw_est, (uint32_t)rt_tick_get());
+    if (rate != RT_NULL)
+        *rate = yaw_est.rate;
+    rt_mutex_release(imu_data_mutex);
+}
+
+/**
+ * @brief  [API] 告知底盘是否处于指令静止状态
+ */
+void App_IMU_Set_Still(uint8_t still)
+{
+    if (still && !imu_still)
+        imu_still_tick = rt_tick_get();
+    imu_still = still;
+}
+
+/**
+ * @brief  [内部函数] 按 "[-]整数.小数" 打印 (rt_kprintf 不支持 %f)
+ */
+static void IMU_Print_Fixed(const char *name, float v, const char *unit)
+{
+    const char *sign = (v < 0) ? "-" : "";
+    if (v < 0)
+        v = -v;
+    int32_t ip = (int32_t)v;
+    int32_t fp = (int32_t)((v - (float)ip) * 10000.0f + 0.5f);
+    if (fp >= 10000)
+    {
+        ip++;
+        fp -= 10000;
+    }
+    rt_kprintf("%-10s %s%d.%04d %s\n", name, sign, ip, fp, unit);
+}
+
+/**
+ * @brief  msh 命令: imu (查看航向估计、陀螺零偏与残余漂移)
+ */
+static void imu(int argc, char **argv)
+{
+    rt_mutex_take(imu_data_mutex, RT_WAITING_FOREVER);
+    Yaw_Est_t est = yaw_est;
+    float yaw_abs = imu_app_data.yaw;
+    rt_mutex_release(imu_data_mutex);
+
+    IMU_Print_Fixed("yaw_abs", yaw_abs, "deg");
+    IMU_Print_Fixed("yaw_est", est.yaw, "deg");
+    IMU_Print_Fixed("gyro_bias", est.bias, "deg/s");
+    IMU_Print_Fixed("drift", est.drift * 60.0f, "deg/min");
+    IMU_Print_Fixed("drift_acc", est.drift_acc, "deg");
+    IMU_Print_Fixed("still", est.still_time, "s");
+}
+MSH_CMD_EXPORT(imu, show yaw estimate / gyro bias / residual drift);
+
 /* 自动化启动：系统启动时自动调用 App_IMU_Init */
 INIT_APP_EXPORT(App_IMU_Init);
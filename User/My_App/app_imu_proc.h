@@ -17,6 +17,11 @@ typedef struct
     float roll;      /* 横滚角 */
     float yaw;       /* 相对航向角 (归零后) */
     float yaw_total; /* 连续航向角 (不归零) */
+    float yaw_est;   /* 融合航向 (陀螺积分 + 绝对角校正，归零后的连续角) */
+    float yaw_rate;  /* Z 轴角速度 (度/s，逆时针为正) */
+    rt_tick_t stamp; /* 最近一帧角速度的到达时刻 */
+    float gyro_bias; /* 陀螺零偏估计 (度/s)，静止时学习 */
+    float drift_dpm; /* 角度输出残余漂移率估计 (度/分钟)，静止时学习 */
 } App_IMU_Data_t;
 
 extern App_IMU_Data_t imu_app_data;
@@ -30,4 +35,19 @@ extern rt_mutex_t imu_data_mutex; /* 互斥锁：保护跨线程共享的传感
  */
 int App_IMU_Init(void);
 
+/**
+ * @brief  [API] 读取融合航向与角速度
+ * @param  yaw: 输出融合航向 (度，连续角)，已按角速度外推到调用时刻
+ * @param  rate: 输出 Z 轴角速度 (度/s)，可传 RT_NULL
+ * @note   比 imu_app_data.yaw (0x53 角度帧) 滞后更小、没有量化台阶，供航向闭环使用
+ */
+void App_IMU_Get_Heading(float *yaw, float *rate);
+
+/**
+ * @brief  [API] 告知底盘是否处于指令静止状态
+ * @param  still: 1 静止 (停车超过 IMU_STILL_SETTLE_MS 后开始学习零偏与漂移)，0 运动
+ * @note   由运动层在每个控制周期调用，开始运动时须立即置 0
+ */
+void App_IMU_Set_Still(uint8_t still);
+
 #endif /* __APP_IMU_H */
@@ -11,11 +11,16 @@
 #include "../My_Driver/bsp_uart.h"
 #include "../My_Driver/bsp_motor.h"
 #include "../My_Driver/bsp_pid.h"
+#include "../My_Driver/bsp_ccm.h"
+#include "../Components/trace_rec.h"
 #include "app_task_proc.h"
+#include "app_telem_proc.h"
+#include "app_static.h"
 
 #define DBG_TAG "app.move"
 #define DBG_LVL DBG_LOG
 #include <rtdbg.h>
+#include "../Components/log_async.h"
 
 #define ABS(x) ((x) < 0 ? -(x) : (x))
 
@@ -24,18 +29,80 @@ static Move_Mode_t current_mode = MOVE_STOP;
 static float target_speed = 0.0f;  /* 目标速度 (mm/s) */
 static float current_speed = 0.0f; /* 当前平滑速度 (mm/s) */
 
-static float target_yaw = 0.0f; /* 目标航向角 (0-360) */
+static float target_yaw = 0.0f; /* 锁定航向角 (连续角，度) */
+static uint8_t yaw_hold = 0;    /* target_yaw 是否为有效的锁定航向 (可被下一平移段沿用) */
 
 /* 2. 位移控制变量 (Displacement) */
-static int32_t target_pulse_x = 0; /* 目标 X 轴总脉冲数 */
+static int32_t target_pulse_x = 0; /* 目标车体路程 (脉冲) */
+static uint8_t move_coord = 0;     /* 本段位移由驱动层联动插补执行 */
+static float move_coord_speed = 0; /* 联动段步数最多的轮的标称轮速 (mm/s)，航向修正按它换算为比例 */
+static uint8_t move_leg = 0;       /* 段序号，每次里程清零加 1 (供遥测拼接位姿) */
+
+/* 平移类模式的车体单位方向 (x 车头向前，y 向左) */
+typedef struct
+{
+    float vx, vy;
+} Move_Dir_t;
+
+#define MOVE_DIAG_K 0.70710678f /* 45° 斜行的分量系数 */
+
+static const Move_Dir_t move_dir[] = {
+    [MOVE_FORWARD] = {1.0f, 0.0f},
+    [MOVE_BACKWARD] = {-1.0f, 0.0f},
+    [MOVE_SLIDE_LEFT] = {0.0f, 1.0f},
+    [MOVE_SLIDE_RIGHT] = {0.0f, -1.0f},
+    [MOVE_DIAG_FL] = {MOVE_DIAG_K, MOVE_DIAG_K},
+    [MOVE_DIAG_FR] = {MOVE_DIAG_K, -MOVE_DIAG_K},
+    [MOVE_DIAG_BL] = {-MOVE_DIAG_K, MOVE_DIAG_K},
+    [MOVE_DIAG_BR] = {-MOVE_DIAG_K, -MOVE_DIAG_K},
+};
+
+#define MOVE_IS_TRANSLATE(mode) ((mode) >= MOVE_FORWARD && (mode) <= MOVE_DIAG_BR)
+
+/* 旋转分量在四轮上的方向 (与 Move_Mix 一致：左侧 -vrot，右侧 +vrot)，航向修正按此叠加到联动插补 */
+static const int8_t move_trim_dir[4] = {-1, 1, -1, 1};
 
 /* 3. PID 实例 */
-static PID_t pid_yaw;                 /* 用于直线行驶的“航向锁” */
+static PID_t pid_yaw;                 /* 用于所有平移模式的“航向锁” */
 static PID_t pid_turn;                /* 新增：用于旋转到特定角度的“位置环” */
 static float yaw_compensation = 0.0f; /* PID 计算出的旋转修正量 */
 
+/* 4. 转向轨迹规划 (时间最优参考角) 与增益调度 */
+static float turn_goal = 0.0f;     /* 本次转向的连续目标角 (度) */
+static float turn_ref = 0.0f;      /* 当前参考角 (度)，由轨迹规划推进 */
+static float turn_ref_rate = 0.0f; /* 参考角速度 (度/s) */
+static float turn_kp_base, turn_ki_base, turn_kd_base; /* 调度前的基准增益 (连续域) */
+
+/**
+ * 转向增益调度表：按剩余角度 |goal - yaw| 线性插值，系数乘在基准增益上。
+ * 大角度时压低 kp 交给轨迹规划带着走；小角度时抬高 kp/ki，避免末段“磨蹭”。
+ */
+typedef struct
+{
+    float err_deg;
+    float kp_scale, ki_scale, kd_scale;
+} Turn_Sched_t;
+
+static const Turn_Sched_t turn_sched[] = {
+    {0.0f, 1.6f, 2.0f, 1.0f},
+    {3.0f, 1.3f, 1.5f, 1.0f},
+    {10.0f, 1.0f, 1.0f, 1.0f},
+    {45.0f, 0.8f, 0.5f, 1.2f},
+};
+#define TURN_SCHED_SIZE (sizeof(turn_sched) / sizeof(turn_sched[0]))
+
+/* 5. 继电器整定实验 */
+static Move_Loop_t relay_loop = MOVE_LOOP_TURN;
+static float relay_amp = 0.0f;  /* 继电器幅值 */
+static float relay_hyst = 0.0f; /* 继电器回差 (度) */
+static float relay_out = 0.0f;  /* 当前继电器输出 */
+
 /* 采样周期 20ms */
 #define MOVE_CONTROL_TICK 20
+#define MOVE_CONTROL_DT (MOVE_CONTROL_TICK / 1000.0f)
+
+/* 实测控制周期 (s)，由 move_proc 每拍更新，供 PID 扩展模式使用 */
+static float move_dt = MOVE_CONTROL_DT;
 
 /* 线程参数 */
 #define MOVE_THREAD_STACK_SIZE 1024
@@ -43,6 +110,7 @@ static float yaw_compensation = 0.0f; /* PID 计算出的旋转修正量 */
 #define MOVE_THREAD_TIMESLICE 5
 
 static rt_thread_t move_thread = RT_NULL;
+APP_THREAD_DEFINE_CCM(move_thread, MOVE_THREAD_STACK_SIZE); /* 栈上只有局部运算量，无 DMA 缓冲 */
 
 /* ========================================================================== */
 /*                          1. 内部辅助工具 (Internal Helpers)                  */
@@ -60,7 +128,7 @@ static float Get_Velocity_Boundary(float dist_mm)
         return 1.0f; // 极小距离限速，防止开方抖动
 
     // v = sqrt(2 * a * d)
-    return sqrtf(2.0f * MOVE_ACCEL_VAL * dist_mm);
+    return sqrtf(2.0f * g_param.move_accel * dist_mm);
 }
 
 /**
@@ -83,6 +151,157 @@ static float Move_Step_Towards(float current, float target, float step)
     return current;
 }
 
+/**
+ * @brief  [内部函数] 角度误差归一化到 (-180, 180]
+ */
+static float Move_Wrap_Angle(float deg)
+{
+    while (deg > 180.0f)
+        deg -= 360.0f;
+    while (deg < -180.0f)
+        deg += 360.0f;
+    return deg;
+}
+
+/**
+ * @brief  [内部函数] 按剩余角度插值转向增益并写入 pid_turn
+ */
+static void Move_Turn_Schedule(float abs_err)
+{
+    const Turn_Sched_t *lo = &turn_sched[0];
+    const Turn_Sched_t *hi = &turn_sched[TURN_SCHED_SIZE - 1];
+    float kp_s = hi->kp_scale, ki_s = hi->ki_scale, kd_s = hi->kd_scale;
+
+    if (abs_err <= lo->err_deg)
+    {
+        kp_s = lo->kp_scale;
+        ki_s = lo->ki_scale;
+        kd_s = lo->kd_scale;
+    }
+    else
+    {
+        for (uint32_t i = 1; i < TURN_SCHED_SIZE; i++)
+        {
+            if (abs_err < turn_sched[i].err_deg)
+            {
+                lo = &turn_sched[i - 1];
+                hi = &turn_sched[i];
+                float t = (abs_err - lo->err_deg) / (hi->err_deg - lo->err_deg);
+                kp_s = lo->kp_scale + t * (hi->kp_scale - lo->kp_scale);
+                ki_s = lo->ki_scale + t * (hi->ki_scale - lo->ki_scale);
+                kd_s = lo->kd_scale + t * (hi->kd_scale - lo->kd_scale);
+                break;
+            }
+        }
+    }
+
+    BSP_PID_SetParams(&pid_turn, turn_kp_base * kp_s, turn_ki_base * ki_s, turn_kd_base * kd_s);
+}
+
+/**
+ * @brief  [内部函数] 推进转向参考角 (梯形/三角形速度曲线，时间最优)
+ * @note   参考角速度不超过 TURN_RATE_MAX，且始终满足 v^2 <= 2*a*剩余角，保证刚好停在目标
+ */
+static void Move_Turn_Profile(float dt)
+{
+    float remain = turn_goal - turn_ref;
+    float v_stop = sqrtf(2.0f * TURN_ACCEL * ABS(remain));
+    float v_want = (v_stop < TURN_RATE_MAX) ? v_stop : TURN_RATE_MAX;
+    if (remain < 0)
+        v_want = -v_want;
+
+    turn_ref_rate = Move_Step_Towards(turn_ref_rate, v_want, TURN_ACCEL * dt);
+    turn_ref += turn_ref_rate * dt;
+
+    /* 到站或越过目标时钉死在目标上 */
+    if ((remain >= 0 && turn_ref >= turn_goal) || (remain <= 0 && turn_ref <= turn_goal))
+    {
+        turn_ref = turn_goal;
+        turn_ref_rate = 0;
+    }
+}
+
+/**
+ * @brief  [内部函数] 麦轮逆运动学：车体平移速度 + 旋转分量 -> 四轮轮速 (mm/s)
+ * @param  vx / vy: 车体前向 / 左向速度 (mm/s)
+ * @param  vrot: 旋转分量 (轮缘线速度 mm/s，逆时针为正)
+ * @note   旋转只与左右两侧有关 (左侧 -vrot，右侧 +vrot)，与平移方向无关，
+ *         因此同一个航向修正量可以直接叠加到任意平移方向上。
+ */
+static void Move_Mix(float vx, float vy, float vrot, float m[4])
+{
+    m[0] = vx - vy - vrot; /* M1 左前 */
+    m[1] = vx + vy + vrot; /* M2 右前 */
+    m[2] = vx + vy - vrot; /* M3 左后 */
+    m[3] = vx - vy + vrot; /* M4 右后 */
+}
+
+/**
+ * @brief  [内部函数] 由四轮里程正解车体路程 (脉冲)
+ * @note   旋转分量在正解中相互抵消，航向修正不影响测距；斜行时 M1/M4 不转，
+ *         不能再只看单个轮子的步数。
+ */
+static float Move_Get_Path_Pulse(void)
+{
+    float s1 = (float)BSP_Motor_GetSteps(&motor_1);
+    float s2 = (float)BSP_Motor_GetSteps(&motor_2);
+    float s3 = (float)BSP_Motor_GetSteps(&motor_3);
+    float s4 = (float)BSP_Motor_GetSteps(&motor_4);
+    float dx = (s1 + s2 + s3 + s4) * 0.25f;
+    float dy = (-s1 + s2 + s3 - s4) * 0.25f;
+
+    return sqrtf(dx * dx + dy * dy);
+}
+
+/**
+ * @brief  [内部函数] 下发四轮轮速 (mm/s)，按标定线性换算为步频，由驱动逐步斜坡平滑
+ */
+static void Move_Set_Wheels(const float m[4])
+{
+    float accel = MOTOR_RAMP_ACCEL * g_param.pulse_per_mm;
+
+    BSP_Motor_SetAccel(&motor_1, accel);
+    BSP_Motor_SetAccel(&motor_2, accel);
+    BSP_Motor_SetAccel(&motor_3, accel);
+    BSP_Motor_SetAccel(&motor_4, accel);
+
+    BSP_Motor_SetRate(&motor_1, m[0] * g_param.pulse_per_mm);
+    BSP_Motor_SetRate(&motor_2, m[1] * g_param.pulse_per_mm);
+    BSP_Motor_SetRate(&motor_3, m[2] * g_param.pulse_per_mm);
+    BSP_Motor_SetRate(&motor_4, m[3] * g_param.pulse_per_mm);
+}
+
+/**
+ * @brief  [内部函数] 提交本拍遥测记录 (只拷贝数值，不做格式化)
+ * @param  m: 本拍下发的四轮轮速 (mm/s)
+ * @param  pid: 本拍生效的航向环，RT_NULL 表示开环
+ * @param  yaw_ref: 航向目标 (度)
+ */
+static void Move_Telem(const float m[4], float yaw, float yaw_rate, const PID_t *pid, float yaw_ref)
+{
+    Telem_Ctrl_t rec;
+
+    rec.mode = (uint8_t)current_mode;
+    rec.flags = (move_coord ? TELEM_F_COORD : 0) | (yaw_hold ? TELEM_F_HOLD : 0);
+    rec.leg = move_leg;
+    rec.speed = current_speed;
+    for (int i = 0; i < 4; i++)
+        rec.wheel[i] = m[i];
+    rec.steps[0] = BSP_Motor_GetSteps(&motor_1);
+    rec.steps[1] = BSP_Motor_GetSteps(&motor_2);
+    rec.steps[2] = BSP_Motor_GetSteps(&motor_3);
+    rec.steps[3] = BSP_Motor_GetSteps(&motor_4);
+    rec.yaw = yaw;
+    rec.yaw_rate = yaw_rate;
+    rec.yaw_ref = yaw_ref;
+    rec.pid_p = pid ? pid->p_out : 0.0f;
+    rec.pid_i = pid ? pid->i_out : 0.0f;
+    rec.pid_d = pid ? pid->d_out : 0.0f;
+    rec.pid_out = pid ? pid->output : 0.0f;
+
+    App_Telem_Push(&rec);
+}
+
 /* ========================================================================== */
 /*                          2. 运动控制核心线程 (Core Thread)                   */
 /* ========================================================================== */
@@ -92,19 +311,58 @@ static float Move_Step_Towards(float current, float target, float step)
  */
 static void move_proc(void *parameter)
 {
+    rt_tick_t last_tick = rt_tick_get();
+
     while (1)
     {
-        if (current_mode != MOVE_STOP)
+        TRACE_BEGIN("move");
+        uint32_t loop_t0 = CCM_CYCLES();
+
+        /* 实测本拍周期：线程调度抖动不再直接变成 D 项噪声 */
+        rt_tick_t now_tick = rt_tick_get();
+        move_dt = (float)(now_tick - last_tick) / RT_TICK_PER_SECOND;
+        last_tick = now_tick;
+        if (move_dt > 5.0f * MOVE_CONTROL_DT)
+            move_dt = 5.0f * MOVE_CONTROL_DT; /* 长时间阻塞后限制单拍积分量 */
+
+        App_IMU_Set_Still(current_mode == MOVE_STOP); /* 停车期间 IMU 学习陀螺零偏与漂移 */
+
+        /* 本拍下发的轮速与生效的航向环，除参与控制外也原样记入遥测 */
+        float m[4] = {0};
+        float yaw, yaw_rate; /* 融合航向 (外推到本拍) 与陀螺角速度，D 项直接用角速度 */
+        const PID_t *loop_pid = RT_NULL;
+        float yaw_ref = target_yaw;
+        App_IMU_Get_Heading(&yaw, &yaw_rate);
+
+        if (move_coord && MOVE_IS_TRANSLATE(current_mode))
+        {
+            /* 联动插补在中断里按自己的梯形曲线走完，这里只做航向锁：
+             * 修正量 (轮速 mm/s) 换算为相对最多的轮的比例，作为差速叠加在插补上，不改变平移步数 */
+            if (!BSP_Motor_Coord_Busy())
+            {
+                Move_Stop();
+                rt_event_send(&mission_event, EV_MOVE_FINISHED);
+            }
+            else
+            {
+                yaw_compensation = BSP_PID_CalcPositionalRate(&pid_yaw, yaw, yaw_rate, move_dt);
+                loop_pid = &pid_yaw;
+                BSP_Motor_Coord_Trim(yaw_compensation / move_coord_speed);
+                Move_Mix(move_dir[current_mode].vx * target_speed, move_dir[current_mode].vy * target_speed,
+                         yaw_compensation, m); /* 仅供遥测：标称轮速 */
+            }
+        }
+        else if (current_mode != MOVE_STOP)
         {
             /* --- 步骤 1: 物理状态解算 --- */
-            float step = MOVE_ACCEL_VAL * (MOVE_CONTROL_TICK / 1000.0f); // 本周期最大速度增量
-            float current_pulse = (float)ABS(BSP_Motor_GetSteps(&motor_1));
+            float step = g_param.move_accel * move_dt; // 本周期最大速度增量
+            float current_pulse = Move_Get_Path_Pulse();
 
             // 计算剩余距离 (mm)。如果是 0 则代表巡航模式，给予极大值
             float remain_dist = 999999.0f;
             if (target_pulse_x > 0)
             {
-                remain_dist = (target_pulse_x - (int32_t)current_pulse) / PULSE_PER_MM;
+                remain_dist = (target_pulse_x - (int32_t)current_pulse) / g_param.pulse_per_mm;
                 if (remain_dist < 0)
                     remain_dist = 0;
             }
@@ -127,62 +385,40 @@ static void move_proc(void *parameter)
                 // LOG_D("Move dist done, signaling brain.");
             }
 
-            /* --- 步骤 3: 运动模式映射 (Kinematics) --- */
-            float m1, m2, m3, m4;
-            float out_speed = current_speed * MOVE_SPEED_SCALE;
+            /* --- 步骤 3: 运动模式映射 (Kinematics)，各轮输出单位均为 mm/s --- */
+            float out_speed = current_speed;
 
             switch (current_mode)
             {
             case MOVE_FORWARD:
-                yaw_compensation = BSP_PID_CalcPositional(&pid_yaw, imu_app_data.yaw);
-                m1 = m3 = out_speed - yaw_compensation;
-                m2 = m4 = out_speed + yaw_compensation;
-                break;
-
             case MOVE_BACKWARD:
-                yaw_compensation = BSP_PID_CalcPositional(&pid_yaw, imu_app_data.yaw);
-                m1 = m3 = -out_speed - yaw_compensation;
-                m2 = m4 = -out_speed + yaw_compensation;
-                break;
-
-            case MOVE_SLIDE_LEFT: // 左平移：M1-, M2+, M3+, M4-
-                m1 = -out_speed;
-                m4 = -out_speed;
-                m2 = out_speed;
-                m3 = out_speed;
-                break;
-
-            case MOVE_SLIDE_RIGHT: // 右平移：M1+, M2-, M3-, M4+
-                m1 = out_speed;
-                m4 = out_speed;
-                m2 = -out_speed;
-                m3 = -out_speed;
+            case MOVE_SLIDE_LEFT:
+            case MOVE_SLIDE_RIGHT:
+            case MOVE_DIAG_FL:
+            case MOVE_DIAG_FR:
+            case MOVE_DIAG_BL:
+            case MOVE_DIAG_BR:
+                /* 航向锁：修正量作为旋转分量叠加，由逆运动学分配到对应轮组 */
+                yaw_compensation = BSP_PID_CalcPositionalRate(&pid_yaw, yaw, yaw_rate, move_dt);
+                loop_pid = &pid_yaw;
+                Move_Mix(move_dir[current_mode].vx * out_speed, move_dir[current_mode].vy * out_speed,
+                         yaw_compensation, m);
                 break;
 
             case MOVE_TURN_LEFT: // 原地左转：M1-, M2+, M3-, M4+
-                m1 = -out_speed;
-                m3 = -out_speed;
-                m2 = out_speed;
-                m4 = out_speed;
+                Move_Mix(0, 0, out_speed, m);
                 break;
 
             case MOVE_TURN_RIGHT: // 原地右转：M1+, M2-, M3+, M4-
-                m1 = out_speed;
-                m3 = out_speed;
-                m2 = -out_speed;
-                m4 = -out_speed;
+                Move_Mix(0, 0, -out_speed, m);
                 break;
 
             case MOVE_TURN_ABS:
             {
-                /* 绝对角度旋转：使用 pid_turn 闭环控制 */
-                float error = target_yaw - imu_app_data.yaw;
-                while (error > 180.0f)
-                    error -= 360.0f;
-                while (error < -180.0f)
-                    error += 360.0f;
-
-                if (ABS(error) < TURN_ERROR_THRESHOLD)
+                /* 绝对角度旋转：参考角按时间最优曲线推进，前馈给出参考角速度，pid_turn 负责跟踪误差 */
+                float error = turn_goal - yaw;
+
+                if (ABS(error) < TURN_ERROR_THRESHOLD && turn_ref == turn_goal)
                 {
                     Move_Stop();
                     rt_event_send(&mission_event, EV_MOVE_FINISHED);
@@ -190,9 +426,28 @@ static void move_proc(void *parameter)
                     continue;
                 }
 
-                float vrot = BSP_PID_CalcPositional(&pid_turn, imu_app_data.yaw);
-                m1 = m3 = -vrot;
-                m2 = m4 = vrot;
+                Move_Turn_Profile(move_dt);
+                Move_Turn_Schedule(ABS(error));
+                BSP_PID_SetTarget(&pid_turn, turn_ref);
+                float vrot = TURN_FF_MM_PER_DEG * turn_ref_rate +
+                             BSP_PID_CalcPositionalRate(&pid_turn, yaw, yaw_rate, move_dt);
+                Move_Mix(0, 0, vrot, m);
+                loop_pid = &pid_turn;
+                yaw_ref = turn_ref;
+                break;
+            }
+
+            case MOVE_RELAY_TUNE:
+            {
+                /* 继电器反馈：误差越过回差即翻转输出，回差带内保持 */
+                float error = Move_Wrap_Angle(target_yaw - yaw);
+
+                if (error > relay_hyst)
+                    relay_out = relay_amp;
+                else if (error < -relay_hyst)
+                    relay_out = -relay_amp;
+
+                Move_Mix((relay_loop == MOVE_LOOP_TURN) ? 0 : out_speed, 0, relay_out, m);
                 break;
             }
 
@@ -201,14 +456,9 @@ static void move_proc(void *parameter)
                 continue;
             }
 
-            /* 最终下发底层驱动：将计算出的平滑速度输出给步进电机驱动层 */
+            /* 最终下发底层驱动 */
             if (current_mode != MOVE_STOP)
-            {
-                BSP_Motor_SetSpeed(&motor_1, (int32_t)m1);
-                BSP_Motor_SetSpeed(&motor_2, (int32_t)m2);
-                BSP_Motor_SetSpeed(&motor_3, (int32_t)m3);
-                BSP_Motor_SetSpeed(&motor_4, (int32_t)m4);
-            }
+                Move_Set_Wheels(m);
         }
         else
         {
@@ -219,6 +469,9 @@ static void move_proc(void *parameter)
             BSP_Motor_Stop(&motor_4);
         }
 
+        Move_Telem(m, yaw, yaw_rate, loop_pid, yaw_ref);
+        CCM_BENCH_ADD(&ccm_bench_move, CCM_CYCLES() - loop_t0);
+        TRACE_END("move");
         rt_thread_mdelay(MOVE_CONTROL_TICK);
     }
 }
@@ -232,29 +485,30 @@ static void move_proc(void *parameter)
  */
 int App_Move_Init(void)
 {
-    /* 1. 初始化直线纠偏 PID  */
+    /* 1. 初始化平移航向锁 PID (扩展模式：每拍系数换算为连续域系数) */
     BSP_PID_Init(&pid_yaw,
-                 PID_KP_STRAIGHT,
-                 PID_KI_STRAIGHT,
-                 PID_KD_STRAIGHT,
-                 0,       /* 初始目标角度 */
-                 200.0f); /* 最大修正量幅度限幅 */
+                 g_param.kp_straight,
+                 g_param.ki_straight / MOVE_CONTROL_DT,
+                 g_param.kd_straight * MOVE_CONTROL_DT,
+                 0,                   /* 初始目标角度 */
+                 PID_LIMIT_STRAIGHT); /* 最大修正量幅度限幅 (mm/s) */
+    BSP_PID_SetExtMode(&pid_yaw, PID_D_FILTER_TAU, PID_SLEW_STRAIGHT);
 
     /* [新增] 2. 初始化角度旋转 PID */
     BSP_PID_Init(&pid_turn,
-                 PID_KP_TURN,
-                 PID_KI_TURN,
-                 PID_KD_TURN,
-                 0,       /* 目标角度由 API 设置 */
-                 300.0f); /* 旋转动力限幅 */
+                 g_param.kp_turn,
+                 g_param.ki_turn / MOVE_CONTROL_DT,
+                 g_param.kd_turn * MOVE_CONTROL_DT,
+                 0,               /* 目标角度由 API 设置 */
+                 PID_LIMIT_TURN); /* 旋转修正量限幅 (mm/s) */
+    BSP_PID_SetExtMode(&pid_turn, PID_D_FILTER_TAU, PID_SLEW_TURN);
+    turn_kp_base = pid_turn.kp;
+    turn_ki_base = pid_turn.ki;
+    turn_kd_base = pid_turn.kd;
 
     /* 2. 创建线程 */
-    move_thread = rt_thread_create("move_proc",
-                                   move_proc,
-                                   RT_NULL,
-                                   MOVE_THREAD_STACK_SIZE,
-                                   MOVE_THREAD_PRIORITY,
-                                   MOVE_THREAD_TIMESLICE);
+    move_thread = APP_THREAD_CREATE(move_thread, "move_proc", move_proc, RT_NULL, MOVE_THREAD_PRIORITY,
+                                    MOVE_THREAD_TIMESLICE);
 
     if (move_thread != RT_NULL)
     {
@@ -275,23 +529,62 @@ INIT_APP_EXPORT(App_Move_Init);
  */
 void Move_Now(Move_Mode_t mode, float speed_mm_s, float distance_mm)
 {
-    current_mode = mode;
     target_speed = speed_mm_s;
 
     /* 设置位移目标 */
-    target_pulse_x = (int32_t)(ABS(distance_mm) * PULSE_PER_MM);
+    target_pulse_x = (int32_t)(ABS(distance_mm) * g_param.pulse_per_mm);
 
-    if (mode == MOVE_FORWARD || mode == MOVE_BACKWARD)
+    if (MOVE_IS_TRANSLATE(mode))
     {
-        target_yaw = imu_app_data.yaw;
+        /* 沿用上一段的锁定航向，微调往复多次也不会累积转角；偏离过大时改锁当前航向 */
+        float yaw_now;
+        App_IMU_Get_Heading(&yaw_now, RT_NULL);
+        if (!yaw_hold || ABS(target_yaw - yaw_now) > MOVE_HOLD_MAX_ERR)
+            target_yaw = yaw_now;
+        yaw_hold = 1;
         BSP_PID_SetTarget(&pid_yaw, target_yaw);
     }
+    else
+    {
+        yaw_hold = 0; /* 开环转向后航向已改变 */
+    }
 
     /* 重置里程计 (通过专业 API) */
     BSP_Motor_ResetSteps(&motor_1);
     BSP_Motor_ResetSteps(&motor_2);
     BSP_Motor_ResetSteps(&motor_3);
     BSP_Motor_ResetSteps(&motor_4);
+    move_leg++;
+
+    /* 定距平移 (直行/平移/斜行) 交给联动插补：四轮步数按比例精确分配，同一节拍走完；
+     * 航向锁由运动线程以差速修正叠加 (BSP_Motor_Coord_Trim)。不定距巡航仍走轮速闭环。
+     * 启动插补、move_coord 与模式三者锁调度一起生效：运动线程优先级更高，夹在中间跑一拍
+     * 会拿旧模式走联动分支，或在 MOVE_STOP 分支里把刚启动的插补停掉 */
+    rt_enter_critical();
+    move_coord = 0;
+    if (target_pulse_x > 0 && MOVE_IS_TRANSLATE(mode))
+    {
+        int32_t steps[MOTOR_COORD_AXES];
+        float m[4];
+        float m_max = 0;
+        Move_Mix(move_dir[mode].vx, move_dir[mode].vy, 0, m);
+        for (uint32_t i = 0; i < MOTOR_COORD_AXES; i++)
+        {
+            steps[i] = (int32_t)lrintf(m[i] * (float)target_pulse_x);
+            if (ABS(m[i]) > m_max)
+                m_max = ABS(m[i]);
+        }
+
+        move_coord_speed = ABS(speed_mm_s) * m_max;
+        if (BSP_Motor_Coord_Start(steps, move_trim_dir, move_coord_speed * g_param.pulse_per_mm,
+                                  g_param.move_accel * m_max * g_param.pulse_per_mm) == 0)
+            move_coord = 1;
+    }
+
+    /* 模式最后生效，运动线程不会用设置到一半的状态跑一拍 */
+    App_IMU_Set_Still(0);
+    current_mode = mode;
+    rt_exit_critical();
 }
 
 /**
@@ -299,11 +592,84 @@ void Move_Now(Move_Mode_t mode, float speed_mm_s, float distance_mm)
  */
 void Move_Turn_Abs(float abs_angle)
 {
-    target_yaw = abs_angle;
     target_speed = 0;
     target_pulse_x = 0; // 角度旋转不依赖里程计位移
-    current_mode = MOVE_TURN_ABS;
+
+    /* 以当前连续角为起点，按最短路径换算连续目标角 (避免跨 0/360 绕远路) */
+    float yaw_now;
+    App_IMU_Get_Heading(&yaw_now, RT_NULL);
+    turn_goal = yaw_now + Move_Wrap_Angle(abs_angle - yaw_now);
+    turn_ref = yaw_now;
+    turn_ref_rate = 0;
+
+    /* 转向目标即后续平移段的锁定航向 */
+    target_yaw = turn_goal;
+    yaw_hold = 1;
+
     BSP_PID_Reset(&pid_turn);
+    move_coord = 0;
+    App_IMU_Set_Still(0);
+    current_mode = MOVE_TURN_ABS;
+}
+
+/**
+ * @brief [API] 获取当前运动模式
+ */
+Move_Mode_t Move_Get_Mode(void)
+{
+    return current_mode;
+}
+
+/**
+ * @brief [API] 启动继电器反馈实验
+ */
+void Move_Relay_Start(Move_Loop_t loop, float amp, float hyst, float speed_mm_s, float distance_mm)
+{
+    relay_loop = loop;
+    relay_amp = ABS(amp);
+    relay_hyst = ABS(hyst);
+    relay_out = relay_amp; /* 先向左推，打破静止平衡 */
+
+    App_IMU_Get_Heading(&target_yaw, RT_NULL);
+    yaw_hold = 0; /* 振荡实验结束时航向不确定，不再沿用 */
+    if (loop == MOVE_LOOP_TURN)
+    {
+        target_speed = 0;
+        target_pulse_x = 0;
+    }
+    else
+    {
+        target_speed = speed_mm_s;
+        target_pulse_x = (int32_t)(ABS(distance_mm) * g_param.pulse_per_mm);
+    }
+
+    BSP_Motor_ResetSteps(&motor_1);
+    BSP_Motor_ResetSteps(&motor_2);
+    BSP_Motor_ResetSteps(&motor_3);
+    BSP_Motor_ResetSteps(&motor_4);
+    move_leg++;
+    move_coord = 0;
+    App_IMU_Set_Still(0);
+    current_mode = MOVE_RELAY_TUNE;
+}
+
+/**
+ * @brief [API] 运行时修改航向环 PID 参数 (每拍系数 -> 连续域系数)
+ */
+void Move_Set_Gains(Move_Loop_t loop, float kp, float ki, float kd)
+{
+    PID_t *pid = (loop == MOVE_LOOP_TURN) ? &pid_turn : &pid_yaw;
+
+    BSP_PID_SetParams(pid, kp, ki / MOVE_CONTROL_DT, kd * MOVE_CONTROL_DT);
+    BSP_PID_Reset(pid);
+
+    if (loop == MOVE_LOOP_TURN)
+    {
+        /* 转向环的实际增益由调度表在基准上缩放 */
+        turn_kp_base = pid->kp;
+        turn_ki_base = pid->ki;
+        turn_kd_base = pid->kd;
+    }
 }
 
 /**
@@ -315,6 +681,7 @@ void Move_Stop(void)
     target_speed = 0;
     current_speed = 0;
     target_pulse_x = 0;
+    move_coord = 0;
     BSP_Motor_Stop(&motor_1);
     BSP_Motor_Stop(&motor_2);
     BSP_Motor_Stop(&motor_3);
@@ -15,24 +15,39 @@
 typedef enum
 {
     MOVE_STOP = 0,    /* 强制停止 */
-    MOVE_FORWARD,     /* 前进 (纠偏模式) */
-    MOVE_BACKWARD,    /* 后退 (纠偏模式) */
-    MOVE_SLIDE_LEFT,  /* 左平移 */
-    MOVE_SLIDE_RIGHT, /* 右平移 */
+    MOVE_FORWARD,     /* 前进 (航向锁) */
+    MOVE_BACKWARD,    /* 后退 (航向锁) */
+    MOVE_SLIDE_LEFT,  /* 左平移 (航向锁) */
+    MOVE_SLIDE_RIGHT, /* 右平移 (航向锁) */
+    MOVE_DIAG_FL,     /* 左前 45° 斜行 (航向锁) */
+    MOVE_DIAG_FR,     /* 右前 45° 斜行 (航向锁) */
+    MOVE_DIAG_BL,     /* 左后 45° 斜行 (航向锁) */
+    MOVE_DIAG_BR,     /* 右后 45° 斜行 (航向锁) */
     MOVE_TURN_LEFT,   /* 原地左转 (开环速度控制) */
     MOVE_TURN_RIGHT,  /* 原地右转 (开环速度控制) */
-    MOVE_TURN_ABS     /* 绝对角度旋转 (PID 闭环控制) */
+    MOVE_TURN_ABS,    /* 绝对角度旋转 (PID 闭环控制) */
+    MOVE_RELAY_TUNE   /* 继电器整定实验 (仅供 app_tune_proc 使用) */
 } Move_Mode_t;
 
+/** 航向闭环选择 (整定/改参时使用) */
+typedef enum
+{
+    MOVE_LOOP_STRAIGHT = 0, /* 平移航向锁 pid_yaw */
+    MOVE_LOOP_TURN          /* 原地转向环 pid_turn */
+} Move_Loop_t;
+
 /**
  * @brief  [API] 全方向移动控制接口
  * @param  mode: 运动模式枚举 (@see Move_Mode_t)。
  *               前进: MOVE_FORWARD, 后退: MOVE_BACKWARD,
- *               左平移: MOVE_SLIDE_LEFT, 右平移: MOVE_SLIDE_RIGHT
- * @param  speed_mm_s: 期望运行的目标速度。单位：mm/s (建议范围: 50~350)。
- * @param  distance_mm: 计划运行的位移距离。单位：mm。
+ *               左平移: MOVE_SLIDE_LEFT, 右平移: MOVE_SLIDE_RIGHT,
+ *               斜行: MOVE_DIAG_FL / FR / BL / BR
+ * @param  speed_mm_s: 期望运行的目标速度 (车体合速度)。单位：mm/s (建议范围: 50~350)。
+ * @param  distance_mm: 计划运行的位移距离 (车体路程，由四轮里程正解得到)。单位：mm。
  *                     - 若传入 500.0f : 小车走 50cm 后利用 T 型曲线自动刹停。
  *                     - 若传入 0.0f   : 小车进入巡航模式，持续行驶。
+ * @note   所有平移模式都由 pid_yaw 锁定航向：连续的平移段 (含中途停车) 沿用同一个
+ *         锁定航向，Move_Turn_Abs 之后锁定为转向目标角，因此对位微调不会累积转角。
  */
 void Move_Now(Move_Mode_t mode, float speed_mm_s, float distance_mm);
 
@@ -51,4 +66,24 @@ void Move_Turn_Abs(float abs_angle);
  */
 void Move_Stop(void);
 
+/**
+ * @brief  [API] 获取当前运动模式
+ */
+Move_Mode_t Move_Get_Mode(void);
+
+/**
+ * @brief  [API] 启动继电器反馈实验 (航向围绕当前角度做极限环振荡)
+ * @param  loop: MOVE_LOOP_TURN 原地振荡; MOVE_LOOP_STRAIGHT 边直行边振荡
+ * @param  amp: 继电器输出幅值 (与 PID 输出同单位)
+ * @param  hyst: 继电器回差 (度)
+ * @param  speed_mm_s / distance_mm: 仅 MOVE_LOOP_STRAIGHT 使用，跑完自动停车
+ */
+void Move_Relay_Start(Move_Loop_t loop, float amp, float hyst, float speed_mm_s, float distance_mm);
+
+/**
+ * @brief  [API] 运行时修改航向环 PID 参数
+ * @note   参数单位与 app_param.h 相同 (按 20ms 一拍整定的系数)
+ */
+void Move_Set_Gains(Move_Loop_t loop, float kp, float ki, float kd);
+
 #endif /* __APP_MOVE_PROC_H */
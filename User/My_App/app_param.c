@@ -0,0 +1,437 @@
+/**
+ * @file    app_param.c
+ * @brief   运行时参数表 + 片上 Flash 持久化 (FAL "param" 分区)
+ *
+ * [存储格式]:
+ * 1. 分区由两个 128K 扇区组成，乒乓使用。扇区头 {magic, seq}，seq 大者为当前扇区。
+ * 2. 扇区内为只追加的 8 字节记录 {key, check, value}，同 key 以最后一条为准。
+ * 3. 当前扇区写满时，把全部参数整理写入另一扇区，最后才写扇区头；
+ *    整理中途掉电，旧扇区依然完整有效 (磨损均衡 + 掉电安全)。
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "../My_Driver/bsp_motor.h" /* 须在 fal.h 之前：main.h 的 Error_Handler 声明与 drv_common.h 的同名宏冲突 */
+#include <fal.h>
+#include "app_param.h"
+#include "app_move_proc.h"
+
+#define DBG_TAG "app.param"
+#define DBG_LVL DBG_INFO
+#include <rtdbg.h>
+#include "../Components/log_async.h"
+
+#define PARAM_PART_NAME "param"
+#define PARAM_SECTOR_SIZE (128 * 1024)
+#define PARAM_SECTOR_MAGIC 0x4D524150 /* "PARM" */
+#define PARAM_KEY_EMPTY 0xFFFF
+#define PARAM_READ_CHUNK 256
+
+/* 扇区头 */
+typedef struct
+{
+    uint32_t magic;
+    uint32_t seq;
+} Param_Sector_Hdr_t;
+
+/* 单条参数记录 (8 字节，对齐 Flash 写粒度) */
+typedef struct
+{
+    uint16_t key;
+    uint16_t check;
+    uint32_t value;
+} Param_Record_t;
+
+typedef enum
+{
+    PARAM_TYPE_FLOAT = 0,
+    PARAM_TYPE_INT
+} Param_Type_t;
+
+/* 参数表项 */
+typedef struct
+{
+    const char *name;
+    uint16_t key; /* Flash 中的键，一经发布不可复用 */
+    uint8_t type;
+    void *ptr;               /* 指向 g_param 中的字段 */
+    void (*on_change)(void); /* 修改后的生效回调 (可为空) */
+} Param_Entry_t;
+
+App_Param_t g_param;
+
+static const App_Param_t param_defaults = {
+    .pulse_per_mm = PULSE_PER_MM,
+    .move_accel = MOVE_ACCEL_VAL,
+    .kp_straight = PID_KP_STRAIGHT,
+    .ki_straight = PID_KI_STRAIGHT,
+    .kd_straight = PID_KD_STRAIGHT,
+    .kp_turn = PID_KP_TURN,
+    .ki_turn = PID_KI_TURN,
+    .kd_turn = PID_KD_TURN,
+    .dist_plate = DIST_PLATE,
+    .dist_car = DIST_CAR,
+    .dist_stack = DIST_STACK,
+    .dist_floor = DIST_FLOOR,
+    .plate_red = PLATE_RED,
+    .plate_green = PLATE_GREEN,
+    .plate_blue = PLATE_BLUE,
+};
+
+static void Param_Apply_Straight(void)
+{
+    Move_Set_Gains(MOVE_LOOP_STRAIGHT, g_param.kp_straight, g_param.ki_straight, g_param.kd_straight);
+}
+
+static void Param_Apply_Turn(void)
+{
+    Move_Set_Gains(MOVE_LOOP_TURN, g_param.kp_turn, g_param.ki_turn, g_param.kd_turn);
+}
+
+static const Param_Entry_t param_table[] = {
+    {"pulse_per_mm", 1, PARAM_TYPE_FLOAT, &g_param.pulse_per_mm, RT_NULL},
+    {"move_accel", 2, PARAM_TYPE_FLOAT, &g_param.move_accel, RT_NULL},
+    /* 键 3 (speed_scale) 与 10~15 (旧驱动单位的航向 PID) 已随线性步频驱动退役，勿复用 */
+    {"kp_straight", 40, PARAM_TYPE_FLOAT, &g_param.kp_straight, Param_Apply_Straight},
+    {"ki_straight", 41, PARAM_TYPE_FLOAT, &g_param.ki_straight, Param_Apply_Straight},
+    {"kd_straight", 42, PARAM_TYPE_FLOAT, &g_param.kd_straight, Param_Apply_Straight},
+    {"kp_turn", 43, PARAM_TYPE_FLOAT, &g_param.kp_turn, Param_Apply_Turn},
+    {"ki_turn", 44, PARAM_TYPE_FLOAT, &g_param.ki_turn, Param_Apply_Turn},
+    {"kd_turn", 45, PARAM_TYPE_FLOAT, &g_param.kd_turn, Param_Apply_Turn},
+    {"dist_plate", 20, PARAM_TYPE_INT, &g_param.dist_plate, RT_NULL},
+    {"dist_car", 21, PARAM_TYPE_INT, &g_param.dist_car, RT_NULL},
+    {"dist_stack", 22, PARAM_TYPE_INT, &g_param.dist_stack, RT_NULL},
+    {"dist_floor", 23, PARAM_TYPE_INT, &g_param.dist_floor, RT_NULL},
+    {"plate_red", 30, PARAM_TYPE_INT, &g_param.plate_red, RT_NULL},
+    {"plate_green", 31, PARAM_TYPE_INT, &g_param.plate_green, RT_NULL},
+    {"plate_blue", 32, PARAM_TYPE_INT, &g_param.plate_blue, RT_NULL},
+};
+#define PARAM_COUNT (sizeof(param_table) / sizeof(param_table[0]))
+
+/* Flash 存储状态 */
+static const struct fal_partition *param_part = RT_NULL;
+static int8_t active_sector = -1;         /* 当前扇区 0/1，-1 表示尚未格式化 */
+static uint32_t active_seq = 0;           /* 当前扇区序号 */
+static uint32_t write_offset = 0;         /* 当前扇区下一条记录的偏移 */
+static uint32_t persisted[PARAM_COUNT];   /* 已落盘的值 (用于判定脏数据) */
+
+/* ========================================================================== */
+/*                          1. 内部辅助工具 (Internal Helpers)                  */
+/* ========================================================================== */
+
+static uint32_t Param_Raw_Get(const Param_Entry_t *e)
+{
+    uint32_t raw;
+    memcpy(&raw, e->ptr, sizeof(raw));
+    return raw;
+}
+
+static void Param_Raw_Set(const Param_Entry_t *e, uint32_t raw)
+{
+    memcpy(e->ptr, &raw, sizeof(raw));
+}
+
+static uint16_t Param_Check(uint16_t key, uint32_t value)
+{
+    return (uint16_t)(key ^ (value & 0xFFFF) ^ (value >> 16) ^ 0x5A5A);
+}
+
+static int Param_Find(const char *name)
+{
+    for (uint32_t i = 0; i < PARAM_COUNT; i++)
+    {
+        if (rt_strcmp(param_table[i].name, name) == 0)
+            return (int)i;
+    }
+    return -1;
+}
+
+static int Param_Find_Key(uint16_t key)
+{
+    for (uint32_t i = 0; i < PARAM_COUNT; i++)
+    {
+        if (param_table[i].key == key)
+            return (int)i;
+    }
+    return -1;
+}
+
+/**
+ * @brief  [内部函数] 把值打印为文本 (rt_kprintf 不支持 %f)
+ */
+static void Param_Print(const Param_Entry_t *e)
+{
+    if (e->type == PARAM_TYPE_INT)
+    {
+        rt_kprintf("%-14s %d\n", e->name, *(int32_t *)e->ptr);
+    }
+    else
+    {
+        float v = *(float *)e->ptr;
+        const char *sign = (v < 0) ? "-" : "";
+        if (v < 0)
+            v = -v;
+        int32_t ip = (int32_t)v;
+        int32_t fp = (int32_t)((v - ip) * 10000.0f + 0.5f);
+        if (fp >= 10000)
+        {
+            ip++;
+            fp -= 10000;
+        }
+        rt_kprintf("%-14s %s%d.%04d\n", e->name, sign, ip, fp);
+    }
+}
+
+/**
+ * @brief  [内部函数] 回放一个扇区内的全部记录到 RAM 缓存
+ */
+static void Param_Replay(int8_t sector)
+{
+    uint32_t base = (uint32_t)sector * PARAM_SECTOR_SIZE;
+    Param_Record_t buf[PARAM_READ_CHUNK / sizeof(Param_Record_t)];
+    uint32_t off = sizeof(Param_Sector_Hdr_t);
+
+    while (off < PARAM_SECTOR_SIZE)
+    {
+        uint32_t len = PARAM_SECTOR_SIZE - off;
+        if (len > sizeof(buf))
+            len = sizeof(buf);
+        if (fal_partition_read(param_part, base + off, (uint8_t *)buf, len) < 0)
+            break;
+
+        for (uint32_t i = 0; i < len / sizeof(Param_Record_t); i++)
+        {
+            if (buf[i].key == PARAM_KEY_EMPTY)
+            {
+                write_offset = off + i * sizeof(Param_Record_t);
+                return;
+            }
+            if (buf[i].check != Param_Check(buf[i].key, buf[i].value))
+                continue; /* 掉电写坏的记录，跳过 */
+
+            int idx = Param_Find_Key(buf[i].key);
+            if (idx >= 0)
+            {
+                Param_Raw_Set(&param_table[idx], buf[i].value);
+                persisted[idx] = buf[i].value;
+            }
+        }
+        off += len;
+    }
+    write_offset = PARAM_SECTOR_SIZE;
+}
+
+/**
+ * @brief  [内部函数] 追加一条记录到当前扇区
+ * @param  value: 输出，写入的值 (由调用方在确认生效后记入 persisted[])
+ */
+static rt_err_t Param_Append(uint32_t idx, uint32_t *value)
+{
+    Param_Record_t rec;
+    rec.key = param_table[idx].key;
+    rec.value = Param_Raw_Get(&param_table[idx]);
+    rec.check = Param_Check(rec.key, rec.value);
+
+    uint32_t addr = (uint32_t)active_sector * PARAM_SECTOR_SIZE + write_offset;
+    if (fal_partition_write(param_part, addr, (const uint8_t *)&rec, sizeof(rec)) < 0)
+        return -RT_ERROR;
+
+    write_offset += sizeof(rec);
+    *value = rec.value;
+    return RT_EOK;
+}
+
+/**
+ * @brief  [内部函数] 整理：全部参数写入另一扇区，最后写扇区头完成切换
+ * @note   扇区头写成功之前旧扇区仍然有效，persisted[] 与写指针都保持旧扇区的状态，
+ *         失败后下次 Param_Save 会把这些参数重新当作脏数据。
+ *         擦扇区期间 Flash 取指停顿上百毫秒，步进比较中断跟着停，电机在转时拒绝整理
+ */
+static rt_err_t Param_Compact(void)
+{
+    int8_t target = (active_sector == 0) ? 1 : 0;
+    uint32_t base = (uint32_t)target * PARAM_SECTOR_SIZE;
+    uint32_t staged[PARAM_COUNT];
+
+    if (BSP_Motor_Busy())
+    {
+        LOG_W("Motors running, sector erase deferred.");
+        return -RT_EBUSY;
+    }
+
+    if (fal_partition_erase(param_part, base, PARAM_SECTOR_SIZE) < 0)
+        return -RT_ERROR;
+
+    int8_t old_sector = active_sector;
+    uint32_t old_offset = write_offset;
+    active_sector = target;
+    write_offset = sizeof(Param_Sector_Hdr_t);
+    rt_err_t ret = RT_EOK;
+    for (uint32_t i = 0; i < PARAM_COUNT && ret == RT_EOK; i++)
+        ret = Param_Append(i, &staged[i]);
+
+    Param_Sector_Hdr_t hdr = {PARAM_SECTOR_MAGIC, active_seq + 1};
+    if (ret == RT_EOK && fal_partition_write(param_part, base, (const uint8_t *)&hdr, sizeof(hdr)) < 0)
+        ret = -RT_ERROR;
+
+    if (ret != RT_EOK)
+    {
+        active_sector = old_sector;
+        write_offset = old_offset;
+        return ret;
+    }
+
+    active_seq = hdr.seq;
+    rt_memcpy(persisted, staged, sizeof(persisted));
+    LOG_I("Param sector %d compacted (seq %d).", target, active_seq);
+    return RT_EOK;
+}
+
+/* ========================================================================== */
+/*                          2. 外部暴露接口库 (Public API)                      */
+/* ========================================================================== */
+
+/**
+ * @brief  [API] 参数系统初始化
+ */
+int App_Param_Init(void)
+{
+    g_param = param_defaults;
+    for (uint32_t i = 0; i < PARAM_COUNT; i++)
+        persisted[i] = 0xFFFFFFFF; /* 尚未落盘 */
+
+    fal_init();
+    param_part = fal_partition_find(PARAM_PART_NAME);
+    if (param_part == RT_NULL)
+    {
+        LOG_E("Partition '%s' not found, using defaults.", PARAM_PART_NAME);
+        return -RT_ERROR;
+    }
+
+    /* 选出 seq 最大的有效扇区 */
+    for (int8_t s = 0; s < 2; s++)
+    {
+        Param_Sector_Hdr_t hdr;
+        if (fal_partition_read(param_part, (uint32_t)s * PARAM_SECTOR_SIZE, (uint8_t *)&hdr, sizeof(hdr)) < 0)
+            continue;
+        if (hdr.magic != PARAM_SECTOR_MAGIC || hdr.seq == 0xFFFFFFFF)
+            continue;
+        if (active_sector < 0 || hdr.seq > active_seq)
+        {
+            active_sector = s;
+            active_seq = hdr.seq;
+        }
+    }
+
+    if (active_sector >= 0)
+    {
+        Param_Replay(active_sector);
+        LOG_I("Params loaded from sector %d (seq %d, %d bytes used).", active_sector, active_seq, write_offset);
+    }
+    else
+    {
+        LOG_I("No saved params, using defaults.");
+    }
+    return RT_EOK;
+}
+INIT_ENV_EXPORT(App_Param_Init);
+
+/**
+ * @brief  [API] 把修改过的参数写入 Flash
+ */
+rt_err_t Param_Save(void)
+{
+    if (param_part == RT_NULL)
+        return -RT_ERROR;
+
+    uint32_t dirty = 0;
+    for (uint32_t i = 0; i < PARAM_COUNT; i++)
+    {
+        if (Param_Raw_Get(&param_table[i]) != persisted[i])
+            dirty++;
+    }
+    if (dirty == 0)
+        return RT_EOK;
+
+    /* 未格式化或空间不足：整理到另一扇区 (整理本身就会写入全部参数) */
+    if (active_sector < 0 || write_offset + dirty * sizeof(Param_Record_t) > PARAM_SECTOR_SIZE)
+        return Param_Compact();
+
+    for (uint32_t i = 0; i < PARAM_COUNT; i++)
+    {
+        if (Param_Raw_Get(&param_table[i]) != persisted[i])
+        {
+            uint32_t value;
+            if (Param_Append(i, &value) != RT_EOK)
+                return -RT_ERROR;
+            persisted[i] = value; /* 记录已在生效扇区里 */
+        }
+    }
+    return RT_EOK;
+}
+
+/**
+ * @brief  msh 命令: param list | get <name> | set <name> <value> | save | reset
+ */
+static void param(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        rt_kprintf("Usage: param list | get <name> | set <name> <value> | save | reset\n");
+        return;
+    }
+
+    if (rt_strcmp(argv[1], "list") == 0)
+    {
+        for (uint32_t i = 0; i < PARAM_COUNT; i++)
+            Param_Print(&param_table[i]);
+    }
+    else if (rt_strcmp(argv[1], "get") == 0 && argc > 2)
+    {
+        int idx = Param_Find(argv[2]);
+        if (idx < 0)
+            rt_kprintf("Unknown param: %s\n", argv[2]);
+        else
+            Param_Print(&param_table[idx]);
+    }
+    else if (rt_strcmp(argv[1], "set") == 0 && argc > 3)
+    {
+        int idx = Param_Find(argv[2]);
+        if (idx < 0)
+        {
+            rt_kprintf("Unknown param: %s\n", argv[2]);
+            return;
+        }
+
+        const Param_Entry_t *e = &param_table[idx];
+        if (e->type == PARAM_TYPE_INT)
+            *(int32_t *)e->ptr = (int32_t)atol(argv[3]);
+        else
+            *(float *)e->ptr = (float)atof(argv[3]);
+
+        if (e->on_change)
+            e->on_change();
+        Param_Print(e);
+    }
+    else if (rt_strcmp(argv[1], "save") == 0)
+    {
+        if (Move_Get_Mode() != MOVE_STOP)
+        {
+            rt_kprintf("Chassis busy, stop before saving.\n");
+            return;
+        }
+        rt_kprintf("Save %s\n", (Param_Save() == RT_EOK) ? "OK" : "FAILED");
+    }
+    else if (rt_strcmp(argv[1], "reset") == 0)
+    {
+        g_param = param_defaults;
+        Param_Apply_Straight();
+        Param_Apply_Turn();
+        rt_kprintf("Params reset to defaults (run 'param save' to persist).\n");
+    }
+    else
+    {
+        rt_kprintf("Bad arguments.\n");
+    }
+}
+MSH_CMD_EXPORT(param, runtime params: param list|get|set|save|reset);
@@ -3,6 +3,8 @@
  * @brief   全局参数与常量定义 (项目“军火库”)
  * @note    [说明]: 统一使用 mm (毫米) 和 mm/s 作为单位。
  *          所有旋转相关的目标均基于“发车初始零度”为基推算。
+ *          带 [可存储] 标记的宏只是出厂默认值，运行时以 g_param 为准，
+ *          可通过 msh `param set/save` 在线修改并写入片上 Flash。
  */
 
 #ifndef __APP_PARAM_H
@@ -14,7 +16,7 @@
 /*                          1. 基础物理参数 (Basic)                             */
 /* ========================================================================== */
 
-/** [必调] 每毫米对应的脉冲数
+/** [必调][可存储] 每毫米对应的脉冲数
  *  原理说明：(电机转一圈脉冲数 / 3.14159 * 轮径)
  *  修正方法：命令车走 1000mm，实测走了 1010mm，则减小此值。 */
 #define PULSE_PER_MM 15.6f
@@ -24,27 +26,62 @@
 /* ========================================================================== */
 
 /* --- T型加减速规划 (T-Curve) --- */
-/** T型加速斜率 (mm/s^2)
- *  作用：数值越大起步越猛 */
-#define MOVE_ACCEL_VAL 200.0f
-
-/* --- 麦轮极简控制映射 (Simplified mapping) --- */
-/** 驱动器速度比例系数
- *  由于电机驱动接收 -10000 到 10000 的频率单位，此系数将你的 mm/s 转换为频率。
- *  设置建议：如果给 300mm/s 感觉还没动，就调大此值。 */
-#define MOVE_SPEED_SCALE 286.0f
-
-/* --- 直线行走逻辑 (航向锁 PID) --- */
-#define PID_KP_STRAIGHT 1.9f 
-#define PID_KI_STRAIGHT 0.01f
-#define PID_KD_STRAIGHT 0.5f
-
-/* --- 旋转转弯逻辑 (位置环 PID) --- */
-#define PID_KP_TURN 3.9f 
-#define PID_KI_TURN 0.02f
-#define PID_KD_TURN 1.2f
+/** [可存储] T型加速斜率 (mm/s^2)
+ *  作用：数值越大起步越猛。驱动层已逐步平滑，不再受 20ms 台阶丢步限制 (原为 200) */
+#define MOVE_ACCEL_VAL 500.0f
+
+/** 航向锁沿用上限 (度)：新平移段开始时，若当前航向偏离锁定航向超过此值
+ *  (例如开环转向或被外力推动)，放弃旧的锁定航向，改为锁定当前航向 */
+#define MOVE_HOLD_MAX_ERR 5.0f
+
+/** 电机驱动逐步斜坡的加速度上限 (mm/s^2)
+ *  作用：中断里按此加速度把轮速平滑地逼近运动层给出的目标，须大于 MOVE_ACCEL_VAL
+ *  与转向前馈所需 (TURN_ACCEL * TURN_FF_MM_PER_DEG)，否则轮速跟不上规划 */
+#define MOTOR_RAMP_ACCEL 3000.0f
+
+/* --- 航向纠偏单位说明 ---
+ * 电机驱动直接接收步频 (步/s)，运动层按 pulse_per_mm 线性换算，
+ * 因此下列 PID 的输出均为轮速修正量 (mm/s)，KP 的单位为 (mm/s)/度。 */
+
+/* --- 直线行走逻辑 (航向锁 PID) [可存储] --- */
+#define PID_KP_STRAIGHT 8.0f
+#define PID_KI_STRAIGHT 0.05f
+#define PID_KD_STRAIGHT 2.0f
+#define PID_LIMIT_STRAIGHT 100.0f /* 纠偏量限幅 (mm/s) */
+
+/* --- 旋转转弯逻辑 (位置环 PID) [可存储] --- */
+#define PID_KP_TURN 15.0f
+#define PID_KI_TURN 0.1f
+#define PID_KD_TURN 3.0f
+#define PID_LIMIT_TURN 200.0f     /* 跟踪修正量限幅 (mm/s)，不含前馈 */
 #define TURN_ERROR_THRESHOLD 1.5f /* 容差角度 (度) */
 
+/* --- 转向轨迹规划 (参考角时间最优曲线) --- */
+/** 参考角最大角速度 (度/s)：越大转得越快，过大则 pid_turn 跟不上而饱和 */
+#define TURN_RATE_MAX 180.0f
+/** 参考角角加速度 (度/s^2)：决定起转与刹停的猛烈程度 */
+#define TURN_ACCEL 360.0f
+/** 转向速度前馈 (mm/s 每 度/s)：原地旋转时轮速 = (Lx + Ly) * 角速度(rad/s)
+ *  按轮距 + 轴距半和 200mm 计算：200 * PI / 180 */
+#define TURN_FF_MM_PER_DEG 3.49f
+
+/* --- PID 扩展模式 (时间感知) --- */
+/** 上面的 KI/KD 按 20ms 一拍整定，运动线程会按实测 dt 自动换算为连续域系数。
+ *  D 项滤波时间常数 (s)：越大越平滑，但相位滞后越多。
+ *  航向环的 D 项已直接取陀螺角速度 (BSP_PID_CalcPositionalRate)，此滤波只在差分求导时生效 */
+#define PID_D_FILTER_TAU 0.04f
+/** 修正量输出斜率限制 (mm/s 每秒)：限制纠偏量突变，0 表示不限 */
+#define PID_SLEW_STRAIGHT 1000.0f
+#define PID_SLEW_TURN 2000.0f
+
+/* --- 航向估计 (陀螺积分 + 0x53 绝对角互补滤波) --- */
+/** 互补滤波时间常数 (s)：越大越相信陀螺 (滞后小、无量化台阶)，越小越快被绝对角拉回 (抑制漂移) */
+#define YAW_EST_TAU 0.3f
+/** 静止学习时间常数 (s)：底盘停稳期间学习陀螺零偏与角度漂移率，静止累计超过此时长后才在运动中外推漂移 */
+#define YAW_EST_LEARN_TAU 10.0f
+/** 停车后等待车身停稳的时间 (ms)，之后的 IMU 数据才作为静止样本 */
+#define IMU_STILL_SETTLE_MS 300
+
 /* ========================================================================== */
 /*                          3. 舵机预设角度 (app_task)                         */
 /* ========================================================================== */
@@ -52,13 +89,70 @@
 #define CLAW_OPEN 10  /* 爪子：张开角度 (由 30 改为 10) */
 #define CLAW_CLOSE 60 /* 爪子：闭合角度 */
 
+/* [可存储] */
 #define PLATE_RED 17    /* 转盘：位置1 */
 #define PLATE_GREEN 105 /* 转盘：位置2 */
 #define PLATE_BLUE 200  /* 转盘：位置3 */
 
+/* --- 视觉请求 (见 app_vision_proc.h) --- */
+#define VISION_FPS_TRACK 30 /* 等色 / 对位时的帧率 */
+#define VISION_FPS_IDLE 5   /* 行驶途中只给遥测看 */
+/* 对位区域：以瞄准点 (160,140) 为中心，只是给相机的提示；区域内等不到目标时自动改看全画面 */
+#define VISION_ROI_RING_X0 60
+#define VISION_ROI_RING_Y0 40
+#define VISION_ROI_RING_X1 260
+#define VISION_ROI_RING_Y1 239
+
+/** 升降电机步频 (步/s)：沿用旧驱动 SetSpeed(5000) 的实际翻转频率 */
+#define ARM_LIFT_RATE 192.0f
+
+/* --- 机械臂下降距离 (脉冲数，从最高点 HOME 向下) [可存储] --- */
+#define DIST_PLATE 8000  /* 到原料区(货架)下降距离 */
+#define DIST_CAR 4000    /* 到车内转盘下降距离 */
+#define DIST_STACK 10000 /* 到暂存区二层(码垛)下降距离 */
+#define DIST_FLOOR 15000 /* 到地面(加工区/暂存一层)下降距离 */
+
 /* ========================================================================== */
 /*                        4. 任务状态枚举 (Task Flow)                           */
 /* ========================================================================== */
 /* (已移动至 app_task_proc.h 统一管理) */
 
+/* ========================================================================== */
+/*                     5. 运行时参数表 (Flash 持久化, app_param.c)              */
+/* ========================================================================== */
+
+/**
+ * @brief 运行时参数 RAM 缓存
+ * @note  热路径直接读字段 (零开销)；上电时先填默认值，再用 Flash 中的记录覆盖。
+ */
+typedef struct
+{
+    /* 运动 */
+    float pulse_per_mm;
+    float move_accel;
+
+    /* 航向 PID (每拍系数，与上方宏同单位：mm/s 每度) */
+    float kp_straight, ki_straight, kd_straight;
+    float kp_turn, ki_turn, kd_turn;
+
+    /* 机械臂 */
+    int32_t dist_plate, dist_car, dist_stack, dist_floor;
+    int32_t plate_red, plate_green, plate_blue;
+} App_Param_t;
+
+extern App_Param_t g_param;
+
+/**
+ * @brief  [API] 参数系统初始化 (加载默认值 + Flash 记录)
+ * @note   INIT_ENV_EXPORT 自动调用，早于各 App 线程初始化
+ */
+int App_Param_Init(void);
+
+/**
+ * @brief  [API] 把修改过的参数写入 Flash
+ * @return RT_EOK 成功
+ * @note   扇区写满时会整理并擦除 128K 扇区 (约 1~2s，期间 CPU 取指停顿)，务必在停车时调用。
+ */
+rt_err_t Param_Save(void);
+
 #endif /* __APP_PARAM_H */
@@ -1,10 +1,16 @@
 /**
  * @file    app_qr_proc.c
  * @brief   二维码识别处理任务 (Pure MQ 模式)
+ *
+ * [边走边扫]:
+ * 扫码相机在码进入视野期间会反复上报。每次读数先校验格式 ddd+ddd (每组是 1/2/3 的一个排列)，
+ * 合格的按内容计票；某个内容票数达到 QR_VOTE_MIN 且领先第二名 QR_VOTE_MARGIN 票就锁定，
+ * 只往 qr_result_mq 投一次。大脑不必停在扫码点等，底盘到达时结果通常早已锁定。
  */
 
 #include "app_qr_proc.h"
 #include "app_task_proc.h"
+#include "app_static.h"
 #include "../My_Driver/bsp_uart.h"
 #include <string.h>
 
@@ -12,32 +18,228 @@
 #define QR_PRIORITY 12
 #define QR_TICK 5
 
+#define QR_CODE_LEN 7    /* "ddd+ddd" */
+#define QR_VOTE_SLOTS 4  /* 同时记票的不同内容数 */
+#define QR_VOTE_MIN 3    /* 锁定所需最少票数 */
+#define QR_VOTE_MARGIN 2 /* 锁定所需领先票数 */
+
+typedef struct
+{
+    char code[QR_CODE_LEN + 1];
+    uint16_t votes;
+} QR_Vote_t;
+
 /* 核心通信资源 */
 rt_mq_t qr_mq = RT_NULL;            /* 内部同步：中断 -> 线程 */
 rt_mq_t qr_result_mq = RT_NULL;     /* 任务直投：线程 -> 大脑 (Pure MQ) */
-rt_mutex_t qr_data_mutex = RT_NULL; // 暂时保留句柄以防其他处引用，但不再初始化/使用
+rt_mutex_t qr_data_mutex = RT_NULL; /* 保护计票表 (qr 线程计票 / 大脑取结果) */
 
 static rt_thread_t qr_thread = RT_NULL;
+APP_THREAD_DEFINE(qr_thread, QR_STACK_SIZE);
+APP_MQ_DEFINE(qr_mq, sizeof(Frame_t *), 5);
+APP_MQ_DEFINE(qr_result_mq, sizeof(QR_Task_Msg_t), 2); /* 每轮采集只投一次 */
+APP_MUTEX_DEFINE(qr_data_mutex);
+
+/* 采集状态 (持有 qr_data_mutex 访问) */
+static QR_Vote_t qr_votes[QR_VOTE_SLOTS];
+static rt_bool_t qr_armed = RT_FALSE;   /* QR_Acquire_Start 之后才计票 */
+static rt_bool_t qr_latched = RT_FALSE; /* 本轮结果已锁定 */
+static QR_Task_Msg_t qr_result;
+static uint32_t qr_reads = 0;  /* 本轮合格读数 */
+static uint32_t qr_reject = 0; /* 本轮格式不合格的读数 */
+static rt_tick_t qr_start_tick = 0;
+static rt_tick_t qr_latch_tick = 0;
+
+/**
+ * @brief  [内部函数] 一组三位是否为 1/2/3 的排列
+ */
+static rt_bool_t QR_Is_Perm(const uint8_t *p)
+{
+    uint8_t seen = 0;
+    for (int k = 0; k < 3; k++)
+    {
+        if (p[k] < '1' || p[k] > '3')
+            return RT_FALSE;
+        seen |= 1u << (p[k] - '1');
+    }
+    return seen == 0x07;
+}
+
+/**
+ * @brief  [内部函数] 在一次读数里找合格的 "ddd+ddd"
+ * @param  code: 输出，QR_CODE_LEN 字节 + 结束符
+ * @return RT_TRUE: 找到
+ */
+static rt_bool_t QR_Validate(const uint8_t *data, uint16_t len, char *code)
+{
+    for (int i = 0; i + QR_CODE_LEN <= len; i++)
+    {
+        if (data[i + 3] == '+' && QR_Is_Perm(&data[i]) && QR_Is_Perm(&data[i + 4]))
+        {
+            rt_memcpy(code, &data[i], QR_CODE_LEN);
+            code[QR_CODE_LEN] = '\0';
+            return RT_TRUE;
+        }
+    }
+    return RT_FALSE;
+}
+
+/**
+ * @brief  [内部函数] 票数最多与第二多的槽位
+ * @return 第一名下标，没有票返回 -1
+ */
+static int QR_Vote_Leader(uint16_t *runner_up)
+{
+    int best = -1;
+    uint16_t second = 0;
+
+    for (int k = 0; k < QR_VOTE_SLOTS; k++)
+    {
+        if (qr_votes[k].votes == 0)
+            continue;
+        if (best < 0 || qr_votes[k].votes > qr_votes[best].votes)
+        {
+            if (best >= 0)
+                second = qr_votes[best].votes;
+            best = k;
+        }
+        else if (qr_votes[k].votes > second)
+        {
+            second = qr_votes[k].votes;
+        }
+    }
+    *runner_up = second;
+    return best;
+}
+
+/**
+ * @brief  [内部函数] 锁定结果 (调用方持有 qr_data_mutex)
+ */
+static void QR_Latch(const char *code)
+{
+    rt_memset(qr_result.content, 0, sizeof(qr_result.content));
+    rt_memcpy(qr_result.content, code, QR_CODE_LEN);
+    qr_latched = RT_TRUE;
+    qr_latch_tick = rt_tick_get();
+}
+
+/**
+ * @brief  [内部函数] 记一票 (调用方持有 qr_data_mutex)
+ * @return RT_TRUE: 本票使结果锁定
+ */
+static rt_bool_t QR_Vote(const char *code)
+{
+    int slot = -1, weakest = 0;
+
+    for (int k = 0; k < QR_VOTE_SLOTS; k++)
+    {
+        if (qr_votes[k].votes > 0 && rt_strcmp(qr_votes[k].code, code) == 0)
+        {
+            slot = k;
+            break;
+        }
+        if (qr_votes[k].votes < qr_votes[weakest].votes)
+            weakest = k;
+    }
+    if (slot < 0)
+    {
+        /* 新内容顶掉票数最少的槽 (空槽票数为 0，优先被用) */
+        slot = weakest;
+        rt_memcpy(qr_votes[slot].code, code, QR_CODE_LEN + 1);
+        qr_votes[slot].votes = 0;
+    }
+    qr_votes[slot].votes++;
+
+    uint16_t second;
+    int best = QR_Vote_Leader(&second);
+    if (best >= 0 && qr_votes[best].votes >= QR_VOTE_MIN && qr_votes[best].votes - second >= QR_VOTE_MARGIN)
+    {
+        QR_Latch(qr_votes[best].code);
+        return RT_TRUE;
+    }
+    return RT_FALSE;
+}
 
 /**
- * @brief  二维码数据打包与投递 (Pure MQ 模式)
+ * @brief  二维码读数校验、计票，锁定后投递 (Pure MQ 模式)
  */
 static void QR_Parse(uint8_t *data, uint16_t len)
 {
-    if (len >= 3)
+    char code[QR_CODE_LEN + 1];
+    rt_bool_t valid = QR_Validate(data, len, code);
+    rt_bool_t latched = RT_FALSE;
+
+    rt_mutex_take(qr_data_mutex, RT_WAITING_FOREVER);
+    if (qr_armed && !qr_latched)
     {
-        QR_Task_Msg_t msg;
-        rt_memset(msg.content, 0, sizeof(msg.content));
+        if (!valid)
+        {
+            qr_reject++;
+        }
+        else
+        {
+            qr_reads++;
+            latched = QR_Vote(code);
+        }
+    }
+    rt_mutex_release(qr_data_mutex);
+
+    /* 核心动作：锁定的结果投递到大脑信箱，每轮只投一次 */
+    if (latched)
+        rt_mq_send(qr_result_mq, &qr_result, sizeof(qr_result));
+}
 
-        /* 数据脱壳：将原始字节拷贝入包裹 */
-        rt_memcpy(msg.content, data, (len < 15) ? len : 15);
+/**
+ * @brief  开始新一轮采集：清空计票与未取走的结果
+ */
+void QR_Acquire_Start(void)
+{
+    QR_Task_Msg_t stale;
+
+    rt_mutex_take(qr_data_mutex, RT_WAITING_FOREVER);
+    rt_memset(qr_votes, 0, sizeof(qr_votes));
+    qr_latched = RT_FALSE;
+    qr_reads = 0;
+    qr_reject = 0;
+    qr_start_tick = rt_tick_get();
+    qr_armed = RT_TRUE;
+    while (rt_mq_recv(qr_result_mq, &stale, sizeof(stale), 0) == RT_EOK)
+        ;
+    rt_mutex_release(qr_data_mutex);
+}
 
-        /* 核心动作：投递包裹到大脑信箱 (不加锁，直接寄信) */
-        if (rt_mq_send(qr_result_mq, &msg, sizeof(msg)) == RT_EOK)
+/**
+ * @brief  取本轮结果
+ * @param  timeout: 等待锁定的时长 (tick)；超时后退而取得票最多的合格读数
+ * @return RT_EOK: msg 有效; -RT_ETIMEOUT: 一次合格读数都没有
+ */
+rt_err_t QR_Acquire_Get(QR_Task_Msg_t *msg, rt_int32_t timeout)
+{
+    if (rt_mq_recv(qr_result_mq, msg, sizeof(*msg), timeout) == RT_EOK)
+        return RT_EOK;
+
+    rt_err_t ret = -RT_ETIMEOUT;
+    rt_mutex_take(qr_data_mutex, RT_WAITING_FOREVER);
+    if (qr_latched)
+    {
+        /* 刚好在超时之后锁定：结果已在队列里 */
+        rt_mq_recv(qr_result_mq, msg, sizeof(*msg), 0);
+        *msg = qr_result;
+        ret = RT_EOK;
+    }
+    else
+    {
+        uint16_t second;
+        int best = QR_Vote_Leader(&second);
+        if (best >= 0)
         {
-            /* 发送成功，大脑端的 mq_recv 会立刻被唤醒并拿到数据副本 */
+            QR_Latch(qr_votes[best].code);
+            *msg = qr_result;
+            ret = RT_EOK;
         }
     }
+    rt_mutex_release(qr_data_mutex);
+    return ret;
 }
 
 /**
@@ -47,11 +249,12 @@ static void qr_proc(void *parameter)
 {
     while (1)
     {
-        uint32_t rx_len;
-        /* 1. 等待串口接收信号 */
-        if (rt_mq_recv(qr_mq, &rx_len, sizeof(rx_len), RT_WAITING_FOREVER) == RT_EOK)
+        Frame_t *f;
+        /* 1. 等待串口帧 (块指针)，解析完归还 */
+        if (rt_mq_recv(qr_mq, &f, sizeof(f), RT_WAITING_FOREVER) == RT_EOK)
         {
-            QR_Parse(uart1_qr.rx_buffer, (uint16_t)rx_len);
+            QR_Parse(f->data, f->len);
+            Frame_Free(f);
         }
     }
 }
@@ -62,21 +265,18 @@ static void qr_proc(void *parameter)
 int App_QR_Init(void)
 {
     /* 1. 创建内部唤醒队列 */
-    qr_mq = rt_mq_create("mq_qr", sizeof(uint32_t), 5, RT_IPC_FLAG_FIFO);
+    qr_mq = APP_MQ_CREATE(qr_mq, "mq_qr", RT_IPC_FLAG_FIFO);
 
-    /* 2. 创建大脑结果投递队列 (存2个包，循环覆盖) */
-    qr_result_mq = rt_mq_create("mq_res", sizeof(QR_Task_Msg_t), 2, RT_IPC_FLAG_FIFO);
+    /* 2. 创建大脑结果投递队列与计票锁 */
+    qr_result_mq = APP_MQ_CREATE(qr_result_mq, "mq_res", RT_IPC_FLAG_FIFO);
+    qr_data_mutex = APP_MUTEX_CREATE(qr_data_mutex, "mtx_qr", RT_IPC_FLAG_PRIO);
 
     /* 3. 创建处理线程 */
-    qr_thread = rt_thread_create("qr_proc",
-                                 qr_proc,
-                                 RT_NULL,
-                                 QR_STACK_SIZE,
-                                 QR_PRIORITY,
-                                 QR_TICK);
-
-    if (qr_thread != RT_NULL && qr_mq != RT_NULL && qr_result_mq != RT_NULL)
+    qr_thread = APP_THREAD_CREATE(qr_thread, "qr_proc", qr_proc, RT_NULL, QR_PRIORITY, QR_TICK);
+
+    if (qr_thread != RT_NULL && qr_mq != RT_NULL && qr_result_mq != RT_NULL && qr_data_mutex != RT_NULL)
     {
+        BSP_UART_Init(&uart1_qr);
         rt_thread_startup(qr_thread);
         return 0;
     }
@@ -84,3 +284,22 @@ int App_QR_Init(void)
 }
 
 INIT_APP_EXPORT(App_QR_Init);
+
+/**
+ * @brief  msh 命令：本轮扫码采集的计票情况
+ */
+static void qr(int argc, char **argv)
+{
+    rt_mutex_take(qr_data_mutex, RT_WAITING_FOREVER);
+    rt_kprintf("armed %u, reads %u, rejected %u\n", qr_armed, (unsigned)qr_reads, (unsigned)qr_reject);
+    for (int k = 0; k < QR_VOTE_SLOTS; k++)
+    {
+        if (qr_votes[k].votes)
+            rt_kprintf("  %s  %u votes\n", qr_votes[k].code, qr_votes[k].votes);
+    }
+    if (qr_latched)
+        rt_kprintf("latched %s after %u ms\n", qr_result.content,
+                   (unsigned)((qr_latch_tick - qr_start_tick) * 1000 / RT_TICK_PER_SECOND));
+    rt_mutex_release(qr_data_mutex);
+}
+MSH_CMD_EXPORT(qr, QR acquisition votes and latched result);
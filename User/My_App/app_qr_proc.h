@@ -16,7 +16,7 @@ typedef struct
     char content[16]; /* 任务字符串，例如 "123+231" */
 } QR_Task_Msg_t;
 
-extern rt_mq_t qr_result_mq; /* 核心队列：扫码结果直投位 */
+extern rt_mq_t qr_result_mq; /* 核心队列：扫码结果直投位 (每轮锁定后投一次) */
 extern rt_mq_t qr_mq;        /* 内部队列：ISR -> 线程 */
 
 /**
@@ -25,4 +25,16 @@ extern rt_mq_t qr_mq;        /* 内部队列：ISR -> 线程 */
  */
 int App_QR_Init(void);
 
+/**
+ * @brief  [API] 开始一轮扫码采集 (清空计票)，之后边走边扫，读数够多且一致时自动锁定
+ */
+void QR_Acquire_Start(void);
+
+/**
+ * @brief  [API] 取本轮扫码结果 (内容为校验过的 "ddd+ddd")
+ * @param  timeout: 等待锁定的时长 (tick)，0 表示只看当前；超时后退而取得票最多的合格读数
+ * @return RT_EOK: msg 有效; -RT_ETIMEOUT: 还没有任何合格读数
+ */
+rt_err_t QR_Acquire_Get(QR_Task_Msg_t *msg, rt_int32_t timeout);
+
 #endif /* __APP_QR_PROC_H */
@@ -0,0 +1,113 @@
+/**
+ ******************************************************************************
+ * @file    app_static.h
+ * @author  lingxing
+ * @brief   应用线程 / 消息队列 / 互斥量 / 内存池的静态分配开关
+ ******************************************************************************
+ * @usage 使用说明:
+ * 1. 文件作用域定义存储，Init 里用对应的 CREATE 拿句柄 (失败返回 RT_NULL，与 rt_xxx_create 一致)：
+ *      APP_THREAD_DEFINE(imu_thread, IMU_STACK_SIZE);
+ *      APP_MQ_DEFINE(imu_mq, sizeof(Frame_t *), 10);
+ *      APP_MUTEX_DEFINE(imu_data_mutex);
+ *      ...
+ *      imu_mq = APP_MQ_CREATE(imu_mq, "mq_imu", RT_IPC_FLAG_FIFO);
+ *      imu_thread = APP_THREAD_CREATE(imu_thread, "imu_proc", imu_proc, RT_NULL, IMU_PRIORITY, IMU_TICK);
+ * 2. APP_STATIC_ALLOC = 1 (默认)：控制块、栈、消息池全部放进 .bss.app_static 段，
+ *    启动不再向堆申请，总量在链接时就确定；链接脚本检查剩余给堆的 RAM 不低于
+ *    _heap_min_size，超了直接链接失败而不是上电后 create 返回空。
+ *    APP_STATIC_ALLOC = 0：退回 rt_xxx_create，从堆分配 (便于对比内存占用)。
+ *    内存池同理：APP_MP_DEFINE(frame_mp, sizeof(Frame_t), 16);  frame_mp = APP_MP_CREATE(frame_mp, "mp_frm");
+ * 3. APP_THREAD_DEFINE_CCM：控制块与栈放 CCM (见 bsp_ccm.h)，只给栈上没有 DMA 缓冲的热点线程用。
+ ******************************************************************************
+ */
+
+#ifndef __APP_STATIC_H
+#define __APP_STATIC_H
+
+#include <rtthread.h>
+#include "../My_Driver/bsp_ccm.h"
+
+#define APP_STATIC_ALLOC 1
+#define APP_STACK_MIN 256 /* 栈下限：异常压栈 + 浮点上下文就要 200 字节左右 */
+
+/* 与内核 struct rt_mq_message (单个 next 指针) 一致：每条消息 = 对齐后的消息体 + 链表头 */
+#define APP_MQ_POOL_SIZE(msg_size, max_msgs) ((max_msgs) * (RT_ALIGN(msg_size, RT_ALIGN_SIZE) + sizeof(void *)))
+
+/* 与内核 rt_mp_init 一致：每块 = 对齐后的块大小 + 块头指针 */
+#define APP_MP_POOL_SIZE(block_size, blocks) ((blocks) * (RT_ALIGN(block_size, RT_ALIGN_SIZE) + sizeof(rt_uint8_t *)))
+
+/* 栈大小编译期检查：8 字节对齐 (AAPCS) 且不小于 APP_STACK_MIN */
+#define APP_STACK_CHECK(var, size) \
+    typedef char var##_stack_check[((size) % 8 == 0 && (size) >= APP_STACK_MIN) ? 1 : -1]
+
+#if APP_STATIC_ALLOC
+
+#ifdef RT_SIMULATOR
+#define APP_STATIC_SECTION
+#else
+#define APP_STATIC_SECTION __attribute__((section(".bss.app_static")))
+#endif
+
+#define APP_THREAD_DEFINE(var, size)                            \
+    APP_STACK_CHECK(var, size);                                 \
+    static struct rt_thread var##_tcb APP_STATIC_SECTION;       \
+    static rt_uint8_t var##_stack[size] ALIGN(8) APP_STATIC_SECTION
+
+#define APP_THREAD_DEFINE_CCM(var, size)          \
+    APP_STACK_CHECK(var, size);                   \
+    static struct rt_thread var##_tcb CCM_BSS;    \
+    static rt_uint8_t var##_stack[size] ALIGN(8) CCM_BSS
+
+#define APP_THREAD_CREATE(var, name, entry, param, prio, tick)                                               \
+    ((rt_thread_init(&var##_tcb, name, entry, param, var##_stack, sizeof(var##_stack), prio, tick) == RT_EOK) \
+         ? &var##_tcb                                                                                        \
+         : RT_NULL)
+
+#define APP_MQ_DEFINE(var, msg_size, max_msgs)                   \
+    static struct rt_messagequeue var##_obj APP_STATIC_SECTION;  \
+    static rt_uint8_t var##_pool[APP_MQ_POOL_SIZE(msg_size, max_msgs)] ALIGN(RT_ALIGN_SIZE) APP_STATIC_SECTION; \
+    enum { var##_msg_size = (msg_size) }
+
+#define APP_MQ_CREATE(var, name, flag) \
+    ((rt_mq_init(&var##_obj, name, var##_pool, var##_msg_size, sizeof(var##_pool), flag) == RT_EOK) ? &var##_obj : RT_NULL)
+
+#define APP_MUTEX_DEFINE(var) static struct rt_mutex var##_obj APP_STATIC_SECTION
+
+#define APP_MUTEX_CREATE(var, name, flag) ((rt_mutex_init(&var##_obj, name, flag) == RT_EOK) ? &var##_obj : RT_NULL)
+
+#define APP_MP_DEFINE(var, block_size, blocks)                   \
+    static struct rt_mempool var##_obj APP_STATIC_SECTION;       \
+    static rt_uint8_t var##_pool[APP_MP_POOL_SIZE(block_size, blocks)] ALIGN(RT_ALIGN_SIZE) APP_STATIC_SECTION; \
+    enum { var##_block_size = (block_size) }
+
+#define APP_MP_CREATE(var, name) \
+    ((rt_mp_init(&var##_obj, name, var##_pool, sizeof(var##_pool), var##_block_size) == RT_EOK) ? &var##_obj : RT_NULL)
+
+#else /* 堆分配：DEFINE 只记下尺寸 */
+
+#define APP_THREAD_DEFINE(var, size) \
+    APP_STACK_CHECK(var, size);      \
+    enum { var##_stack_size = (size) }
+
+#define APP_THREAD_DEFINE_CCM(var, size) APP_THREAD_DEFINE(var, size)
+
+#define APP_THREAD_CREATE(var, name, entry, param, prio, tick) \
+    rt_thread_create(name, entry, param, var##_stack_size, prio, tick)
+
+#define APP_MQ_DEFINE(var, msg_size, max_msgs) \
+    enum { var##_msg_size = (msg_size), var##_max_msgs = (max_msgs) }
+
+#define APP_MQ_CREATE(var, name, flag) rt_mq_create(name, var##_msg_size, var##_max_msgs, flag)
+
+#define APP_MUTEX_DEFINE(var) extern struct rt_mutex var##_unused
+
+#define APP_MUTEX_CREATE(var, name, flag) rt_mutex_create(name, flag)
+
+#define APP_MP_DEFINE(var, block_size, blocks) \
+    enum { var##_block_size = (block_size), var##_blocks = (blocks) }
+
+#define APP_MP_CREATE(var, name) rt_mp_create(name, var##_blocks, var##_block_size)
+
+#endif /* APP_STATIC_ALLOC */
+
+#endif /* __APP_STATIC_H */
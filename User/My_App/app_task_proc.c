@@ -8,16 +8,23 @@
 #include "app_move_proc.h"
 #include "app_qr_proc.h"
 #include "app_vision_proc.h"
+#include "app_static.h"
+#include "../Components/boot_prof.h"
 #include "../My_Driver/bsp_key_led.h"
 #include "../My_Driver/bsp_servo.h"
 
 #define DBG_TAG "app.brain"
 #define DBG_LVL DBG_LOG
 #include <rtdbg.h>
+#include "../Components/log_async.h"
 #include <stdlib.h>
 
+#define QR_WAIT_MS 500 /* 停车等码时每轮等待锁定的时长，到点就收下得票最多的合格读数 */
+
 /* 1. 声明 RTOS 资源 */
 struct rt_event mission_event;
+APP_THREAD_DEFINE(brain_thread, 2048);
+APP_THREAD_DEFINE(key_thread, 512);
 
 /* 任务清单：存储解析后的颜色序列 (1:红, 2:绿, 3:蓝) */
 static uint8_t g_batch1[3] = {0};
@@ -26,6 +33,25 @@ static uint8_t g_batch2[3] = {0};
 /* 2. 当前状态全局追踪 */
 static Mission_State_t current_state = STATE_IDLE;
 
+/* 色环对位时的相机区域 */
+static const Vision_Roi_t roi_ring = {VISION_ROI_RING_X0, VISION_ROI_RING_Y0, VISION_ROI_RING_X1, VISION_ROI_RING_Y1};
+
+/**
+ * @brief 等色之前告诉相机只找这一类 (在机械臂整备的延时之前发，相机趁这段时间切换)
+ */
+static void Brain_Vision_Want(uint8_t id, const Vision_Roi_t *roi)
+{
+    Vision_Request(VISION_ID_MASK(id), roi, VISION_FPS_TRACK);
+}
+
+/**
+ * @brief 一轮取放结束，相机回到全类别低帧率
+ */
+static void Brain_Vision_Idle(void)
+{
+    Vision_Request(VISION_ID_ALL, RT_NULL, VISION_FPS_IDLE);
+}
+
 /**
  * @brief 大脑指揮中心线程入口
  */
@@ -34,6 +60,7 @@ static void brain_thread_entry(void *parameter)
     rt_uint32_t recved_ev; // 接收到的事件缓存
 
     LOG_I("Brain thread started, waiting for start signal...");
+    Boot_Prof_Mark("ready"); /* 从此刻起可以响应 S1 */
 
     while (1)
     {
@@ -51,31 +78,48 @@ static void brain_thread_entry(void *parameter)
             break;
 
         case STATE_SCAN_QR:
+        {
+            /* 开始采集：扫码相机在途中的每次读数都参与表决 */
+            QR_Acquire_Start();
+
             /* 第一步：扫码位移准备 (左移 132mm) */
             Move_Now(MOVE_SLIDE_LEFT, 100.0f, 132.0f);
             rt_event_recv(&mission_event, EV_MOVE_FINISHED, RT_EVENT_FLAG_AND | RT_EVENT_FLAG_CLEAR, RT_WAITING_FOREVER, &recved_ev);
 
-            /* 前进 686mm */
-            Move_Now(MOVE_FORWARD, 300.0f, 686.0f);
+            /* 前进 686mm 经过扫码点不停车，接着 699mm 直达原料区 (原 STATE_GO_PLATE_1 一段) */
+            Move_Now(MOVE_FORWARD, 300.0f, 686.0f + 699.0f);
             rt_event_recv(&mission_event, EV_MOVE_FINISHED, RT_EVENT_FLAG_AND | RT_EVENT_FLAG_CLEAR, RT_WAITING_FOREVER, &recved_ev);
 
-            /* 第二步：核心：阻塞等待 MQ 包裹Pure MQ 模式 */
+            /* 第二步：取途中锁定的结果 (没锁定则取得票最多的合格读数) */
             QR_Task_Msg_t task_msg;
-            if (rt_mq_recv(qr_result_mq, &task_msg, sizeof(task_msg), RT_WAITING_FOREVER) == RT_EOK)
+            if (QR_Acquire_Get(&task_msg, 0) == RT_EOK)
             {
-                /* 第三步：在大脑层行使“语义解释权” (将字符转为任务数组) */
-                // "123+231"
-                g_batch1[0] = task_msg.content[0] - '0';
-                g_batch1[1] = task_msg.content[1] - '0';
-                g_batch1[2] = task_msg.content[2] - '0';
-
-                g_batch2[0] = task_msg.content[4] - '0';
-                g_batch2[1] = task_msg.content[5] - '0';
-                g_batch2[2] = task_msg.content[6] - '0';
-
+                current_state = STATE_PICK_PLATE_1;
+            }
+            else
+            {
+                /* 途中一次合格读数都没有：退回扫码点，停车等待 (旧流程)；
+                   不等 3 票锁定，有一次合格读数就收下 */
+                LOG_W("QR not read on the way, back to scan point");
+                Move_Now(MOVE_BACKWARD, 300.0f, 699.0f);
+                rt_event_recv(&mission_event, EV_MOVE_FINISHED, RT_EVENT_FLAG_AND | RT_EVENT_FLAG_CLEAR, RT_WAITING_FOREVER, &recved_ev);
+                while (QR_Acquire_Get(&task_msg, rt_tick_from_millisecond(QR_WAIT_MS)) != RT_EOK)
+                    ;
                 current_state = STATE_GO_PLATE_1;
             }
+
+            /* 第三步：在大脑层行使“语义解释权” (将字符转为任务数组)，格式已由 QR 层校验 */
+            // "123+231"
+            g_batch1[0] = task_msg.content[0] - '0';
+            g_batch1[1] = task_msg.content[1] - '0';
+            g_batch1[2] = task_msg.content[2] - '0';
+
+            g_batch2[0] = task_msg.content[4] - '0';
+            g_batch2[1] = task_msg.content[5] - '0';
+            g_batch2[2] = task_msg.content[6] - '0';
+            LOG_I("QR task %d%d%d+%d%d%d", g_batch1[0], g_batch1[1], g_batch1[2], g_batch2[0], g_batch2[1], g_batch2[2]);
             break;
+        }
 
         case STATE_GO_PLATE_1:
             /* 第三步：前往原料区 (第1次) - 前进 699mm */
@@ -94,6 +138,8 @@ static void brain_thread_entry(void *parameter)
             LOG_I("[State] Picking Batch 1...");
             for (int i = 0; i < 3; i++)
             {
+                Brain_Vision_Want(g_batch1[i], RT_NULL);
+
                 /* 1. 战备整备：底座转正 0 度，爪子张开 */
                 Servo_SetAngle(SERVO_BASE, 0);
                 Servo_SetAngle(SERVO_ARM, CLAW_OPEN); //
@@ -119,6 +165,7 @@ static void brain_thread_entry(void *parameter)
                 Arm_Place_To_Car(i + 1);
             }
 
+            Brain_Vision_Idle();
             // LOG_I("First Batch Successfully Loaded.");
             current_state = STATE_GO_FLOOR_1;
             break;
@@ -164,6 +211,8 @@ static void brain_thread_entry(void *parameter)
                     rt_event_recv(&mission_event, EV_MOVE_FINISHED, RT_EVENT_FLAG_AND | RT_EVENT_FLAG_CLEAR, RT_WAITING_FOREVER, &recved_ev);
                 }
 
+                Brain_Vision_Want(g_batch1[i] + 3, &roi_ring);
+
                 /* 2. 战备：机械臂回正，开爪，确保视野清爽 */
                 Servo_SetAngle(SERVO_BASE, 0);
                 Servo_SetAngle(SERVO_ARM, CLAW_OPEN);
@@ -206,6 +255,7 @@ static void brain_thread_entry(void *parameter)
                 Arm_Pick_From_Car(i + 1);
                 Arm_Place_To_Floor();
             }
+            Brain_Vision_Idle();
             LOG_I("Unloading to Floor 1 completed.");
             current_state = STATE_PICK_FLOOR_CAR_1;
             break;
@@ -276,6 +326,8 @@ static void brain_thread_entry(void *parameter)
                     rt_event_recv(&mission_event, EV_MOVE_FINISHED, RT_EVENT_FLAG_AND | RT_EVENT_FLAG_CLEAR, RT_WAITING_FOREVER, &recved_ev);
                 }
 
+                Brain_Vision_Want(g_batch1[i] + 3, &roi_ring);
+
                 /* 2. 战备：机械臂回正，开爪 */
                 Servo_SetAngle(SERVO_BASE, 0);
                 Servo_SetAngle(SERVO_ARM, CLAW_OPEN);
@@ -313,6 +365,7 @@ static void brain_thread_entry(void *parameter)
                 Arm_Pick_From_Car(i + 1);
                 Arm_Place_To_Floor();
             }
+            Brain_Vision_Idle();
             LOG_I("Unloading to FloorEnd 1 completed.");
             current_state = STATE_GO_PLATE_2;
             break;
@@ -338,6 +391,8 @@ static void brain_thread_entry(void *parameter)
             LOG_I("[State] Picking Batch 2...");
             for (int i = 0; i < 3; i++)
             {
+                Brain_Vision_Want(g_batch2[i], RT_NULL);
+
                 /* 1. 战备整备：底座转正 0 度，爪子张开 */
                 Servo_SetAngle(SERVO_BASE, 0);
                 Servo_SetAngle(SERVO_ARM, CLAW_OPEN);
@@ -361,6 +416,7 @@ static void brain_thread_entry(void *parameter)
                 Arm_Place_To_Car(i + 1);
             }
 
+            Brain_Vision_Idle();
             LOG_I("Second Batch Successfully Loaded.");
             current_state = STATE_GO_FLOOR_2;
             break;
@@ -406,6 +462,8 @@ static void brain_thread_entry(void *parameter)
                     rt_event_recv(&mission_event, EV_MOVE_FINISHED, RT_EVENT_FLAG_AND | RT_EVENT_FLAG_CLEAR, RT_WAITING_FOREVER, &recved_ev);
                 }
 
+                Brain_Vision_Want(g_batch2[i] + 3, &roi_ring);
+
                 /* 2. 战备：机械臂回正，开爪 */
                 Servo_SetAngle(SERVO_BASE, 0);
                 Servo_SetAngle(SERVO_ARM, CLAW_OPEN);
@@ -443,6 +501,7 @@ static void brain_thread_entry(void *parameter)
                 Arm_Pick_From_Car(i + 1);
                 Arm_Place_To_Floor();
             }
+            Brain_Vision_Idle();
             LOG_I("Unloading to Floor 2 completed.");
             current_state = STATE_PICK_FLOOR_CAR_2;
             break;
@@ -513,6 +572,8 @@ static void brain_thread_entry(void *parameter)
                     rt_event_recv(&mission_event, EV_MOVE_FINISHED, RT_EVENT_FLAG_AND | RT_EVENT_FLAG_CLEAR, RT_WAITING_FOREVER, &recved_ev);
                 }
 
+                Brain_Vision_Want(g_batch1[i] + 3, &roi_ring);
+
                 /* 2. 战备：机械臂回正，开爪 */
                 Servo_SetAngle(SERVO_BASE, 0);
                 Servo_SetAngle(SERVO_ARM, CLAW_OPEN);
@@ -552,6 +613,7 @@ static void brain_thread_entry(void *parameter)
                 Arm_Pick_From_Car(i + 1);
                 Arm_Place_To_Stack();
             }
+            Brain_Vision_Idle();
             LOG_I("Final Stacking completed.");
             current_state = STATE_GO_HOME;
             break;
@@ -621,18 +683,18 @@ int App_Task_Brain_Init(void)
     rt_event_init(&mission_event, "mission", RT_IPC_FLAG_FIFO);
 
     /* 2. 创建并启动大脑线程 */
-    rt_thread_t tid = rt_thread_create("brain",
-                                       brain_thread_entry, RT_NULL,
-                                       2048, 10, 20); // 优先级设为 10
+    rt_thread_t tid = APP_THREAD_CREATE(brain_thread, "brain",
+                                        brain_thread_entry, RT_NULL,
+                                        10, 20); // 优先级设为 10
     if (tid != RT_NULL)
     {
         rt_thread_startup(tid);
     }
 
     /* 3. 创建按键监听线程 */
-    rt_thread_t ktid = rt_thread_create("key_mon",
-                                        key_monitor_thread_entry, RT_NULL,
-                                        512, 15, 10);
+    rt_thread_t ktid = APP_THREAD_CREATE(key_thread, "key_mon",
+                                         key_monitor_thread_entry, RT_NULL,
+                                         15, 10);
     if (ktid != RT_NULL)
     {
         rt_thread_startup(ktid);
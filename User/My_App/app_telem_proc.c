@@ -0,0 +1,218 @@
+/**
+ * @file    app_telem_proc.c
+ * @brief   二进制遥测任务 (USART3 DMA 输出，控制周期全速率)
+ * @note    生产者 (运动线程) 只做结构体拷贝进环形缓冲；遥测线程补上 CRC 后把连续的一段记录
+ *          一次交给 DMA，发完由发送完成中断唤醒再取下一段，热路径上没有格式化与阻塞。
+ */
+
+#include "app_telem_proc.h"
+#include "app_vision_proc.h"
+#include "app_static.h"
+#include "../Components/boot_prof.h"
+#include "../My_Driver/bsp_uart.h"
+#include <string.h>
+
+#define DBG_TAG "app.telem"
+#define DBG_LVL DBG_LOG
+#include <rtdbg.h>
+#include "../Components/log_async.h"
+
+#define TELEM_STACK_SIZE 512
+#define TELEM_PRIORITY 20 /* 低于所有业务线程，只占空闲带宽 */
+#define TELEM_TICK 5
+
+#define TELEM_BAUD 460800          /* 84 字节 x 50 Hz 约占 10%，留足余量给后续记录类型 */
+#define TELEM_RING_SIZE 16         /* 环形缓冲记录数 (约 320ms) */
+#define TELEM_TX_TIMEOUT_MS 50     /* DMA 发送完成等待上限，超时视为外设异常，丢弃本段 */
+#define TELEM_VISION_FRESH_MS 200  /* 视觉结果超过此时长未更新视为丢失 */
+#define TELEM_PAUSE_WAIT_MS 100    /* 暂停时等待队列发空的上限 */
+
+#define TELEM_EV_DATA (1 << 0)   /* 环形缓冲有新记录 */
+#define TELEM_EV_TXDONE (1 << 1) /* DMA 发送完成 */
+
+/* 上位机按固定长度解码，结构体布局变化必须在编译期暴露出来 */
+typedef char telem_size_check[(sizeof(Telem_Ctrl_t) == TELEM_CTRL_SIZE) ? 1 : -1];
+
+/* DMA 直接从环形缓冲取数，缓冲区必须位于 DMA 可访问的 SRAM (不能放 CCM) */
+static Telem_Ctrl_t telem_ring[TELEM_RING_SIZE];
+static volatile uint16_t telem_head = 0; /* 生产者写入位置 (运动线程) */
+static volatile uint16_t telem_tail = 0; /* 消费者发送位置 (遥测线程) */
+
+static uint16_t telem_seq = 0;
+static uint32_t telem_sent = 0;    /* 已发出记录数 */
+static uint32_t telem_dropped = 0; /* 缓冲满丢弃的记录数 */
+static uint32_t telem_tx_err = 0;  /* DMA 启动失败或发送超时次数 */
+static uint8_t telem_enable = 1;   /* msh `telem off` 可临时关闭 */
+static volatile uint8_t telem_pause = 0; /* 其他模块临时独占 USART3 */
+
+static struct rt_event telem_event;
+static uint8_t telem_ready = 0;
+static rt_thread_t telem_thread = RT_NULL;
+APP_THREAD_DEFINE(telem_thread, TELEM_STACK_SIZE);
+
+/**
+ * @brief  [内部函数] CRC-16/CCITT-FALSE (逐位计算，在遥测线程里做，不占运动线程的控制周期)
+ */
+static uint16_t Telem_CRC16(const uint8_t *data, uint32_t len)
+{
+    uint16_t crc = 0xFFFF;
+
+    while (len--)
+    {
+        crc ^= (uint16_t)(*data++) << 8;
+        for (int i = 0; i < 8; i++)
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+    }
+    return crc;
+}
+
+/**
+ * @brief  [API] 提交一条控制周期记录
+ */
+void App_Telem_Push(Telem_Ctrl_t *rec)
+{
+    if (!telem_ready || !telem_enable || telem_pause)
+        return;
+
+    uint16_t next = (telem_head + 1) % TELEM_RING_SIZE;
+    if (next == telem_tail)
+    {
+        telem_dropped++;
+        return;
+    }
+
+    rec->sync[0] = TELEM_SYNC0;
+    rec->sync[1] = TELEM_SYNC1;
+    rec->type = TELEM_TYPE_CTRL;
+    rec->len = TELEM_CTRL_SIZE;
+    rec->seq = telem_seq++;
+    rec->tick = (uint32_t)((uint64_t)rt_tick_get() * 1000 / RT_TICK_PER_SECOND);
+
+    /* 视觉结果由视觉线程无锁更新，这里按字段读取即可 (与闭环读取方式一致) */
+    rec->vis_id = vision_app_data.target_id;
+    rec->vis_x = vision_app_data.target_x;
+    rec->vis_y = vision_app_data.target_y;
+    if (vision_app_data.is_found &&
+        rt_tick_get() - vision_app_data.last_update < rt_tick_from_millisecond(TELEM_VISION_FRESH_MS))
+        rec->flags |= TELEM_F_VISION;
+
+    telem_ring[telem_head] = *rec;
+    telem_head = next;
+    rt_event_send(&telem_event, TELEM_EV_DATA);
+}
+
+/**
+ * @brief  [API] 暂停 / 恢复遥测
+ */
+void App_Telem_Pause(uint8_t pause)
+{
+    telem_pause = pause;
+    if (!pause || !telem_ready)
+        return;
+
+    for (int waited = 0; telem_tail != telem_head && waited < TELEM_PAUSE_WAIT_MS; waited += 5)
+        rt_thread_mdelay(5);
+}
+
+/**
+ * @brief  [API] DMA 发送完成通知
+ */
+void App_Telem_TxDone(void)
+{
+    if (telem_ready)
+        rt_event_send(&telem_event, TELEM_EV_TXDONE);
+}
+
+/**
+ * @brief 遥测线程入口
+ */
+static void telem_proc(void *parameter)
+{
+    rt_uint32_t recved;
+
+    while (1)
+    {
+        if (telem_tail == telem_head)
+        {
+            rt_event_recv(&telem_event, TELEM_EV_DATA, RT_EVENT_FLAG_OR | RT_EVENT_FLAG_CLEAR,
+                          RT_WAITING_FOREVER, &recved);
+            continue;
+        }
+
+        /* 一次发出尾指针到头指针 (或缓冲末尾) 之间的全部记录 */
+        uint16_t head = telem_head;
+        uint16_t count = (head > telem_tail) ? (head - telem_tail) : (TELEM_RING_SIZE - telem_tail);
+
+        /* 头指针之前的记录生产者不会再写，可以就地补 CRC */
+        for (uint16_t i = 0; i < count; i++)
+        {
+            Telem_Ctrl_t *rec = &telem_ring[telem_tail + i];
+            rec->crc = Telem_CRC16(&rec->type, TELEM_CTRL_SIZE - 4);
+        }
+
+        rt_event_recv(&telem_event, TELEM_EV_TXDONE, RT_EVENT_FLAG_OR | RT_EVENT_FLAG_CLEAR, 0, &recved);
+        if (BSP_UART_Send_DMA(&uart3_telem, (uint8_t *)&telem_ring[telem_tail],
+                              count * sizeof(Telem_Ctrl_t)) != 0 ||
+            rt_event_recv(&telem_event, TELEM_EV_TXDONE, RT_EVENT_FLAG_OR | RT_EVENT_FLAG_CLEAR,
+                          rt_tick_from_millisecond(TELEM_TX_TIMEOUT_MS), &recved) != RT_EOK)
+        {
+            telem_tx_err++;
+        }
+        else
+        {
+            telem_sent += count;
+        }
+
+        telem_tail = (telem_tail + count) % TELEM_RING_SIZE;
+    }
+}
+
+/**
+ * @brief 初始化遥测任务
+ */
+int App_Telem_Init(void)
+{
+    rt_event_init(&telem_event, "telem", RT_IPC_FLAG_FIFO);
+    BSP_UART_SetBaud(&uart3_telem, TELEM_BAUD);
+
+    telem_thread = APP_THREAD_CREATE(telem_thread, "telem", telem_proc, RT_NULL, TELEM_PRIORITY, TELEM_TICK);
+
+    if (telem_thread != RT_NULL)
+    {
+        telem_ready = 1;
+        rt_thread_startup(telem_thread);
+        return 0;
+    }
+
+    LOG_E("Telemetry thread create failed");
+    return -1;
+}
+
+/* 遥测只用于调试，不在出发前的关键路径上 */
+INIT_DEFERRED_EXPORT(App_Telem_Init);
+
+/**
+ * @brief  msh 命令：查看/开关遥测
+ * @usage  telem          显示发送统计
+ *         telem on|off   开关遥测输出
+ */
+static void telem(int argc, char **argv)
+{
+    if (argc >= 2)
+    {
+        if (strcmp(argv[1], "on") == 0)
+            telem_enable = 1;
+        else if (strcmp(argv[1], "off") == 0)
+            telem_enable = 0;
+        else
+        {
+            rt_kprintf("Usage: telem [on|off]\n");
+            return;
+        }
+    }
+
+    rt_kprintf("telem %s: %d baud, %d B/record, sent %u, dropped %u, tx err %u\n",
+               telem_enable ? "on" : "off", TELEM_BAUD, TELEM_CTRL_SIZE,
+               telem_sent, telem_dropped, telem_tx_err);
+}
+MSH_CMD_EXPORT(telem, show or switch binary telemetry: telem [on|off]);
@@ -0,0 +1,91 @@
+/**
+ * @file    app_telem_proc.h
+ * @brief   二进制遥测任务 (USART3 DMA 输出，控制周期全速率)
+ *
+ * @usage 使用说明:
+ * 1. 运动线程每拍填好 Telem_Ctrl_t 的业务字段，调用 App_Telem_Push(&rec)
+ *    (只做一次结构体拷贝，不做任何格式化)；
+ * 2. 帧头、序号、时间戳、视觉字段与 CRC 由本模块补齐，遥测线程按 DMA 成批发出；
+ * 3. 上位机用 tools/telem_decode.py 解码为 CSV (或直接绘图)。
+ *
+ * [帧格式] 小端，定长 TELEM_CTRL_SIZE 字节，字段按自然对齐排布 (结构体无填充)：
+ *   A5 5A | type | len | seq(u16) | mode | flags | tick(u32) | ... | crc(u16)
+ *   crc 为 CRC-16/CCITT-FALSE (多项式 0x1021，初值 0xFFFF)，覆盖 sync 之后到 crc 之前的全部字节。
+ * 字段有增减时须同步修改 TELEM_CTRL_SIZE 与上位机解码脚本。
+ */
+
+#ifndef __APP_TELEM_PROC_H
+#define __APP_TELEM_PROC_H
+
+#include <rtthread.h>
+
+#define TELEM_SYNC0 0xA5
+#define TELEM_SYNC1 0x5A
+#define TELEM_TYPE_CTRL 0x01 /* 控制周期记录 */
+#define TELEM_CTRL_SIZE 84   /* 控制周期记录整帧长度 (字节) */
+
+/* flags 位定义 */
+#define TELEM_F_COORD (1 << 0)  /* 本段由联动插补执行 (航向锁以差速修正叠加) */
+#define TELEM_F_HOLD (1 << 1)   /* 航向锁有效 */
+#define TELEM_F_VISION (1 << 2) /* 视觉结果新鲜 (TELEM_VISION_FRESH_MS 内有更新) */
+
+/**
+ * @brief 控制周期遥测记录
+ */
+typedef struct
+{
+    /* 帧头 (由 App_Telem_Push 填写) */
+    uint8_t sync[2];
+    uint8_t type;
+    uint8_t len;
+    uint16_t seq;   /* 帧序号，上位机据此统计丢帧 */
+    uint8_t mode;   /* Move_Mode_t (由运动线程填写) */
+    uint8_t flags;  /* TELEM_F_xxx (由运动线程与本模块共同填写) */
+    uint32_t tick;  /* 系统时间 (ms) */
+
+    /* 运动状态 (由运动线程填写) */
+    float speed;      /* 当前平滑速度 (mm/s) */
+    float wheel[4];   /* 下发轮速指令 M1~M4 (mm/s) */
+    int32_t steps[4]; /* 本段里程 M1~M4 (步)，换段时清零 */
+    float yaw;        /* 融合航向 (度，连续角) */
+    float yaw_rate;   /* Z 轴角速度 (度/s) */
+    float yaw_ref;    /* 航向目标：平移为锁定航向，绝对转向为当前参考角 */
+    float pid_p;      /* 当前生效航向环的 P/I/D 分量与输出 (mm/s) */
+    float pid_i;
+    float pid_d;
+    float pid_out;
+
+    /* 视觉 (由 App_Telem_Push 填写) */
+    uint8_t vis_id;
+    uint8_t leg;     /* 段序号 (由运动线程填写)，每次里程清零加 1，上位机据此拼接位姿 */
+    uint16_t vis_x;  /* 目标中心 (像素) */
+    uint16_t vis_y;
+    uint16_t crc;
+} Telem_Ctrl_t;
+
+/**
+ * @brief  [API] 初始化遥测任务
+ * @return 0: 成功, -1: 失败
+ */
+int App_Telem_Init(void);
+
+/**
+ * @brief  [API] 提交一条控制周期记录
+ * @param  rec: 已填好运动状态字段的记录，帧头/视觉/CRC 由本函数补齐
+ * @note   只允许运动线程一个生产者调用；缓冲区满时丢弃本条并计数，不阻塞
+ */
+void App_Telem_Push(Telem_Ctrl_t *rec);
+
+/**
+ * @brief  [API] 暂停 / 恢复遥测 (供其他模块临时独占 USART3)
+ * @param  pause: 1 暂停，等已排队的记录发完 (最多 TELEM_PAUSE_WAIT_MS) 后返回；0 恢复
+ * @note   暂停期间提交的记录直接丢弃，不计入丢帧统计
+ */
+void App_Telem_Pause(uint8_t pause);
+
+/**
+ * @brief  [API] DMA 发送完成通知 (由串口发送完成回调在中断中调用)
+ */
+void App_Telem_TxDone(void);
+
+#endif /* __APP_TELEM_PROC_H */
@@ -0,0 +1,214 @@
+/**
+ * @file    app_tune_proc.c
+ * @brief   航向环 PID 继电器自整定实现
+ *
+ * [原理]:
+ * 1. 底盘以 ±d 的继电器输出代替 PID，航向会围绕目标角形成稳定极限环。
+ * 2. 测出振荡幅值 a 与周期 Tu，按描述函数法: Ku = 4d / (π * sqrt(a^2 - ε^2))。
+ * 3. 按 Ziegler-Nichols 变体规则由 Ku/Tu 求出 PID 参数 (转向用无超调规则)。
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include "app_tune_proc.h"
+#include "app_imu_proc.h"
+#include "app_task_proc.h"
+#include "app_param.h"
+
+#define DBG_TAG "app.tune"
+#define DBG_LVL DBG_LOG
+#include <rtdbg.h>
+#include "../Components/log_async.h"
+
+#define TUNE_SAMPLE_MS 10           /* 航向采样周期 */
+#define TUNE_HYST_DEG 0.5f          /* 继电器回差 (度)，略大于 IMU 噪声 */
+#define TUNE_SKIP_CYCLES 2          /* 丢弃的起振周期数 */
+#define TUNE_MAX_CYCLES 6           /* 参与统计的周期数 */
+#define TUNE_TIMEOUT_MS 15000       /* 实验超时 */
+#define TUNE_STRAIGHT_SPEED 200.0f  /* 直行实验速度 (mm/s) */
+#define TUNE_STRAIGHT_DIST 1500.0f  /* 直行实验最大距离 (mm) */
+#define TUNE_CONTROL_DT 0.02f       /* 与 app_move_proc 控制周期一致 */
+
+#ifndef M_PI
+#define M_PI 3.14159265358979f
+#endif
+
+/**
+ * @brief  [内部函数] 角度误差归一化到 (-180, 180]
+ */
+static float Tune_Wrap(float deg)
+{
+    while (deg > 180.0f)
+        deg -= 360.0f;
+    while (deg < -180.0f)
+        deg += 360.0f;
+    return deg;
+}
+
+/**
+ * @brief  执行一次继电器反馈实验
+ */
+rt_err_t Tune_Relay_Run(Move_Loop_t loop, float amp, Tune_Result_t *res)
+{
+    if (res == RT_NULL || amp <= 0)
+        return -RT_EINVAL;
+    if (Move_Get_Mode() != MOVE_STOP)
+        return -RT_EBUSY;
+
+    float center;
+    App_IMU_Get_Heading(&center, RT_NULL); /* 与航向环使用同一个融合航向 */
+    Move_Relay_Start(loop, amp, TUNE_HYST_DEG, TUNE_STRAIGHT_SPEED, TUNE_STRAIGHT_DIST);
+
+    /* 以误差向上穿越 +回差 的时刻作为周期起点 */
+    int8_t side = 0;              /* 当前所处半周: 1 正, -1 负 */
+    rt_tick_t start = rt_tick_get();
+    rt_tick_t last_cross = 0;
+    int cross_count = 0;
+    float e_max = -1000.0f, e_min = 1000.0f;
+    float sum_period = 0, sum_amp = 0;
+    uint8_t cycles = 0;
+
+    while (cycles < TUNE_MAX_CYCLES)
+    {
+        rt_thread_mdelay(TUNE_SAMPLE_MS);
+
+        if (Move_Get_Mode() != MOVE_RELAY_TUNE)
+            break; /* 直行实验跑完全程或被外部打断 */
+        if (rt_tick_get() - start > rt_tick_from_millisecond(TUNE_TIMEOUT_MS))
+            break;
+
+        float yaw;
+        App_IMU_Get_Heading(&yaw, RT_NULL);
+        float e = Tune_Wrap(yaw - center);
+        if (e > e_max)
+            e_max = e;
+        if (e < e_min)
+            e_min = e;
+
+        if (e > TUNE_HYST_DEG && side <= 0)
+        {
+            rt_tick_t now = rt_tick_get();
+            side = 1;
+            cross_count++;
+            if (cross_count > TUNE_SKIP_CYCLES + 1)
+            {
+                sum_period += (float)(now - last_cross) / RT_TICK_PER_SECOND;
+                sum_amp += (e_max - e_min) * 0.5f;
+                cycles++;
+            }
+            last_cross = now;
+            e_max = -1000.0f;
+            e_min = 1000.0f;
+        }
+        else if (e < -TUNE_HYST_DEG)
+        {
+            side = -1;
+        }
+    }
+
+    Move_Stop();
+    /* 直行实验会自动刹停并发出完成事件，此处清掉，避免误唤醒大脑 */
+    rt_uint32_t ev;
+    rt_event_recv(&mission_event, EV_MOVE_FINISHED,
+                  RT_EVENT_FLAG_OR | RT_EVENT_FLAG_CLEAR, RT_WAITING_NO, &ev);
+
+    if (cycles < 2)
+        return -RT_ETIMEOUT;
+
+    /* 描述函数法求临界增益与周期 */
+    float a = sum_amp / cycles;
+    float a_eff = (a > TUNE_HYST_DEG) ? sqrtf(a * a - TUNE_HYST_DEG * TUNE_HYST_DEG) : a;
+    res->amp = a;
+    res->tu = sum_period / cycles;
+    res->ku = 4.0f * amp / ((float)M_PI * a_eff);
+    res->cycles = cycles;
+
+    /* 转向: 无超调规则; 直行: 少量超调规则 (连续域 Kp, Ti, Td) */
+    float kp, ti, td;
+    if (loop == MOVE_LOOP_TURN)
+    {
+        kp = 0.20f * res->ku;
+        ti = 0.50f * res->tu;
+        td = res->tu / 3.0f;
+    }
+    else
+    {
+        kp = 0.33f * res->ku;
+        ti = 0.50f * res->tu;
+        td = res->tu / 3.0f;
+    }
+
+    /* 连续域 -> 每拍系数 (与 app_param.h 同单位) */
+    res->kp = kp;
+    res->ki = (kp / ti) * TUNE_CONTROL_DT;
+    res->kd = (kp * td) / TUNE_CONTROL_DT;
+
+    Move_Set_Gains(loop, res->kp, res->ki, res->kd);
+
+    /* 同步到参数表，由调用者决定是否落盘 */
+    if (loop == MOVE_LOOP_TURN)
+    {
+        g_param.kp_turn = res->kp;
+        g_param.ki_turn = res->ki;
+        g_param.kd_turn = res->kd;
+    }
+    else
+    {
+        g_param.kp_straight = res->kp;
+        g_param.ki_straight = res->ki;
+        g_param.kd_straight = res->kd;
+    }
+    return RT_EOK;
+}
+
+/**
+ * @brief  msh 命令: autotune <turn|straight> [amp]
+ */
+static void autotune(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        rt_kprintf("Usage: autotune <turn|straight> [amp]\n");
+        return;
+    }
+
+    Move_Loop_t loop;
+    float amp;
+    if (rt_strcmp(argv[1], "turn") == 0)
+    {
+        loop = MOVE_LOOP_TURN;
+        amp = 60.0f; /* 轮速 mm/s */
+    }
+    else if (rt_strcmp(argv[1], "straight") == 0)
+    {
+        loop = MOVE_LOOP_STRAIGHT;
+        amp = 30.0f;
+    }
+    else
+    {
+        rt_kprintf("Unknown loop: %s\n", argv[1]);
+        return;
+    }
+    if (argc > 2)
+        amp = (float)atof(argv[2]);
+
+    Tune_Result_t res;
+    rt_err_t ret = Tune_Relay_Run(loop, amp, &res);
+    if (ret != RT_EOK)
+    {
+        LOG_E("Autotune failed (%d).", (int)ret);
+        return;
+    }
+
+    LOG_I("Ku=%d.%03d Tu=%dms amp=%d.%02ddeg (%d cycles)",
+          (int)res.ku, (int)(res.ku * 1000) % 1000, (int)(res.tu * 1000),
+          (int)res.amp, (int)(res.amp * 100) % 100, res.cycles);
+    LOG_I("Gains: kp=%d.%04d ki=%d.%04d kd=%d.%04d",
+          (int)res.kp, (int)(res.kp * 10000) % 10000,
+          (int)res.ki, (int)(res.ki * 10000) % 10000,
+          (int)res.kd, (int)(res.kd * 10000) % 10000);
+
+    /* 持久化：下次上电直接生效 */
+    LOG_I("Saving gains to flash: %s", (Param_Save() == RT_EOK) ? "OK" : "FAILED");
+}
+MSH_CMD_EXPORT(autotune, relay auto-tune heading PID: autotune turn|straight [amp]);
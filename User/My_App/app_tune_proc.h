@@ -0,0 +1,35 @@
+/**
+ * @file    app_tune_proc.h
+ * @brief   航向环 PID 继电器自整定 (Relay Auto-Tune)
+ */
+
+#ifndef __APP_TUNE_PROC_H
+#define __APP_TUNE_PROC_H
+
+#include <rtthread.h>
+#include "app_move_proc.h"
+
+/**
+ * @brief 自整定结果
+ * @note  kp/ki/kd 与 app_param.h 同单位 (按 20ms 一拍整定的系数)，可直接抄回宏定义
+ */
+typedef struct
+{
+    float ku;       /* 临界增益 (PID 输出单位 / 度) */
+    float tu;       /* 临界周期 (s) */
+    float amp;      /* 航向振荡幅值 (度) */
+    uint8_t cycles; /* 参与统计的完整周期数 */
+    float kp, ki, kd;
+} Tune_Result_t;
+
+/**
+ * @brief  [API] 执行一次继电器反馈实验并计算 PID 参数
+ * @param  loop: MOVE_LOOP_TURN (原地) 或 MOVE_LOOP_STRAIGHT (直行中)
+ * @param  amp: 继电器幅值 (PID 输出单位)
+ * @param  res: 输出结果
+ * @return RT_EOK 成功; -RT_EBUSY 底盘忙; -RT_ETIMEOUT 未形成稳定振荡
+ * @note   阻塞执行 (数秒)，须在底盘空闲时调用，成功后自动写入对应 PID 与 g_param。
+ */
+rt_err_t Tune_Relay_Run(Move_Loop_t loop, float amp, Tune_Result_t *res);
+
+#endif /* __APP_TUNE_PROC_H */
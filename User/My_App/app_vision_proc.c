@@ -4,16 +4,81 @@
  */
 
 #include "app_vision_proc.h"
+#include "app_static.h"
 #include "../My_Driver/bsp_uart.h"
+#include <rthw.h>
 #include <string.h>
 
+#define DBG_TAG "app.vision"
+#define DBG_LVL DBG_INFO
+#include <rtdbg.h>
+#include "../Components/log_async.h"
+
 #define VISION_STACK_SIZE 1024
 #define VISION_PRIORITY 11
 #define VISION_TICK 5
+
+#define VISION_ACK_TIMEOUT_MS 100 /* 等应答超时 (19 字节在 115200 下约 1.7ms，相机处理一帧 33ms) */
+#define VISION_CMD_RETRY 3        /* 超时重发次数，用完仍无应答则只靠主控侧过滤 */
+#define VISION_ROI_FALLBACK_MS 1000 /* 带区域的请求发出后这么久一帧合格的都没有，改请求全画面 */
+
 volatile App_Vision_Data_t vision_app_data = {0};
 rt_mq_t vision_mq = RT_NULL;
 
 static rt_thread_t vision_thread = RT_NULL;
+APP_THREAD_DEFINE(vision_thread, VISION_STACK_SIZE);
+APP_MQ_DEFINE(vision_mq, sizeof(Frame_t *), 10);
+
+/* 请求通道状态：req 由调用方写 (关中断拷贝)，其余只在 vision 线程里读写 */
+typedef struct
+{
+    uint8_t id_mask;
+    uint8_t fps;
+    Vision_Roi_t roi;
+} Vision_Cmd_t;
+
+static const Vision_Roi_t vision_roi_full = {0, 0, 319, 239};
+
+static Vision_Cmd_t vision_req = {0, 30, {0, 0, 319, 239}}; /* 最近一次请求 (类别也是帧过滤条件) */
+static volatile uint8_t vision_req_gen = 0;                  /* 每次请求 +1 */
+static uint8_t vision_sent_gen = 0;                          /* 已发送的请求 */
+static uint8_t vision_seq = 0;                               /* 当前命令序号 0~9 */
+static uint8_t vision_retry = 0;
+static volatile rt_bool_t vision_pending = RT_FALSE; /* 已发送、等应答 */
+static rt_tick_t vision_sent_tick = 0;
+static uint8_t vision_tx_buf[32]; /* DMA 发送缓冲，须在 SRAM (区域已限幅，格式化后恰为 VISION_CMD_LEN) */
+static rt_bool_t vision_roi_armed = RT_FALSE; /* 带区域的请求已发出，还没看到合格帧 */
+
+/* 统计 */
+static uint32_t vision_ack_cnt = 0;
+static uint32_t vision_timeout_cnt = 0;
+static rt_tick_t vision_ack_ticks = 0; /* 最近一次 "首次发送 -> 应答" 耗时 */
+static rt_tick_t vision_first_tick = 0;
+static uint32_t vision_roi_fallback_cnt = 0;
+
+/**
+ * @brief  [内部函数] 上报帧是否符合当前请求的类别
+ * @note   区域只是给相机的提示，不在主控侧过滤：目标偏出区域时照样要拿它的坐标去对位
+ */
+static rt_bool_t Vision_Accept(uint8_t id)
+{
+    if (id < 1 || id > 6)
+        return RT_FALSE;
+    return vision_req.id_mask == 0 || (vision_req.id_mask & VISION_ID_MASK(id));
+}
+
+/**
+ * @brief  [内部函数] 处理应答帧
+ */
+static void Vision_Ack(uint8_t seq)
+{
+    if (vision_pending && seq == vision_seq)
+    {
+        vision_pending = RT_FALSE;
+        vision_ack_cnt++;
+        vision_ack_ticks = rt_tick_get() - vision_first_tick;
+    }
+}
 
 /**
  * @brief  视觉数据解析
@@ -23,9 +88,16 @@ static rt_thread_t vision_thread = RT_NULL;
  */
 static void Vision_Parse(uint8_t *data, uint16_t len)
 {
-    /* 遍历查找帧头 'a' */
+    /* 遍历查找帧头 'a' (上报) / 'k' (应答) */
     for (int i = 0; i < len; i++)
     {
+        if (data[i] == 'k' && (i + 2) < len && data[i + 2] == 'c')
+        {
+            Vision_Ack(data[i + 1] - '0');
+            i += 2;
+            continue;
+        }
+
         /* 检查剩余长度是否足够包含一个完整帧 (至少 9 字节: a + ID + 3位X + 3位Y + c) */
         if (data[i] == 'a' && (i + 8) < len)
         {
@@ -44,6 +116,13 @@ static void Vision_Parse(uint8_t *data, uint16_t len)
                              (data[i + 6] - '0') * 10 +
                              (data[i + 7] - '0');
 
+                /* 不是当前请求的类别：跳过，继续找下一帧 */
+                if (!Vision_Accept(id))
+                {
+                    i += 8;
+                    continue;
+                }
+
                 /* [保姆级提醒]: 在 32位系统下读取 16位数据是原子的，且闭环控制允许微小误差，故移除互斥锁以提升性能 */
                 vision_app_data.target_id = id;
                 vision_app_data.target_x = x;
@@ -52,8 +131,86 @@ static void Vision_Parse(uint8_t *data, uint16_t len)
                 vision_app_data.last_update = rt_tick_get();
 
                 // rt_kprintf("[Vision] Found ID:%d at (%d, %d)\n", id, x, y);
-                return;
+                i += 8;
+            }
+        }
+    }
+}
+
+/**
+ * @brief  [内部函数] 组一条请求命令并用 DMA 发出
+ * @return 0: 已启动, -1: 上一条还在发送
+ */
+static int Vision_Cmd_Send(const Vision_Cmd_t *cmd)
+{
+    rt_snprintf((char *)vision_tx_buf, sizeof(vision_tx_buf), "s%u%02u%03u%03u%03u%03u%02ue", vision_seq,
+                cmd->id_mask, cmd->roi.x0, cmd->roi.y0, cmd->roi.x1, cmd->roi.y1, cmd->fps);
+    if (BSP_UART_Send_DMA(&uart6_vision, vision_tx_buf, VISION_CMD_LEN) != 0)
+        return -1;
+    vision_sent_tick = rt_tick_get();
+    return 0;
+}
+
+/**
+ * @brief  [内部函数] 请求通道轮询：发送新请求 / 超时重发
+ */
+static void Vision_Cmd_Poll(void)
+{
+    /* 区域内迟迟没有目标 (长距离移动后残差超出预期)：同类别改看全画面，免得对位一直等 */
+    if (vision_roi_armed)
+    {
+        if (vision_app_data.is_found)
+        {
+            vision_roi_armed = RT_FALSE;
+        }
+        else if (rt_tick_get() - vision_first_tick >= rt_tick_from_millisecond(VISION_ROI_FALLBACK_MS))
+        {
+            rt_base_t level = rt_hw_interrupt_disable();
+            if (vision_req_gen == vision_sent_gen) /* 调用方没有发新请求 */
+            {
+                vision_req.roi = vision_roi_full;
+                vision_req_gen++;
             }
+            rt_hw_interrupt_enable(level);
+            vision_roi_armed = RT_FALSE;
+            vision_roi_fallback_cnt++;
+            LOG_W("nothing in roi after %d ms, requesting full frame", VISION_ROI_FALLBACK_MS);
+        }
+    }
+
+    uint8_t gen = vision_req_gen;
+
+    if (gen != vision_sent_gen)
+    {
+        Vision_Cmd_t cmd;
+        rt_base_t level = rt_hw_interrupt_disable();
+        cmd = vision_req;
+        rt_hw_interrupt_enable(level);
+
+        vision_sent_gen = gen;
+        vision_seq = (vision_seq + 1) % 10;
+        vision_retry = 0;
+        vision_first_tick = rt_tick_get();
+        vision_pending = RT_TRUE;
+        vision_roi_armed = memcmp(&cmd.roi, &vision_roi_full, sizeof(cmd.roi)) != 0;
+        if (Vision_Cmd_Send(&cmd) != 0) /* 上一条还在发：按超时处理，下次醒来重发 */
+            vision_sent_tick = vision_first_tick - rt_tick_from_millisecond(VISION_ACK_TIMEOUT_MS);
+        return;
+    }
+
+    if (vision_pending && rt_tick_get() - vision_sent_tick >= rt_tick_from_millisecond(VISION_ACK_TIMEOUT_MS))
+    {
+        if (vision_retry < VISION_CMD_RETRY)
+        {
+            Vision_Cmd_t cmd = vision_req;
+            if (Vision_Cmd_Send(&cmd) == 0)
+                vision_retry++;
+        }
+        else
+        {
+            vision_pending = RT_FALSE;
+            vision_timeout_cnt++;
+            LOG_W("camera did not ack request %u, filtering on MCU side only", vision_seq);
         }
     }
 }
@@ -65,32 +222,74 @@ static void vision_proc(void *parameter)
 {
     while (1)
     {
-        uint32_t rx_len;
-        /* 等待串口接收完成信号 (生产者-消费者模型) */
-        if (rt_mq_recv(vision_mq, &rx_len, sizeof(rx_len), RT_WAITING_FOREVER) == RT_EOK)
+        Frame_t *f;
+        /* 等应答 / 等区域内目标时带超时醒来，以便重发或改看全画面 */
+        rt_int32_t timeout = RT_WAITING_FOREVER;
+        if (vision_pending)
+            timeout = (rt_int32_t)rt_tick_from_millisecond(VISION_ACK_TIMEOUT_MS / 2);
+        else if (vision_roi_armed)
+            timeout = (rt_int32_t)rt_tick_from_millisecond(VISION_ROI_FALLBACK_MS / 4);
+
+        /* 等待串口帧 (生产者-消费者模型)，解析完归还；RT_NULL 为 Vision_Request 的唤醒 */
+        if (rt_mq_recv(vision_mq, &f, sizeof(f), timeout) == RT_EOK && f != RT_NULL)
         {
-            Vision_Parse(uart6_vision.rx_buffer, (uint16_t)rx_len);
+            Vision_Parse(f->data, f->len);
+            Frame_Free(f);
         }
+        Vision_Cmd_Poll();
     }
 }
 
+/**
+ * @brief  设置相机的目标类别、感兴趣区域与帧率 (不阻塞)
+ */
+void Vision_Request(uint8_t id_mask, const Vision_Roi_t *roi, uint8_t fps)
+{
+    Frame_t *kick = RT_NULL;
+
+    rt_base_t level = rt_hw_interrupt_disable();
+    vision_req.id_mask = id_mask & VISION_ID_ALL;
+    vision_req.roi = (roi != RT_NULL) ? *roi : vision_roi_full;
+    if (vision_req.roi.x1 > vision_roi_full.x1)
+        vision_req.roi.x1 = vision_roi_full.x1;
+    if (vision_req.roi.y1 > vision_roi_full.y1)
+        vision_req.roi.y1 = vision_roi_full.y1;
+    if (vision_req.roi.x0 > vision_req.roi.x1)
+        vision_req.roi.x0 = vision_req.roi.x1;
+    if (vision_req.roi.y0 > vision_req.roi.y1)
+        vision_req.roi.y0 = vision_req.roi.y1;
+    vision_req.fps = (fps < 1) ? 1 : (fps > 99) ? 99 : fps;
+    vision_req_gen++;
+    vision_app_data.is_found = RT_FALSE; /* 之前看到的可能不是这次要的 */
+    rt_hw_interrupt_enable(level);
+
+    /* 队列满时不必唤醒：线程马上就会处理到，处理完照样轮询 */
+    if (vision_mq != RT_NULL)
+        rt_mq_send(vision_mq, &kick, sizeof(kick));
+}
+
+/**
+ * @brief  最近一次请求是否已被相机确认
+ */
+rt_bool_t Vision_Request_Acked(void)
+{
+    return vision_req_gen == vision_sent_gen && !vision_pending && vision_ack_cnt > 0;
+}
+
 /**
  * @brief 初始化视觉识别
  */
 int App_Vision_Init(void)
 {
     // 创建一个名字叫 "mq_vis" 的消息队列
-    vision_mq = rt_mq_create("mq_vis", sizeof(uint32_t), 10, RT_IPC_FLAG_FIFO);
+    vision_mq = APP_MQ_CREATE(vision_mq, "mq_vis", RT_IPC_FLAG_FIFO);
 
-    vision_thread = rt_thread_create("vision_proc",
-                                     vision_proc,
-                                     RT_NULL,
-                                     VISION_STACK_SIZE,
-                                     VISION_PRIORITY,
-                                     VISION_TICK);
+    vision_thread = APP_THREAD_CREATE(vision_thread, "vision_proc", vision_proc, RT_NULL, VISION_PRIORITY,
+                                      VISION_TICK);
 
     if (vision_thread != RT_NULL && vision_mq != RT_NULL)
     {
+        BSP_UART_Init(&uart6_vision);
         rt_thread_startup(vision_thread);
         return 0;
     }
@@ -98,3 +297,19 @@ int App_Vision_Init(void)
 }
 
 INIT_APP_EXPORT(App_Vision_Init);
+
+/**
+ * @brief  msh 命令：视觉请求通道状态
+ */
+static void vision(int argc, char **argv)
+{
+    rt_kprintf("request : ids 0x%02x roi (%u,%u)-(%u,%u) %u fps, seq %u %s\n", vision_req.id_mask,
+               vision_req.roi.x0, vision_req.roi.y0, vision_req.roi.x1, vision_req.roi.y1, vision_req.fps, vision_seq,
+               vision_pending ? "waiting ack" : (Vision_Request_Acked() ? "acked" : "not acked"));
+    rt_kprintf("acks %u, timeouts %u, last ack %u ms, rx drop %u, roi fallbacks %u\n", (unsigned)vision_ack_cnt,
+               (unsigned)vision_timeout_cnt, (unsigned)vision_ack_ticks * 1000 / RT_TICK_PER_SECOND,
+               (unsigned)uart6_vision.rx_drop, (unsigned)vision_roi_fallback_cnt);
+    rt_kprintf("last    : id %u at (%u, %u), found %u\n", vision_app_data.target_id, vision_app_data.target_x,
+               vision_app_data.target_y, vision_app_data.is_found);
+}
+MSH_CMD_EXPORT(vision, vision request channel status);
@@ -20,6 +20,36 @@ typedef struct
     rt_tick_t last_update; /* 最后更新系统时间 */
 } App_Vision_Data_t;
 
+/**
+ * @brief 感兴趣区域 (像素，含边界)
+ */
+typedef struct
+{
+    uint16_t x0, y0;
+    uint16_t x1, y1;
+} Vision_Roi_t;
+
+#define VISION_ID_MASK(id) (1u << ((id) - 1)) /* ID 1~6 -> 类别位 */
+#define VISION_ID_ALL 0x3Fu
+
+/**
+ * @usage 请求通道 (huart6 发送):
+ * 1. 等某个颜色之前告诉相机只找这一类、只看这块区域、按多快的帧率：
+ *      Vision_Request(VISION_ID_MASK(ring_id), &roi, VISION_FPS_TRACK);
+ *    立即返回，由 vision 线程发送并等应答，超时重发 VISION_CMD_RETRY 次。
+ * 2. 新请求会清掉 is_found，之后只有类别符合的帧才会更新 vision_app_data
+ *    (相机固件不认识命令、没有应答时，这层过滤照样生效)。区域只是给相机的提示，主控不按区域
+ *    丢帧；带区域的请求 VISION_ROI_FALLBACK_MS 内一帧合格的都没有，自动改请求全画面。
+ * 3. msh: vision   打印当前请求、应答次数 / 超时次数、最近一次应答耗时
+ *
+ * [协议] ASCII 定长，与上报帧同风格：
+ *   请求 (主控 -> 相机) 19 字节：'s' + 序号(1) + 类别位(2，十进制) + X0 Y0 X1 Y1 (各 3) + 帧率(2) + 'e'
+ *        例：s10808006024022030e = 序号 1，只找 ID 4 (类别位 08)，区域 (80,60)-(240,220)，30fps
+ *   应答 (相机 -> 主控) 3 字节：'k' + 序号(1) + 'c'，可与 'a' 上报帧混在同一次接收里
+ *   序号 0~9 循环，只认最近一次请求的应答。
+ */
+#define VISION_CMD_LEN 19
+
 extern volatile App_Vision_Data_t vision_app_data;
 extern rt_mq_t vision_mq; /* 消息队列：对接 MaixCam 的异步解析中枢 */
 
@@ -30,4 +60,17 @@ extern rt_mq_t vision_mq; /* 消息队列：对接 MaixCam 的异步解析中枢
  */
 int App_Vision_Init(void);
 
+/**
+ * @brief  [API] 设置相机的目标类别、感兴趣区域与帧率 (不阻塞)
+ * @param  id_mask: 类别位 (VISION_ID_MASK 组合)，0 表示不限类别
+ * @param  roi: 感兴趣区域，RT_NULL 表示全画面
+ * @param  fps: 期望帧率 (1~99)
+ */
+void Vision_Request(uint8_t id_mask, const Vision_Roi_t *roi, uint8_t fps);
+
+/**
+ * @brief  [API] 最近一次请求是否已被相机确认
+ */
+rt_bool_t Vision_Request_Acked(void);
+
 #endif /* __APP_VISION_PROC_H */
@@ -0,0 +1,73 @@
+/**
+ ******************************************************************************
+ * @file    bsp_ccm.h
+ * @author  lingxing
+ * @brief   CCM RAM / SRAM 执行的放置属性与热点路径周期统计
+ ******************************************************************************
+ */
+
+#ifndef __BSP_CCM_H
+#define __BSP_CCM_H
+
+#include <stdint.h>
+#ifndef RT_SIMULATOR
+#include "main.h"
+#endif
+
+/**
+ * @usage 使用说明:
+ * 1. 热点数据放 CCM (零初始化，不能带初值)：  Motor_t motor_1 CCM_BSS;
+ * 2. 热点函数放 SRAM 执行：                  RAM_FUNC void BSP_Motor_CC_IRQHandler(...)
+ * 3. 周期统计：  uint32_t t0 = CCM_CYCLES(); ... ; CCM_BENCH_ADD(&ccm_bench_step, CCM_CYCLES() - t0);
+ * 4. msh: ccm          打印 CCM 占用、步进中断 / 运动控制循环的周期统计
+ *         ccm reset    清零统计
+ *         ccm bench    同一段代码/数据分别在 Flash/SRAM/CCM 上的对比测试
+ *
+ * [限制] F407 的 CCM (0x10000000, 64K) 只接在内核 D 总线上：
+ * - DMA 访问不到：串口收发缓冲、DMA 源/目的一律不能放 CCM，放进 CCM 的线程栈上也不能有 DMA 缓冲；
+ * - 不能取指：没有 ITCM，"RAM 执行" 只能放 SRAM (.ramfunc，随 .data 拷贝)，
+ *   指令走 S 总线，配合数据放 CCM 后取指与取数分走两条总线。
+ * BSP_CCM_ENABLE 置 0 后属性全部为空 (中断栈仍在 CCM，由链接脚本决定)，用于重新编译做对比。
+ */
+
+#define BSP_CCM_ENABLE 1
+
+#if BSP_CCM_ENABLE && !defined(RT_SIMULATOR)
+#define CCM_BSS __attribute__((section(".ccmbss")))
+#define RAM_FUNC __attribute__((section(".ramfunc")))
+#else
+#define CCM_BSS
+#define RAM_FUNC
+#endif
+
+#ifdef RT_SIMULATOR
+#define CCM_CYCLES() 0u
+#else
+#define CCM_CYCLES() (DWT->CYCCNT)
+#endif
+
+/* 一段代码的执行周期统计 */
+typedef struct
+{
+    uint32_t count;
+    uint32_t last;
+    uint32_t max;
+    uint64_t sum;
+} CCM_Bench_t;
+
+extern CCM_Bench_t ccm_bench_step; /* 步进比较中断 (分派之后的步进处理) */
+extern CCM_Bench_t ccm_bench_move; /* 运动控制循环 (一拍的计算部分) */
+
+/* 宏而非函数：-O0 下不内联，函数调用会把 SRAM 中的热点路径又带回 Flash */
+#define CCM_BENCH_ADD(b, cycles)   \
+    do                             \
+    {                              \
+        uint32_t cyc_ = (cycles);  \
+        (b)->count++;              \
+        (b)->last = cyc_;          \
+        (b)->sum += cyc_;          \
+        if (cyc_ > (b)->max)       \
+            (b)->max = cyc_;       \
+    } while (0)
+
+#endif /* __BSP_CCM_H */
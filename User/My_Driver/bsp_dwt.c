@@ -0,0 +1,43 @@
+/**
+ ******************************************************************************
+ * @file    bsp_dwt.c
+ * @author  lingxing
+ * @brief   DWT 周期计数器 (CYCCNT)，用于代码段耗时测量
+ ******************************************************************************
+ */
+
+#include "bsp_dwt.h"
+#include "../../cubemx/Inc/main.h"
+#include <rtthread.h>
+
+/**
+ * @brief  打开 DWT 周期计数器
+ * @note   调试器连接时 TRCENA 可能已被置位，这里只在计数器未运行时清零，避免打断外部测量
+ */
+int BSP_DWT_Init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    if (!(DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk))
+    {
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+    return RT_EOK;
+}
+INIT_BOARD_EXPORT(BSP_DWT_Init);
+
+/**
+ * @brief  读取当前周期计数
+ */
+uint32_t BSP_DWT_GetCycles(void)
+{
+    return DWT->CYCCNT;
+}
+
+/**
+ * @brief  周期数换算为纳秒 (按当前内核时钟)
+ */
+uint32_t BSP_DWT_CyclesToNs(uint32_t cycles)
+{
+    return (uint32_t)((uint64_t)cycles * 1000000000u / SystemCoreClock);
+}
@@ -0,0 +1,28 @@
+/**
+ ******************************************************************************
+ * @file    bsp_dwt.h
+ * @author  lingxing
+ * @brief   DWT 周期计数器 (CYCCNT)，用于代码段耗时测量
+ ******************************************************************************
+ */
+
+#ifndef __BSP_DWT_H
+#define __BSP_DWT_H
+
+#include <stdint.h>
+
+/**
+ * @usage 使用说明:
+ * 1. 初始化: 上电自动调用 BSP_DWT_Init() (INIT_BOARD_EXPORT)，重复调用无副作用
+ * 2. 计时:   uint32_t t0 = BSP_DWT_GetCycles(); ... ; uint32_t cyc = BSP_DWT_GetCycles() - t0;
+ * 3. 换算:   BSP_DWT_CyclesToNs(cyc)
+ *
+ * 计数器 32 位，按内核时钟 (168MHz) 计数，约 25.5s 回绕一次；
+ * 相减取差值天然处理一次回绕，只适合测量短于回绕周期的区间。
+ */
+
+int BSP_DWT_Init(void);
+uint32_t BSP_DWT_GetCycles(void);
+uint32_t BSP_DWT_CyclesToNs(uint32_t cycles);
+
+#endif /* __BSP_DWT_H */
@@ -7,17 +7,205 @@
  */
 
 #include "bsp_motor.h"
+#include "bsp_ccm.h"
+#include "bsp_motor_range.h"
+#include <rtthread.h>
+#include <math.h>
 
 extern TIM_HandleTypeDef htim1;
 extern TIM_HandleTypeDef htim2;
 #include "../../cubemx/Inc/main.h"
 
-/* 电机实例 */
-Motor_t motor_1;
-Motor_t motor_2;
-Motor_t motor_3;
-Motor_t motor_4;
-Motor_t motor_5;
+/* 预分频档位表与间隔换算见 bsp_motor_range.h (纯计算，宿主机测试覆盖) */
+
+/* 定时器状态 (同一定时器上的通道共用预分频) */
+typedef struct
+{
+    TIM_HandleTypeDef *htim;
+    uint32_t clk_hz;  /* 定时器输入时钟 */
+    uint32_t tick_hz; /* 当前档位的实际计数频率 */
+    uint8_t range;    /* 当前档位 */
+} Motor_Timer_t;
+
+static Motor_Timer_t motor_timers[2] = {
+    {.htim = &htim1, .range = MOTOR_RANGE_DEFAULT},
+    {.htim = &htim2, .range = MOTOR_RANGE_DEFAULT},
+};
+
+/* 电机实例：每个比较中断都要读写，放 CCM 避开与 DMA 共用的 SRAM */
+Motor_t motor_1 CCM_BSS;
+Motor_t motor_2 CCM_BSS;
+Motor_t motor_3 CCM_BSS;
+Motor_t motor_4 CCM_BSS;
+Motor_t motor_5 CCM_BSS;
+
+static Motor_t *const motor_list[] = {&motor_1, &motor_2, &motor_3, &motor_4, &motor_5};
+#define MOTOR_NUM (sizeof(motor_list) / sizeof(motor_list[0]))
+
+/*
+ * 比较中断分派表：[定时器 (TIM1/TIM2)][通道] -> 电机，按 SR 位号直接查表，
+ * 未接电机的通道指向常停的占位电机，查表后不用再判空。
+ */
+#define MOTOR_CC_FLAGS (TIM_SR_CC1IF | TIM_SR_CC2IF | TIM_SR_CC3IF | TIM_SR_CC4IF)
+static Motor_t motor_none CCM_BSS;
+static Motor_t *motor_cc_table[2][4] CCM_BSS;
+
+/* 多轴联动插补状态 (motor_1~4) */
+typedef struct
+{
+    volatile uint8_t active;
+    Motor_t *master;                   /* 节拍轴：其比较中断产生节拍，驱动整个插补 */
+    uint32_t total;                    /* 节拍总数 N (= T + 修正余量) */
+    uint32_t span;                     /* 最大轴步数 T */
+    uint32_t done;                     /* 已走节拍数 */
+    int32_t steps[MOTOR_COORD_AXES];   /* 各轴带符号步数 */
+    int8_t trim_dir[MOTOR_COORD_AXES]; /* 各轴修正分量的方向 (0 不参与) */
+    volatile int32_t trim;             /* 修正分量：每节拍 trim / N 步，线程随时改写 */
+    int32_t acc[MOTOR_COORD_AXES];     /* DDA 累加器 (单位 1/N 步) */
+    int8_t pending[MOTOR_COORD_AXES];  /* 该轴下一节拍的出步方向，0 不出步 */
+} Motor_Coord_t;
+
+static Motor_Coord_t motor_coord CCM_BSS;
+
+static void Motor_Coord_Abort(void);
+
+static Motor_Timer_t *Motor_Get_Timer(Motor_t *motor)
+{
+    return (motor->config.htim == &htim2) ? &motor_timers[1] : &motor_timers[0];
+}
+
+/**
+ * @brief  获取定时器输入时钟 (APB 分频不为 1 时定时器时钟为 PCLK x2)
+ */
+static uint32_t Motor_Timer_Clock(TIM_HandleTypeDef *htim)
+{
+    RCC_ClkInitTypeDef clk;
+    uint32_t latency;
+    uint32_t pclk, div;
+
+    HAL_RCC_GetClockConfig(&clk, &latency);
+    if (htim->Instance == TIM1 || htim->Instance == TIM8)
+    {
+        pclk = HAL_RCC_GetPCLK2Freq();
+        div = clk.APB2CLKDivider;
+    }
+    else
+    {
+        pclk = HAL_RCC_GetPCLK1Freq();
+        div = clk.APB1CLKDivider;
+    }
+    return (div == RCC_HCLK_DIV1) ? pclk : pclk * 2;
+}
+
+RAM_FUNC static uint32_t Motor_CC_IT(Motor_t *motor)
+{
+    /* TIM_CHANNEL_x 为 0/4/8/12，对应 CC1IE~CC4IE */
+    return TIM_IT_CC1 << (motor->config.channel >> 2);
+}
+
+/**
+ * @brief  修改单个通道的输出比较模式 (TIMING 冻结 / TOGGLE 翻转)
+ */
+RAM_FUNC static void Motor_OC_Mode(Motor_t *motor, uint32_t mode)
+{
+    TIM_TypeDef *tim = motor->config.htim->Instance;
+    uint32_t shift = (motor->config.channel == TIM_CHANNEL_2 || motor->config.channel == TIM_CHANNEL_4) ? 8 : 0;
+    volatile uint32_t *ccmr = (motor->config.channel <= TIM_CHANNEL_2) ? &tim->CCMR1 : &tim->CCMR2;
+
+    *ccmr = (*ccmr & ~(TIM_CCMR1_OC1M << shift)) | (mode << shift);
+}
+
+RAM_FUNC static uint32_t Motor_Clamp_Interval(uint32_t iv)
+{
+    if (iv < MOTOR_INTERVAL_MIN)
+        return MOTOR_INTERVAL_MIN;
+    if (iv > MOTOR_INTERVAL_MAX)
+        return MOTOR_INTERVAL_MAX;
+    return iv;
+}
+
+/**
+ * @brief  按 dir 写方向引脚 (与原工程对标：正转时 reverse=0 输出低电平)
+ * @note   比较中断里换向也走这里，直接写 BSRR，不调 Flash 里的 HAL_GPIO_WritePin
+ */
+RAM_FUNC static void Motor_Write_Dir(Motor_t *motor)
+{
+    uint8_t level = (motor->dir > 0) ? motor->config.reverse : !motor->config.reverse;
+    uint32_t pin = motor->config.dir.pin;
+    motor->config.dir.port->BSRR = level ? pin : (pin << 16);
+}
+
+RAM_FUNC static int Motor_Coord_Member(Motor_t *motor)
+{
+    for (uint32_t i = 0; i < MOTOR_COORD_AXES; i++)
+    {
+        if (motor_list[i] == motor)
+            return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief  切换预分频档位
+ * @note   UG 事件立即装载 PSC 并清零计数器，调用方负责重新安排运行通道的 CCR
+ */
+static void Motor_Timer_SetRange(Motor_Timer_t *t, uint8_t range)
+{
+    uint32_t psc = t->clk_hz / motor_range_hz[range] - 1;
+
+    t->range = range;
+    t->tick_hz = t->clk_hz / (psc + 1);
+    __HAL_TIM_SET_PRESCALER(t->htim, psc);
+    t->htim->Instance->EGR = TIM_EGR_UG;
+}
+
+/**
+ * @brief  按最慢的运行通道选择档位，并刷新该定时器上所有运行通道的目标间隔 (需在临界区内调用)
+ * @note   换档时斜坡的当前间隔按计数频率等比换算，加减速过程不中断
+ */
+static void Motor_Timer_Update(Motor_Timer_t *t)
+{
+    float slowest = 0.0f;
+
+    for (uint32_t i = 0; i < MOTOR_NUM; i++)
+    {
+        Motor_t *m = motor_list[i];
+        if (m->dir != 0 && Motor_Get_Timer(m) == t)
+        {
+            float r = fabsf(m->rate);
+            if (slowest == 0.0f || r < slowest)
+                slowest = r;
+        }
+    }
+    if (slowest == 0.0f)
+        return;
+
+    uint8_t range = Motor_Range_Select(t->clk_hz, t->range, slowest);
+    uint8_t rearm = (range != t->range);
+    uint32_t tick_old = t->tick_hz;
+    if (rearm)
+        Motor_Timer_SetRange(t, range);
+
+    for (uint32_t i = 0; i < MOTOR_NUM; i++)
+    {
+        Motor_t *m = motor_list[i];
+        if (Motor_Get_Timer(m) != t)
+            continue;
+
+        if (rearm)
+            Motor_Ramp_Config(&m->ramp, t->tick_hz, m->accel);
+        if (m->dir == 0)
+            continue;
+
+        Motor_Ramp_SetTarget(&m->ramp, Motor_Range_Interval(t->tick_hz, m->rate));
+        if (rearm)
+        {
+            Motor_Ramp_Rescale(&m->ramp, tick_old, t->tick_hz);
+            m->interval = Motor_Clamp_Interval((m->ramp.c + (1u << (MOTOR_RAMP_Q - 1))) >> MOTOR_RAMP_Q);
+            __HAL_TIM_SET_COMPARE(t->htim, m->config.channel, m->interval);
+        }
+    }
+}
 
 /**
  * @brief  初始化电机硬件
@@ -70,64 +258,349 @@ void BSP_Motor_Init(void)
     motor_5.config.en.pin = GPIO_PIN_11;
     motor_5.config.reverse = 0;
 
-    /* 启动 TIM1 的四个通道 (使用中断模式以统计步数) */
-    HAL_TIM_OC_Start_IT(motor_1.config.htim, motor_1.config.channel);
-    HAL_TIM_OC_Start_IT(motor_2.config.htim, motor_2.config.channel);
-    HAL_TIM_OC_Start_IT(motor_3.config.htim, motor_3.config.channel);
-    HAL_TIM_OC_Start_IT(motor_4.config.htim, motor_4.config.channel);
-    HAL_TIM_OC_Start_IT(motor_5.config.htim, motor_5.config.channel);
+    /* 定时器改为自由计数 (ARR 满量程)，按默认档位装载预分频 */
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        Motor_Timer_t *t = &motor_timers[i];
+        t->clk_hz = Motor_Timer_Clock(t->htim);
+        __HAL_TIM_SET_AUTORELOAD(t->htim, MOTOR_INTERVAL_MAX);
+        Motor_Timer_SetRange(t, MOTOR_RANGE_DEFAULT);
+    }
+
+    /* 分派表 */
+    for (uint32_t t = 0; t < 2; t++)
+    {
+        for (uint32_t ch = 0; ch < 4; ch++)
+            motor_cc_table[t][ch] = &motor_none;
+    }
+    for (uint32_t i = 0; i < MOTOR_NUM; i++)
+    {
+        Motor_t *m = motor_list[i];
+        motor_cc_table[m->config.htim == &htim2][m->config.channel >> 2] = m;
+    }
+
+    /* 启动各通道 (使用中断模式以统计步数)，随后全部冻结，等待 SetRate */
+    for (uint32_t i = 0; i < MOTOR_NUM; i++)
+    {
+        HAL_TIM_OC_Start_IT(motor_list[i]->config.htim, motor_list[i]->config.channel);
+        BSP_Motor_Stop(motor_list[i]);
+        Motor_Ramp_Config(&motor_list[i]->ramp, Motor_Get_Timer(motor_list[i])->tick_hz, motor_list[i]->accel);
+    }
 }
 
 /**
- * @brief  设置电机速度
+ * @brief  设置电机步频 (线性：步频 = 定时器计数频率 / interval)
+ * @param  steps_per_s: 目标步频 (步/s)，正负表示方向，|值| < MOTOR_RATE_MIN 视为停止
+ * @note   设置了加速度时只更新目标，实际步频由比较中断逐步逼近
  */
-void BSP_Motor_SetSpeed(Motor_t *motor, int32_t speed)
+void BSP_Motor_SetRate(Motor_t *motor, float steps_per_s)
 {
-    uint32_t arr_val = 0;
-    uint8_t direction = 0;
+    float mag = fabsf(steps_per_s);
 
-    /* 限制范围 */
-    if (speed > 10000)
-        speed = 10000;
-    if (speed < -10000)
-        speed = -10000;
+    if (mag < MOTOR_RATE_MIN)
+    {
+        BSP_Motor_Stop(motor);
+        return;
+    }
+    if (mag > MOTOR_RATE_MAX)
+        steps_per_s = (steps_per_s > 0) ? MOTOR_RATE_MAX : -MOTOR_RATE_MAX;
 
-    motor->speed = speed;
+    TIM_HandleTypeDef *htim = motor->config.htim;
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
 
-    if (speed == 0)
+    /* 单轴控速会打断联动插补 */
+    if (motor_coord.active && Motor_Coord_Member(motor))
+        Motor_Coord_Abort();
+
+    uint8_t was_running = (motor->dir != 0);
+    motor->rate = steps_per_s;
+    motor->dir_target = (steps_per_s > 0) ? 1 : -1;
+    if (!was_running)
     {
-        BSP_Motor_Stop(motor);
+        /* 静止时可以直接换向；运行中的换向交给中断 (先减速到零) */
+        motor->dir = motor->dir_target;
+        Motor_Write_Dir(motor);
+        Motor_Ramp_Reset(&motor->ramp);
+    }
+    Motor_Timer_Update(Motor_Get_Timer(motor));
+
+    if (!was_running)
+    {
+        /* 从静止启动：第一次翻转安排在 "现在 + 起步间隔" */
+        motor->interval = Motor_Clamp_Interval(Motor_Ramp_Next(&motor->ramp, 0));
+        __HAL_TIM_SET_COMPARE(htim, motor->config.channel,
+                              (__HAL_TIM_GET_COUNTER(htim) + motor->interval) & MOTOR_INTERVAL_MAX);
+        Motor_OC_Mode(motor, TIM_OCMODE_TOGGLE);
+        __HAL_TIM_CLEAR_FLAG(htim, Motor_CC_IT(motor));
+        __HAL_TIM_ENABLE_IT(htim, Motor_CC_IT(motor));
+    }
+
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief  设置加速度
+ * @param  steps_per_s2: 加速度 (步/s^2)，0 表示步频立即跳变 (旧行为)
+ * @note   含开方运算，仅在数值变化时重新计算，可以每个控制周期调用
+ */
+void BSP_Motor_SetAccel(Motor_t *motor, float steps_per_s2)
+{
+    if (steps_per_s2 == motor->accel)
         return;
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    motor->accel = steps_per_s2;
+    Motor_Ramp_Config(&motor->ramp, Motor_Get_Timer(motor)->tick_hz, steps_per_s2);
+
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief  电机停止 (立即停止，不走减速斜坡)
+ * @note   冻结比较输出 (引脚保持当前电平) 并关闭该通道中断，
+ *         不再像旧实现那样把 ARR 拉满后仍以约 15Hz 慢速翻转。
+ *         联动走完时由比较中断经 Motor_Coord_Abort 调用，整条路径放 SRAM
+ */
+RAM_FUNC void BSP_Motor_Stop(Motor_t *motor)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    /* 联动中的任一轴停止即终止整个插补 */
+    if (motor_coord.active && Motor_Coord_Member(motor))
+        Motor_Coord_Abort();
+
+    motor->rate = 0;
+    motor->dir = 0;
+    motor->dir_target = 0;
+    motor->interval = 0;
+    Motor_Ramp_Reset(&motor->ramp);
+    Motor_OC_Mode(motor, TIM_OCMODE_TIMING);
+    __HAL_TIM_DISABLE_IT(motor->config.htim, Motor_CC_IT(motor));
+
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief  [内部函数] 终止联动插补并冻结所有联动轴 (正常走完时也由此收尾)
+ */
+RAM_FUNC static void Motor_Coord_Abort(void)
+{
+    if (!motor_coord.active)
+        return;
+
+    motor_coord.active = 0;
+    for (uint32_t i = 0; i < MOTOR_COORD_AXES; i++)
+        BSP_Motor_Stop(motor_list[i]);
+}
+
+/**
+ * @brief  [内部函数] 为比较值 t 的节拍分配各轴步数 (带符号 DDA)
+ * @note   每节拍各轴累加 steps + trim_dir * trim，越过 ±N/2 出一步。trim 为 0 时即
+ *         Bresenham：N 个节拍后各轴恰好走完 steps。出步的轴比较值设为 t 并置翻转模式，
+ *         在同一计数值翻转；不出步的冻结 (节拍轴冻结时比较中断照常产生，只是引脚不翻)。
+ *         方向引脚提前一个节拍写好。
+ */
+RAM_FUNC static void Motor_Coord_Schedule(uint32_t t)
+{
+    int32_t n = (int32_t)motor_coord.total;
+    int32_t hi = n - n / 2; /* 累加器保持在 [-n/2, n - n/2) 内，宽度恰为 n */
+    int32_t lo = -(n / 2);
+    int32_t trim = motor_coord.trim;
+
+    for (uint32_t i = 0; i < MOTOR_COORD_AXES; i++)
+    {
+        Motor_t *m = motor_list[i];
+        int32_t acc = motor_coord.acc[i] + motor_coord.steps[i] + motor_coord.trim_dir[i] * trim;
+        int8_t p = 0;
+
+        if (acc >= hi)
+        {
+            acc -= n;
+            p = 1;
+        }
+        else if (acc < lo)
+        {
+            acc += n;
+            p = -1;
+        }
+        motor_coord.acc[i] = acc;
+        motor_coord.pending[i] = p;
+
+        if (p != 0)
+        {
+            if (p != m->dir)
+            {
+                m->dir = m->dir_target = p;
+                Motor_Write_Dir(m);
+            }
+            __HAL_TIM_SET_COMPARE(m->config.htim, m->config.channel, t);
+            Motor_OC_Mode(m, TIM_OCMODE_TOGGLE);
+        }
+        else
+        {
+            Motor_OC_Mode(m, TIM_OCMODE_TIMING);
+        }
     }
+}
+
+/**
+ * @brief  [内部函数] 节拍轴比较中断：记步、推进节拍斜坡并安排下一节拍
+ */
+RAM_FUNC static void Motor_Coord_Step(void)
+{
+    Motor_t *master = motor_coord.master;
+    TIM_HandleTypeDef *htim = master->config.htim;
+
+    for (uint32_t i = 0; i < MOTOR_COORD_AXES; i++)
+        motor_list[i]->total_steps += motor_coord.pending[i];
 
-    /* 确定方向与周期 (频率 = 1 / ARR) */
-    if (speed > 0)
+    /* 走满 N 个节拍时各轴的 steps 恰好分配完毕 (修正分量另计)，全部在这一节拍结束 */
+    if (++motor_coord.done >= motor_coord.total)
     {
-        direction = motor->config.reverse ? 1 : 0;
-        arr_val = 10200 - speed; // 与原工程逻辑对标：速度越大，载装载值越小，频率越高
+        Motor_Coord_Abort();
+        return;
     }
-    else
+
+    /* 剩余步数不超过刹停所需步数时开始减速 */
+    uint32_t remain = motor_coord.total - motor_coord.done;
+    master->interval = Motor_Clamp_Interval(Motor_Ramp_Next(&master->ramp, remain <= master->ramp.n));
+
+    uint32_t t = (__HAL_TIM_GET_COMPARE(htim, master->config.channel) + master->interval) & MOTOR_INTERVAL_MAX;
+    __HAL_TIM_SET_COMPARE(htim, master->config.channel, t);
+    Motor_Coord_Schedule(t);
+}
+
+/**
+ * @brief  启动多轴联动插补 (motor_1~4)
+ * @param  steps: 各轮带符号步数
+ * @param  trim_dir: 各轮修正分量的方向 (-1/0/1)，NULL 表示不使用 BSP_Motor_Coord_Trim
+ * @param  rate: 步数最多的轮的最高步频 (步/s)
+ * @param  accel: 步数最多的轮的加速度 (步/s^2)，0 表示不做斜坡
+ * @return 0 成功, -1 参数无效
+ * @note   会先停止 motor_1~4 当前的运动；完成后各轴自动停止，用 BSP_Motor_Coord_Busy 查询。
+ *         使用修正分量时节拍比最多的轮快 MOTOR_COORD_TRIM_MAX 倍，给修正留出余量。
+ */
+int BSP_Motor_Coord_Start(const int32_t steps[MOTOR_COORD_AXES], const int8_t trim_dir[MOTOR_COORD_AXES],
+                          float rate, float accel)
+{
+    uint32_t span = 0;
+    int mi = -1;
+
+    for (uint32_t i = 0; i < MOTOR_COORD_AXES; i++)
+    {
+        uint32_t n = (uint32_t)((steps[i] < 0) ? -steps[i] : steps[i]);
+        if (n > span)
+        {
+            span = n;
+            mi = (int)i;
+        }
+    }
+    rate = fabsf(rate);
+    if (mi < 0 || rate < MOTOR_RATE_MIN)
+        return -1;
+
+    /* 节拍数与节拍频率：比最多的轮多出修正余量 */
+    uint32_t total = span;
+    if (trim_dir != NULL)
+        total += (uint32_t)lrintf((float)span * MOTOR_COORD_TRIM_MAX);
+    float scale = (float)total / (float)span;
+    float clk_rate = rate * scale;
+    if (clk_rate > MOTOR_RATE_MAX)
+        clk_rate = MOTOR_RATE_MAX;
+
+    for (uint32_t i = 0; i < MOTOR_COORD_AXES; i++)
+        BSP_Motor_Stop(motor_list[i]);
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    /* 节拍轴：步数最多的轮，按节拍频率选档并配置斜坡 */
+    Motor_t *master = motor_list[mi];
+    Motor_Timer_t *t = Motor_Get_Timer(master);
+    master->dir = master->dir_target = (steps[mi] > 0) ? 1 : -1;
+    master->rate = clk_rate * master->dir;
+    master->accel = accel * scale;
+    Motor_Ramp_Reset(&master->ramp);
+    Motor_Timer_Update(t);
+    Motor_Ramp_Config(&master->ramp, t->tick_hz, master->accel);
+    Motor_Write_Dir(master);
+
+    /* 各轴：出步与方向都由节拍上的 DDA 决定 */
+    motor_coord.master = master;
+    motor_coord.total = total;
+    motor_coord.span = span;
+    motor_coord.done = 0;
+    motor_coord.trim = 0;
+    for (uint32_t i = 0; i < MOTOR_COORD_AXES; i++)
     {
-        direction = motor->config.reverse ? 0 : 1;
-        arr_val = 10200 + speed;
+        Motor_t *m = motor_list[i];
+        motor_coord.steps[i] = steps[i];
+        motor_coord.trim_dir[i] = (trim_dir != NULL) ? trim_dir[i] : 0;
+        motor_coord.acc[i] = 0;
+        motor_coord.pending[i] = 0;
+        if (m != master)
+            m->rate = clk_rate * (float)steps[i] / (float)total;
     }
+    motor_coord.active = 1;
+
+    /* 第一个节拍 */
+    TIM_HandleTypeDef *htim = master->config.htim;
+    master->interval = Motor_Clamp_Interval(Motor_Ramp_Next(&master->ramp, 0));
+    uint32_t first = (__HAL_TIM_GET_COUNTER(htim) + master->interval) & MOTOR_INTERVAL_MAX;
+    __HAL_TIM_SET_COMPARE(htim, master->config.channel, first);
+    __HAL_TIM_CLEAR_FLAG(htim, Motor_CC_IT(master));
+    __HAL_TIM_ENABLE_IT(htim, Motor_CC_IT(master));
+    Motor_Coord_Schedule(first);
+
+    __set_PRIMASK(primask);
+    return 0;
+}
 
-    /* 写入方向 */
-    HAL_GPIO_WritePin(motor->config.dir.port, motor->config.dir.pin,
-                      direction ? GPIO_PIN_SET : GPIO_PIN_RESET);
+/**
+ * @brief  设置联动插补的修正分量 (可在运行中随时调用，下一节拍生效)
+ * @param  trim: 修正分量步频与最多的轮步频之比，带符号，限幅到 ±MOTOR_COORD_TRIM_MAX
+ * @note   轮 i 的步频为 (steps[i] + trim_dir[i] * trim * T) / N 个节拍，
+ *         修正分量只改变各轮之间的差速，不影响节拍数，全部仍在第 N 拍同时结束
+ */
+void BSP_Motor_Coord_Trim(float trim)
+{
+    int32_t lim = (int32_t)(motor_coord.total - motor_coord.span);
+    int32_t v = (int32_t)lrintf(trim * (float)motor_coord.span);
+
+    if (v > lim)
+        v = lim;
+    if (v < -lim)
+        v = -lim;
+    motor_coord.trim = v; /* 32 位对齐写，中断里读到的总是完整值 */
+}
 
-    /* 修改定时器周期 (改变脉冲频率) */
-    __HAL_TIM_SET_AUTORELOAD(motor->config.htim, arr_val);
+/**
+ * @brief  联动插补是否仍在运行
+ */
+uint8_t BSP_Motor_Coord_Busy(void)
+{
+    return motor_coord.active;
 }
 
 /**
- * @brief  电机停止
+ * @brief  是否有电机在出步 (含联动与机械臂升降)
+ * @note   擦 Flash 扇区期间取指停顿，向量表与中断入口都在 Flash 上，比较中断会被整体推迟，
+ *         擦除前须确认电机全部静止
  */
-void BSP_Motor_Stop(Motor_t *motor)
+uint8_t BSP_Motor_Busy(void)
 {
-    motor->speed = 0;
-    /* 停止脉冲 (或者将 ARR 设为极大值) */
-    __HAL_TIM_SET_AUTORELOAD(motor->config.htim, 65535);
+    if (motor_coord.active)
+        return 1;
+    for (uint32_t i = 0; i < MOTOR_NUM; i++)
+    {
+        if (motor_list[i]->dir != 0)
+            return 1;
+    }
+    return 0;
 }
 
 /**
@@ -141,49 +614,131 @@ void BSP_Motor_Enable(Motor_t *motor, uint8_t enable)
                           enable ? GPIO_PIN_RESET : GPIO_PIN_SET);
     }
 }
+
 /**
- * @brief  定时器输出比较中断回调 (每产生一个脉冲执行一次)
- * @note   在这里进行步数统计 (HAL 层本能反应)
+ * @brief  [内部函数] 单个通道的一次比较翻转：步数统计，并把 CCR 向后推一个间隔安排下一次翻转
+ * @param  ccr: 该通道的比较寄存器
  */
-void HAL_TIM_OC_DelayElapsedCallback(TIM_HandleTypeDef *htim)
+RAM_FUNC static void Motor_Step(Motor_t *p_motor, volatile uint32_t *ccr)
 {
-    if (htim->Instance == TIM1)
+    if (motor_coord.active && p_motor == motor_coord.master)
     {
-        /* 判定是哪个通道触发的脉冲 */
-        Motor_t *p_motor = NULL;
-        if (htim->Channel == HAL_TIM_ACTIVE_CHANNEL_1)
-            p_motor = &motor_1;
-        else if (htim->Channel == HAL_TIM_ACTIVE_CHANNEL_2)
-            p_motor = &motor_2;
-        else if (htim->Channel == HAL_TIM_ACTIVE_CHANNEL_3)
-            p_motor = &motor_3;
-        else if (htim->Channel == HAL_TIM_ACTIVE_CHANNEL_4)
-            p_motor = &motor_4;
+        /* 联动插补：主轴节拍统一处理四个轮 */
+        Motor_Coord_Step();
+        return;
+    }
+    if (p_motor->dir == 0)
+        return;
+
+    /* 根据方向进行加减 (用于计算里程) */
+    p_motor->total_steps += p_motor->dir;
+
+    /* 逐步加减速：目标方向与当前方向相反时先减速，减到静止再翻转方向引脚 */
+    uint8_t reversing = (p_motor->dir_target != p_motor->dir);
+    p_motor->interval = Motor_Clamp_Interval(Motor_Ramp_Next(&p_motor->ramp, reversing));
+    if (reversing && p_motor->ramp.n == 0)
+    {
+        p_motor->dir = p_motor->dir_target;
+        Motor_Write_Dir(p_motor);
+    }
 
-        if (p_motor != NULL && p_motor->speed != 0)
+    /* 下一次翻转 (16 位计数自然回绕) */
+    *ccr = (*ccr + p_motor->interval) & MOTOR_INTERVAL_MAX;
+}
+
+/**
+ * @brief  TIM1 / TIM2 比较中断 (寄存器级，由 stm32f4xx_it.c 直接调用)
+ * @note   SR 只读一次，本次挂起的通道一并清标志、一遍处理完；
+ *         通道号由位号直接得到，查表取电机，不经过 HAL_TIM_IRQHandler 的逐标志分派
+ */
+RAM_FUNC void BSP_Motor_CC_IRQHandler(TIM_TypeDef *tim)
+{
+    uint32_t t0 = CCM_CYCLES();
+    Motor_t *const *table = motor_cc_table[tim == TIM2];
+    volatile uint32_t *ccr = &tim->CCR1;
+    uint32_t pend = tim->SR & tim->DIER & MOTOR_CC_FLAGS;
+
+    tim->SR = ~pend; /* rc_w0：写 0 清除，写 1 不影响，处理期间新来的比较不会丢 */
+    while (pend)
+    {
+        uint32_t ch = __CLZ(__RBIT(pend)) - 1; /* CC1IF 在位 1 */
+        pend &= pend - 1;
+        Motor_Step(table[ch], &ccr[ch]);
+    }
+
+    CCM_BENCH_ADD(&ccm_bench_step, CCM_CYCLES() - t0);
+}
+
+/**
+ * @brief  定时器输出比较中断回调 (HAL 分派路径)
+ * @note   MOTOR_CC_LL 为 0，或 CubeMX 重新生成后中断入口恢复为 HAL_TIM_IRQHandler 时走这里，
+ *         与寄存器级入口共用 Motor_Step
+ */
+void HAL_TIM_OC_DelayElapsedCallback(TIM_HandleTypeDef *htim)
+{
+    uint32_t t0 = CCM_CYCLES();
+    uint32_t ch = __CLZ(__RBIT((uint32_t)htim->Channel)); /* HAL_TIM_ACTIVE_CHANNEL_x 为 1/2/4/8 */
+
+    if (ch < 4 && (htim->Instance == TIM1 || htim->Instance == TIM2))
+        Motor_Step(motor_cc_table[htim->Instance == TIM2][ch], &(&htim->Instance->CCR1)[ch]);
+
+    CCM_BENCH_ADD(&ccm_bench_step, CCM_CYCLES() - t0);
+}
+
+/**
+ * @brief  msh 命令：比较中断分派开销对比 (HAL_TIM_IRQHandler vs 寄存器级)
+ * @note   电机全部停止时，在 TIM1 上用 EGR 软件产生比较事件后直接调用两种入口
+ *         (关中断，各 16 次取最小值)；停止的电机 Motor_Step 立即返回，测到的就是分派本身
+ */
+static void stepbench(int argc, char **argv)
+{
+    extern TIM_HandleTypeDef htim1;
+    static const uint32_t masks[] = {TIM_SR_CC1IF, MOTOR_CC_FLAGS};
+    static const char *const names[] = {"1 channel ", "4 channels"};
+
+    for (uint32_t i = 0; i < MOTOR_NUM; i++)
+    {
+        if (motor_list[i]->dir != 0)
         {
-            /* 根据速度方向进行加减 (用于计算里程) */
-            if (p_motor->speed > 0)
-                p_motor->total_steps++;
-            else
-                p_motor->total_steps--;
+            rt_kprintf("stop all motors first\n");
+            return;
         }
     }
-    else if (htim->Instance == TIM2)
+
+    CCM_Bench_t saved = ccm_bench_step; /* 软件事件不计入真实中断的统计 */
+    rt_kprintf("pending     HAL cyc   LL cyc\n");
+    for (uint32_t k = 0; k < 2; k++)
     {
-        /* 第 5 个电机挂在 TIM2_CH2 上 */
-        if (htim->Channel == HAL_TIM_ACTIVE_CHANNEL_2)
+        uint32_t best[2] = {UINT32_MAX, UINT32_MAX};
+        for (uint32_t path = 0; path < 2; path++)
         {
-            if (motor_5.speed != 0)
+            for (int r = 0; r < 16; r++)
             {
-                if (motor_5.speed > 0)
-                    motor_5.total_steps++;
+                uint32_t primask = __get_PRIMASK();
+                __disable_irq();
+                uint32_t dier = TIM1->DIER;
+                TIM1->DIER = dier | masks[k];
+                TIM1->EGR = masks[k]; /* CCxG 与 CCxIF 位号相同 */
+
+                uint32_t t0 = DWT->CYCCNT;
+                if (path == 0)
+                    HAL_TIM_IRQHandler(&htim1);
                 else
-                    motor_5.total_steps--;
+                    BSP_Motor_CC_IRQHandler(TIM1);
+                uint32_t cyc = DWT->CYCCNT - t0;
+
+                TIM1->DIER = dier;
+                NVIC_ClearPendingIRQ(TIM1_CC_IRQn);
+                __set_PRIMASK(primask);
+                if (cyc < best[path])
+                    best[path] = cyc;
             }
         }
+        rt_kprintf("%s %8u %8u\n", names[k], (unsigned)best[0], (unsigned)best[1]);
     }
+    ccm_bench_step = saved;
 }
+MSH_CMD_EXPORT(stepbench, step compare IRQ dispatch cycles: HAL vs register level);
 
 /**
  * @brief  获取电机累积步数 (原子操作，不依赖 RTOS)
@@ -12,15 +12,20 @@
 #include <stdint.h>
 #include "stm32f4xx_hal.h"
 #include "main.h"
+#include "bsp_motor_ramp.h"
 
 /**
  * @usage 使用说明:
  * 1. 初始化: 调用 BSP_Motor_Init()
- * 2. 控速:   调用 BSP_Motor_SetSpeed(&motor_1, 5000) (motor_1~5)
+ * 2. 控速:   调用 BSP_Motor_SetRate(&motor_1, 1560.0f) (motor_1~5，单位 步/s，负数反转)
  * 3. 停止:   调用 BSP_Motor_Stop(&motor_1)
  * 4. 读位置: 调用 BSP_Motor_GetSteps(&motor_1)
  * 5. 复位位置: 调用 BSP_Motor_ResetSteps(&motor_1)
  * 6. 使能:   调用 BSP_Motor_Enable(&motor_1, 1)  (1:开启, 0:关闭)
+ * 7. 加速度: 调用 BSP_Motor_SetAccel(&motor_1, 30000.0f) (步/s^2，0 表示步频立即跳变)
+ * 8. 联动:   调用 BSP_Motor_Coord_Start(steps, trim_dir, 5000.0f, 8000.0f)，再轮询 BSP_Motor_Coord_Busy()
+ *            (steps 为 motor_1~4 的带符号步数，所有轮在同一节拍走完)；
+ *            运行中可用 BSP_Motor_Coord_Trim(0.05f) 按 trim_dir 叠加差速修正 (如航向锁)
  */
 
 /* 电机硬件配置结构体 */
@@ -44,13 +49,53 @@ typedef struct
     uint8_t reverse; /* 是否反向：0-正常，1-反向 */
 } Motor_Config_t;
 
+/*
+ * 步频发生方式：定时器自由计数 (ARR = 0xFFFF)，每个通道在比较中断里把 CCR 向后推
+ * 一个 interval，于是同一定时器上的 4 个通道可以各跑各的频率 (不再共用 ARR)。
+ * "步" 指一次比较翻转，与 total_steps / PULSE_PER_MM 的计数口径一致。
+ *
+ * 步频与 interval 成严格反比：rate = tick_hz / interval，在整个量程内线性。
+ * 为兼顾爬行与高速，定时器按最慢的运行通道自动切换预分频档位 (见 bsp_motor.c)。
+ *
+ * 设置了加速度时，SetRate 只更新目标，比较中断每走一步按 AVR446 递推逼近目标
+ * (见 bsp_motor_ramp.c)；反向时先减速到零再翻转方向引脚。
+ */
+#define MOTOR_RATE_MAX 20000.0f /* 最高步频 (步/s)，受比较中断负载限制 */
+#define MOTOR_RATE_MIN 2.0f     /* 最低步频 (步/s)，低于此值按停止处理 */
+
+/*
+ * 多轴联动插补：步数最多的轮的通道产生节拍，按梯形曲线推进 (斜坡同上)；四个轮都在
+ * 节拍上按 DDA 分配步数，比较值与节拍相同，因而各轮步数比例精确、同一节拍走完。
+ * 节拍比最多的轮快 MOTOR_COORD_TRIM_MAX 倍，余量留给运行中叠加的差速修正。
+ */
+#define MOTOR_COORD_AXES 4        /* 参与联动的电机：motor_1~4 (同在 TIM1) */
+#define MOTOR_COORD_TRIM_MAX 0.25f /* 修正分量上限 (相对最多的轮的步频) */
+
+/*
+ * 比较中断入口：1 = stm32f4xx_it.c 直接调用 BSP_Motor_CC_IRQHandler (寄存器级，SR 只读一次、
+ * 查表分派)；0 = 走 HAL_TIM_IRQHandler -> HAL_TIM_OC_DelayElapsedCallback。两条路径共用步进逻辑。
+ */
+#define MOTOR_CC_LL 1
+
+/*
+ * 步进比较中断是否用 rt_interrupt_enter/leave 包裹：0 = 不包裹 (默认)，步进中断不调 IPC，
+ * 不需要推迟调度，也不让 trace / cpu_load 的中断钩子在每次翻转上运行 (其耗时计入被打断的线程)；
+ * 1 = 包裹，仅在需要用 trace 看步进中断时临时打开。
+ */
+#define MOTOR_CC_IRQ_HOOK 0
+
 /* 电机控制句柄结构体 */
 typedef struct
 {
-    Motor_Config_t config; /* 硬件配置 */
-    int32_t speed;         /* 当前速度 (-10000 到 10000) */
-    int32_t dead_zone;     /* 死区补偿值 */
-    int32_t total_steps;   /* 累计脉冲数 (用于控制距离/里程计) */
+    Motor_Config_t config;         /* 硬件配置 */
+    float rate;                    /* 目标步频 (步/s，带符号，0 为停止) */
+    float accel;                   /* 加速度 (步/s^2)，0 表示不做斜坡 */
+    volatile uint32_t interval;    /* 当前翻转间隔 (定时器计数，0 为停止)，中断中使用 */
+    volatile int8_t dir;           /* 当前实际方向：1 正转, -1 反转, 0 停止 */
+    volatile int8_t dir_target;    /* 目标方向 (与 dir 不同时中断先减速再换向) */
+    Motor_Ramp_t ramp;             /* 逐步加减速状态 */
+    int32_t dead_zone;             /* 死区补偿值 */
+    volatile int32_t total_steps;  /* 累计脉冲数 (用于控制距离/里程计) */
 } Motor_t;
 
 /* 声明外部可用电机示例 */
@@ -62,10 +107,17 @@ extern Motor_t motor_5;
 
 /* 函数接口 */
 void BSP_Motor_Init(void);
-void BSP_Motor_SetSpeed(Motor_t *motor, int32_t speed);
+void BSP_Motor_SetRate(Motor_t *motor, float steps_per_s);
+void BSP_Motor_SetAccel(Motor_t *motor, float steps_per_s2);
 void BSP_Motor_Stop(Motor_t *motor);
 void BSP_Motor_Enable(Motor_t *motor, uint8_t enable);
+int BSP_Motor_Coord_Start(const int32_t steps[MOTOR_COORD_AXES], const int8_t trim_dir[MOTOR_COORD_AXES],
+                          float rate, float accel);
+void BSP_Motor_Coord_Trim(float trim);
+uint8_t BSP_Motor_Coord_Busy(void);
+uint8_t BSP_Motor_Busy(void);
 int32_t BSP_Motor_GetSteps(Motor_t *motor);
 void BSP_Motor_ResetSteps(Motor_t *motor);
+void BSP_Motor_CC_IRQHandler(TIM_TypeDef *tim);
 
 #endif /* __BSP_MOTOR_H */
@@ -0,0 +1,125 @@
+/**
+ ******************************************************************************
+ * @file    bsp_motor_ramp.c
+ * @author  lingxing
+ * @brief   步进电机逐步加减速 (AVR446 / Austin 递推)
+ * @note    Motor_Ramp_Next 在比较中断中逐步调用，只用 32 位整数运算；
+ *          Config 需要开方、SetTarget 需要 64 位除法，只在线程上下文 (参数变化/换档时) 调用。
+ ******************************************************************************
+ */
+
+#include "bsp_motor_ramp.h"
+#include "bsp_ccm.h"
+#include <math.h>
+
+#define RAMP_C_MAX (0xFFFFu << MOTOR_RAMP_Q) /* 间隔上限 (与 16 位比较寄存器一致) */
+
+/**
+ * @brief  [内部函数] 由目标间隔反推步序号 (到达目标速度被钳位后据此重新对齐)
+ * @note   k / c^2 是 64 位除法，Cortex-M4 上走库函数，放在线程里预先算好
+ */
+static void Motor_Ramp_Target_N(Motor_Ramp_t *ramp)
+{
+    uint32_t ci = ramp->c_target >> MOTOR_RAMP_Q;
+
+    if (ci == 0)
+        ci = 1;
+    uint64_t n = ramp->k / ((uint64_t)ci * ci) + 1;
+    ramp->n_target = (n > 0x7FFFFFFF) ? 0x7FFFFFFF : (uint32_t)n;
+}
+
+/**
+ * @brief  配置加速度
+ * @param  tick_hz: 定时器计数频率
+ * @param  accel: 加速度 (步/s^2)，0 表示不做斜坡 (直接跳到目标间隔)
+ * @note   起步间隔 c0 = 0.676 * f * sqrt(2 / a)，0.676 为 AVR446 对首步误差的修正系数
+ */
+void Motor_Ramp_Config(Motor_Ramp_t *ramp, uint32_t tick_hz, float accel)
+{
+    if (accel <= 0.0f)
+    {
+        ramp->c0 = 0;
+        ramp->k = 0;
+        Motor_Ramp_Target_N(ramp);
+        return;
+    }
+
+    float c0 = 0.676f * (float)tick_hz * sqrtf(2.0f / accel) * (float)(1u << MOTOR_RAMP_Q);
+    ramp->c0 = (c0 > (float)RAMP_C_MAX) ? RAMP_C_MAX : (uint32_t)c0;
+    ramp->k = (uint64_t)((float)tick_hz * (float)tick_hz / (2.0f * accel));
+    Motor_Ramp_Target_N(ramp);
+}
+
+/**
+ * @brief  设置目标间隔 (定时器计数)
+ */
+void Motor_Ramp_SetTarget(Motor_Ramp_t *ramp, uint32_t interval)
+{
+    ramp->c_target = (interval > 0xFFFFu) ? RAMP_C_MAX : (interval << MOTOR_RAMP_Q);
+    Motor_Ramp_Target_N(ramp);
+}
+
+/**
+ * @brief  定时器换档后按新计数频率换算当前间隔 (步序号只与速度有关，保持不变)
+ */
+void Motor_Ramp_Rescale(Motor_Ramp_t *ramp, uint32_t tick_old, uint32_t tick_new)
+{
+    uint64_t c = (uint64_t)ramp->c * tick_new / tick_old;
+    ramp->c = (c > RAMP_C_MAX) ? RAMP_C_MAX : (uint32_t)c;
+}
+
+/**
+ * @brief  回到静止状态 (下次调用 Next 从起步间隔开始)
+ */
+RAM_FUNC void Motor_Ramp_Reset(Motor_Ramp_t *ramp)
+{
+    ramp->n = 0;
+}
+
+/**
+ * @brief  计算下一步的翻转间隔
+ * @param  stopping: 1 表示减速到静止 (用于换向)，减到 n = 0 后由调用方翻转方向
+ * @return 翻转间隔 (定时器计数，四舍五入)
+ */
+RAM_FUNC uint32_t Motor_Ramp_Next(Motor_Ramp_t *ramp, uint8_t stopping)
+{
+    if (ramp->c0 == 0)
+    {
+        /* 不做斜坡：直接按目标间隔输出，换向立即完成 */
+        ramp->c = ramp->c_target;
+        ramp->n = stopping ? 0 : 1;
+    }
+    else if (ramp->n == 0)
+    {
+        /* 起步：目标比起步速度还慢时直接按目标速度起步 */
+        ramp->c = (ramp->c_target > ramp->c0) ? ramp->c_target : ramp->c0;
+        ramp->n = 1;
+    }
+    else if (!stopping && ramp->c > ramp->c_target)
+    {
+        /* 加速 */
+        ramp->c -= (2 * ramp->c) / (4 * ramp->n + 1);
+        ramp->n++;
+        if (ramp->c <= ramp->c_target)
+        {
+            ramp->c = ramp->c_target;
+            ramp->n = ramp->n_target;
+        }
+    }
+    else if (stopping || ramp->c < ramp->c_target)
+    {
+        /* 减速：已回到起步间隔时再减一步即为静止 */
+        if (ramp->n > 1)
+            ramp->c += (2 * ramp->c) / (4 * ramp->n - 5);
+        if (ramp->c > RAMP_C_MAX)
+            ramp->c = RAMP_C_MAX;
+        ramp->n--;
+        if (!stopping && ramp->n > 0 && ramp->c >= ramp->c_target)
+        {
+            ramp->c = ramp->c_target;
+            ramp->n = ramp->n_target;
+        }
+    }
+
+    return (ramp->c + (1u << (MOTOR_RAMP_Q - 1))) >> MOTOR_RAMP_Q;
+}
@@ -0,0 +1,44 @@
+/**
+ ******************************************************************************
+ * @file    bsp_motor_ramp.h
+ * @author  lingxing
+ * @brief   步进电机逐步加减速 (AVR446 / Austin 递推)
+ ******************************************************************************
+ */
+
+#ifndef __BSP_MOTOR_RAMP_H
+#define __BSP_MOTOR_RAMP_H
+
+#include <stdint.h>
+
+/**
+ * @usage 使用说明:
+ * 1. 配置:   Motor_Ramp_Config(&ramp, tick_hz, accel)   (accel 单位 步/s^2，0 表示不做斜坡)
+ * 2. 设目标: Motor_Ramp_SetTarget(&ramp, interval)      (目标翻转间隔，单位 定时器计数)
+ * 3. 每步:   interval = Motor_Ramp_Next(&ramp, stopping) (在比较中断里调用，纯整数运算)
+ *
+ * 递推公式 (m 为当前间隔的斜坡序号，约等于 v^2 / 2a，c_0 为起步间隔):
+ *   加速: c_{m+1} = c_m - 2 * c_m / (4(m+1) + 1)
+ *   减速: c_{m-1} = c_m + 2 * c_m / (4m - 1)
+ * 间隔按 Q8 定点保存，避免逐步舍入误差累积。
+ */
+
+#define MOTOR_RAMP_Q 8 /* 间隔定点小数位数 */
+
+typedef struct
+{
+    uint32_t c;        /* 当前间隔 (Q8) */
+    uint32_t c_target; /* 目标间隔 (Q8) */
+    uint32_t c0;       /* 起步间隔 (Q8)，0 表示不做斜坡 */
+    uint32_t n;        /* 斜坡序号 m + 1，0 表示静止 */
+    uint64_t k;        /* 序号与间隔换算常数：m = k / c^2 (c 为整数计数) */
+    uint32_t n_target; /* 目标间隔对应的斜坡序号 (线程里算好，中断到达目标时直接取用) */
+} Motor_Ramp_t;
+
+void Motor_Ramp_Config(Motor_Ramp_t *ramp, uint32_t tick_hz, float accel);
+void Motor_Ramp_SetTarget(Motor_Ramp_t *ramp, uint32_t interval);
+void Motor_Ramp_Rescale(Motor_Ramp_t *ramp, uint32_t tick_old, uint32_t tick_new);
+void Motor_Ramp_Reset(Motor_Ramp_t *ramp);
+uint32_t Motor_Ramp_Next(Motor_Ramp_t *ramp, uint8_t stopping);
+
+#endif /* __BSP_MOTOR_RAMP_H */
@@ -0,0 +1,51 @@
+/**
+ ******************************************************************************
+ * @file    bsp_motor_range.c
+ * @author  lingxing
+ * @brief   步进电机预分频档位与比较间隔换算 (纯计算，不碰寄存器)
+ ******************************************************************************
+ */
+
+#include "bsp_motor_range.h"
+#include <math.h>
+
+const uint32_t motor_range_hz[MOTOR_RANGE_NUM] = {8000000, 1000000, 100000};
+
+/**
+ * @brief  档位的实际计数频率 (定时器时钟不能整除时按整数 PSC 取整)
+ */
+uint32_t Motor_Range_Tick(uint32_t clk_hz, uint8_t range)
+{
+    return clk_hz / (clk_hz / motor_range_hz[range]);
+}
+
+/**
+ * @brief  按最慢运行通道选择能装下其间隔的最细档位
+ * @param  cur: 当前档位 (往更细档位切时留 MOTOR_RANGE_HYST 余量)
+ * @param  slowest: 最慢运行通道的步频 (步/s，> 0)
+ */
+uint8_t Motor_Range_Select(uint32_t clk_hz, uint8_t cur, float slowest)
+{
+    for (uint8_t i = 0; i < MOTOR_RANGE_NUM; i++)
+    {
+        float limit = (float)MOTOR_INTERVAL_MAX;
+        if (i < cur)
+            limit *= MOTOR_RANGE_HYST;
+        if ((float)Motor_Range_Tick(clk_hz, i) / slowest <= limit)
+            return i;
+    }
+    return MOTOR_RANGE_NUM - 1;
+}
+
+/**
+ * @brief  步频 -> 比较间隔 (计数值，四舍五入并限幅)
+ */
+uint32_t Motor_Range_Interval(uint32_t tick_hz, float rate)
+{
+    long iv = lrintf((float)tick_hz / fabsf(rate));
+    if (iv < (long)MOTOR_INTERVAL_MIN)
+        return MOTOR_INTERVAL_MIN;
+    if (iv > (long)MOTOR_INTERVAL_MAX)
+        return MOTOR_INTERVAL_MAX;
+    return (uint32_t)iv;
+}
@@ -0,0 +1,38 @@
+/**
+ ******************************************************************************
+ * @file    bsp_motor_range.h
+ * @author  lingxing
+ * @brief   步进电机预分频档位与比较间隔换算 (纯计算，不碰寄存器)
+ ******************************************************************************
+ */
+
+#ifndef __BSP_MOTOR_RANGE_H
+#define __BSP_MOTOR_RANGE_H
+
+#include <stdint.h>
+
+/**
+ * @usage 使用说明:
+ * 1. 选档:   range = Motor_Range_Select(clk_hz, range, slowest)  (slowest 为该定时器上最慢运行通道的步频)
+ * 2. 计数频率: tick_hz = Motor_Range_Tick(clk_hz, range)          (PSC = clk_hz / tick_hz - 1)
+ * 3. 间隔:   iv = Motor_Range_Interval(tick_hz, rate)             (已限幅到 [MIN, MAX])
+ *
+ * 预分频档位 (计数频率，由细到粗)。按最慢运行通道选择能装下其间隔的最细档位：
+ *   8MHz   : 122 ~ 20000 步/s，量化误差 < 0.25%
+ *   1MHz   : 15.3 步/s 起
+ *   100kHz : 1.53 步/s 起
+ */
+
+#define MOTOR_INTERVAL_MAX 0xFFFFu /* 16 位比较间隔上限 (亦为 ARR) */
+#define MOTOR_INTERVAL_MIN 4u      /* 最小间隔，保证中断来得及推进 CCR */
+#define MOTOR_RANGE_NUM 3
+#define MOTOR_RANGE_DEFAULT 1 /* 上电默认档位 (1MHz，与原 CubeMX 配置相同) */
+#define MOTOR_RANGE_HYST 0.9f /* 切往更细档位时留 10% 余量，避免临界处来回切换 */
+
+extern const uint32_t motor_range_hz[MOTOR_RANGE_NUM];
+
+uint32_t Motor_Range_Tick(uint32_t clk_hz, uint8_t range);
+uint8_t Motor_Range_Select(uint32_t clk_hz, uint8_t cur, float slowest);
+uint32_t Motor_Range_Interval(uint32_t tick_hz, float rate);
+
+#endif /* __BSP_MOTOR_RANGE_H */
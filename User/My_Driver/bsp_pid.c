@@ -29,6 +29,10 @@ void BSP_PID_Init(PID_t *pid, float kp, float ki, float kd, float target, float
     pid->target = target;
     pid->output_limit = limit;
 
+    pid->ext_mode = 0;
+    pid->d_filter_tau = 0;
+    pid->slew_rate = 0;
+
     BSP_PID_Reset(pid);
 }
 
@@ -43,11 +47,20 @@ void BSP_PID_SetTarget(PID_t *pid, float target)
 
 /**
  * @brief  动态设置 PID 参数
+ * @note   无扰切换：ki 改变时按 ki_old / ki_new 换算累积量，保持 i_out = ki * integral 不跳变
+ *         (增益调度每拍都会改 ki)
  */
 void BSP_PID_SetParams(PID_t *pid, float kp, float ki, float kd)
 {
     if (pid)
     {
+        if (ki != pid->ki)
+        {
+            if (ki != 0.0f)
+                pid->integral *= pid->ki / ki;
+            else
+                pid->integral = 0.0f; /* 关掉积分：累积量不再有意义 */
+        }
         pid->kp = kp;
         pid->ki = ki;
         pid->kd = kd;
@@ -63,6 +76,20 @@ void BSP_PID_SetLimit(PID_t *pid, float limit)
         pid->output_limit = limit;
 }
 
+/**
+ * @brief  开启扩展模式
+ */
+void BSP_PID_SetExtMode(PID_t *pid, float d_filter_tau, float slew_rate)
+{
+    if (pid == NULL)
+        return;
+
+    pid->ext_mode = 1;
+    pid->d_filter_tau = (d_filter_tau > 0) ? d_filter_tau : 0;
+    pid->slew_rate = (slew_rate > 0) ? slew_rate : 0;
+    pid->ext_first = 1;
+}
+
 /**
  * @brief  位置式 PID 计算
  * @note   常用场景: 平衡偏角控制、舵机角度控制
@@ -133,6 +160,122 @@ float BSP_PID_CalcIncremental(PID_t *pid, float current)
     return pid->output;
 }
 
+/**
+ * @brief  [内部函数] 扩展模式公共部分：比例 + 条件积分 + 合成输出 + 斜率限制
+ * @note   调用前须已更新 pid->error 与 pid->d_out
+ */
+static float _BSP_PID_ExtOutput(PID_t *pid, float dt)
+{
+    /* 1. 比例项 */
+    pid->p_out = pid->kp * pid->error;
+
+    /* 2. 条件积分：输出已饱和且误差继续推向饱和方向时冻结积分 */
+    float unsat = pid->p_out + pid->ki * pid->integral + pid->d_out;
+    uint8_t push_high = (unsat >= pid->output_limit) && (pid->error > 0);
+    uint8_t push_low = (unsat <= -pid->output_limit) && (pid->error < 0);
+    if (!push_high && !push_low)
+        pid->integral += pid->error * dt;
+
+    /* 积分项贡献限幅：i_out 最大为输出限幅的 80%
+       (经典模式限的是每拍累加的 integral 本身；这里 integral 按秒累计，故按 ki 换算成对 i_out 的限幅) */
+    if (pid->ki != 0.0f)
+    {
+        float i_limit = pid->output_limit * 0.8f / (pid->ki > 0 ? pid->ki : -pid->ki);
+        if (pid->integral > i_limit)
+            pid->integral = i_limit;
+        if (pid->integral < -i_limit)
+            pid->integral = -i_limit;
+    }
+    pid->i_out = pid->ki * pid->integral;
+
+    /* 3. 合成输出 + 斜率限制 */
+    float out = pid->p_out + pid->i_out + pid->d_out;
+    if (pid->slew_rate > 0.0f)
+    {
+        float max_step = pid->slew_rate * dt;
+        if (out > pid->output + max_step)
+            out = pid->output + max_step;
+        if (out < pid->output - max_step)
+            out = pid->output - max_step;
+    }
+    pid->output = out;
+    pid->last_error = pid->error;
+
+    /* 4. 输出限幅 */
+    _BSP_PID_Limit(pid);
+
+    return pid->output;
+}
+
+/**
+ * @brief  位置式 PID 计算 (扩展模式)
+ * @note   常用场景: 采样周期有抖动的 RTOS 线程内闭环 (航向锁、转向环)
+ */
+float BSP_PID_CalcPositionalDt(PID_t *pid, float current, float dt)
+{
+    if (pid == NULL)
+        return 0.0f;
+
+    if (!pid->ext_mode)
+        return BSP_PID_CalcPositional(pid, current);
+
+    /* dt 非法时 (时钟回绕/重复调用) 按 0 处理：积分、微分与斜率状态均不推进 */
+    if (dt < 0.0f)
+        dt = 0.0f;
+
+    pid->current = current;
+    pid->error = pid->target - pid->current;
+
+    /* 首次计算：以当前测量值初始化历史，避免 D 项冲击 */
+    if (pid->ext_first)
+    {
+        pid->last_current = current;
+        pid->d_filtered = 0;
+        pid->ext_first = 0;
+    }
+
+    /* 微分先行 (对测量值求导) + 一阶低通滤波 */
+    if (dt > 0.0f)
+    {
+        float d_raw = -(current - pid->last_current) / dt;
+        if (pid->d_filter_tau > 0.0f)
+            pid->d_filtered += (dt / (pid->d_filter_tau + dt)) * (d_raw - pid->d_filtered);
+        else
+            pid->d_filtered = d_raw;
+    }
+    pid->last_current = current;
+    pid->d_out = pid->kd * pid->d_filtered;
+
+    return _BSP_PID_ExtOutput(pid, dt);
+}
+
+/**
+ * @brief  位置式 PID 计算 (扩展模式，测量变化率由传感器直接给出)
+ * @note   常用场景: 航向环用陀螺角速度做 D 项，无需差分与滤波，也没有滞后
+ */
+float BSP_PID_CalcPositionalRate(PID_t *pid, float current, float rate, float dt)
+{
+    if (pid == NULL)
+        return 0.0f;
+
+    if (!pid->ext_mode)
+        return BSP_PID_CalcPositional(pid, current);
+
+    if (dt < 0.0f)
+        dt = 0.0f;
+
+    pid->current = current;
+    pid->error = pid->target - pid->current;
+
+    /* 保持差分历史同步，之后切回 CalcPositionalDt 时不会产生 D 项冲击 */
+    pid->last_current = current;
+    pid->d_filtered = -rate;
+    pid->ext_first = 0;
+    pid->d_out = pid->kd * pid->d_filtered;
+
+    return _BSP_PID_ExtOutput(pid, dt);
+}
+
 /**
  * @brief  复位 PID 数据
  */
@@ -148,6 +291,10 @@ void BSP_PID_Reset(PID_t *pid)
     pid->integral = 0;
     pid->p_out = pid->i_out = pid->d_out = 0;
     pid->output = 0;
+
+    pid->ext_first = 1;
+    pid->last_current = 0;
+    pid->d_filtered = 0;
 }
 
 /**
@@ -24,6 +24,12 @@
  * 3. 独立计算:
  *    out1 = BSP_PID_CalcPositional(&pid_bal, ang);    // 这里用平衡的参数算
  *    out2 = BSP_PID_CalcIncremental(&pid_speed, rpm); // 这里用速度的参数算
+ *
+ * 4. 扩展模式 (时间感知, 可选):
+ *    BSP_PID_Init(&pid_yaw, 1.9, 0.5, 0.025, 0, 200); // ki/kd 按秒计 (连续域系数)
+ *    BSP_PID_SetExtMode(&pid_yaw, 0.05, 2000);         // D 项滤波 50ms, 输出斜率 2000/s
+ *    out3 = BSP_PID_CalcPositionalDt(&pid_yaw, yaw, dt); // dt: 实测采样周期 (秒)
+ *    out4 = BSP_PID_CalcPositionalRate(&pid_yaw, yaw, gz, dt); // D 项直接用陀螺角速度
  */
 
 /* PID 控制器结构体 */
@@ -48,6 +54,14 @@ typedef struct
     float p_out, i_out, d_out; /* 三项分量输出 (方便调试) */
     float output;
     float output_limit; /* 输出限幅 */
+
+    /* 扩展模式 (仅 BSP_PID_CalcPositionalDt 使用) */
+    uint8_t ext_mode;   /* 0: 经典模式, 1: 扩展模式 */
+    uint8_t ext_first;  /* 首次计算标志 (用于初始化测量值历史) */
+    float d_filter_tau; /* D 项一阶低通时间常数 (s), 0 表示不滤波 */
+    float slew_rate;    /* 输出变化率限制 (单位/s), 0 表示不限 */
+    float last_current; /* 上次测量值 (微分先行) */
+    float d_filtered;   /* 滤波后的测量值变化率 */
 } PID_t;
 
 /* --- 用户 API 接口 --- */
@@ -64,10 +78,19 @@ void BSP_PID_Init(PID_t *pid, float kp, float ki, float kd, float target, float
  * @brief  设置控制参数
  */
 void BSP_PID_SetTarget(PID_t *pid, float target);
-void BSP_PID_SetParams(PID_t *pid, float kp, float ki, float kd);
+void BSP_PID_SetParams(PID_t *pid, float kp, float ki, float kd); /* ki 改变时积分无扰换算 */
 void BSP_PID_SetLimit(PID_t *pid, float limit);
 void BSP_PID_Reset(PID_t *pid);
 
+/**
+ * @brief  开启扩展模式 (时间感知 + 微分先行 + D 项滤波 + 输出斜率限制)
+ * @param  d_filter_tau: D 项一阶低通时间常数 (s), 0 表示不滤波
+ * @param  slew_rate: 输出最大变化率 (单位/s), 0 表示不限
+ * @note   扩展模式下 ki/kd 为连续域系数 (按秒计)，与经典模式的“每拍”系数换算关系:
+ *         ki_ext = ki / Ts, kd_ext = kd * Ts (Ts 为经典模式下的采样周期)
+ */
+void BSP_PID_SetExtMode(PID_t *pid, float d_filter_tau, float slew_rate);
+
 /**
  * @brief  PID 计算核心 (位置式)
  * @param  current: 当前物理量测量值
@@ -82,4 +105,24 @@ float BSP_PID_CalcPositional(PID_t *pid, float current);
  */
 float BSP_PID_CalcIncremental(PID_t *pid, float current);
 
+/**
+ * @brief  PID 计算核心 (位置式, 扩展模式)
+ * @param  current: 当前物理量测量值
+ * @param  dt: 距上次计算的实际时间间隔 (秒)
+ * @return 计算后的控制量输出
+ * @note   D 项对测量值求导 (改目标不产生微分冲击)，积分采用条件积分抗饱和。
+ *         未调用 BSP_PID_SetExtMode 时退化为 BSP_PID_CalcPositional。
+ */
+float BSP_PID_CalcPositionalDt(PID_t *pid, float current, float dt);
+
+/**
+ * @brief  PID 计算核心 (位置式, 扩展模式, 外部给出测量变化率)
+ * @param  current: 当前物理量测量值
+ * @param  rate: 测量值变化率 (单位/s)，例如陀螺角速度
+ * @param  dt: 距上次计算的实际时间间隔 (秒)
+ * @return 计算后的控制量输出
+ * @note   与 BSP_PID_CalcPositionalDt 相同，只是 D 项直接取 -kd * rate (不差分、不滤波)。
+ */
+float BSP_PID_CalcPositionalRate(PID_t *pid, float current, float rate, float dt);
+
 #endif /* __BSP_PID_H */
@@ -15,14 +15,16 @@
 #include "../My_App/app_imu_proc.h"
 #include "../My_App/app_vision_proc.h"
 #include "../My_App/app_qr_proc.h"
+#include "../My_App/app_telem_proc.h"
 
 /*
  * [保姆级修复]:
  * 由于 RT-Thread Studio 编译 CubeMX 文件夹时可能会漏掉变量定义，
- * 我们在这里强行手动定义这三个串口句柄，确保链接器能找到它们。
+ * 我们在这里强行手动定义这四个串口句柄，确保链接器能找到它们。
  */
 UART_HandleTypeDef huart1;
 UART_HandleTypeDef huart2;
+UART_HandleTypeDef huart3;
 UART_HandleTypeDef huart6;
 
 /* 实例化串口 1 (二维码) */
@@ -37,22 +39,71 @@ UART_t uart2_imu = {
     .rx_flag = 0,
     .rx_len = 0};
 
+/* 实例化串口 3 (遥测，只发不收) */
+UART_t uart3_telem = {
+    .huart = &huart3,
+    .rx_flag = 0,
+    .rx_len = 0};
+
 /* 实例化串口 6 (物料识别) */
 UART_t uart6_vision = {
     .huart = &huart6,
     .rx_flag = 0,
     .rx_len = 0};
 
+/**
+ * @brief  [内部函数] 停止 DMA 接收 (寄存器级)
+ * @return DMA 已写入接收块的字节数
+ * @note   接收不经 HAL 状态机：HAL_UART_Receive_DMA 在 RxState / DMA 句柄状态不对时返回 BUSY，
+ *         空闲中断里重开失败就会停收到下一次空闲，而下一次空闲算出的长度来自旧的计数
+ */
+static uint16_t UART_Rx_Stop(UART_t *uart)
+{
+    DMA_Stream_TypeDef *stream = uart->huart->hdmarx->Instance;
+
+    CLEAR_BIT(uart->huart->Instance->CR3, USART_CR3_DMAR);
+    stream->CR &= ~DMA_SxCR_EN;
+    while (stream->CR & DMA_SxCR_EN) /* 当前这一拍搬完才真正停下 (几个总线周期) */
+        ;
+    return UART_RX_BUF_SIZE - (uint16_t)stream->NDTR;
+}
+
+/**
+ * @brief  [内部函数] 从 rx_frame 开头重新开始 DMA 接收 (寄存器级，须先 UART_Rx_Stop)
+ */
+static void UART_Rx_Start(UART_t *uart)
+{
+    DMA_HandleTypeDef *hdma = uart->huart->hdmarx;
+    DMA_Stream_TypeDef *stream = hdma->Instance;
+
+    __HAL_DMA_CLEAR_FLAG(hdma, __HAL_DMA_GET_TC_FLAG_INDEX(hdma) | __HAL_DMA_GET_HT_FLAG_INDEX(hdma) |
+                                   __HAL_DMA_GET_TE_FLAG_INDEX(hdma) | __HAL_DMA_GET_DME_FLAG_INDEX(hdma) |
+                                   __HAL_DMA_GET_FE_FLAG_INDEX(hdma));
+    stream->PAR = (uint32_t)&uart->huart->Instance->DR;
+    stream->M0AR = (uint32_t)uart->rx_frame->data;
+    stream->NDTR = UART_RX_BUF_SIZE;
+    stream->CR |= DMA_SxCR_EN;
+    SET_BIT(uart->huart->Instance->CR3, USART_CR3_DMAR);
+    uart->rx_armed = 1;
+}
+
 /**
  * @brief  初始化串口 DMA 接收及空闲中断
  */
 void BSP_UART_Init(UART_t *uart)
 {
+    /* 首次初始化领一个接收块 (改波特率重进时沿用原块) */
+    if (uart->rx_frame == RT_NULL)
+        uart->rx_frame = Frame_Alloc();
+    if (uart->rx_frame == RT_NULL)
+        return;
+
+    /* 开启 DMA 接收 (从块开头收起，之前块里的内容作废) */
+    UART_Rx_Stop(uart);
+    UART_Rx_Start(uart);
+
     /* 开启空闲中断 */
     __HAL_UART_ENABLE_IT(uart->huart, UART_IT_IDLE);
-
-    /* 开启 DMA 循环接收 */
-    HAL_UART_Receive_DMA(uart->huart, uart->rx_buffer, UART_RX_BUF_SIZE);
 }
 
 /**
@@ -63,6 +114,18 @@ void BSP_UART_Send(UART_t *uart, uint8_t *data, uint16_t len)
     HAL_UART_Transmit(uart->huart, data, len, 100);
 }
 
+/**
+ * @brief  串口 DMA 发送 (非阻塞)
+ * @return 0: 已启动, -1: 上一次发送未完成或启动失败
+ * @note   data 须位于 DMA 可访问的 SRAM，且在发送完成回调前保持不变
+ */
+int BSP_UART_Send_DMA(UART_t *uart, uint8_t *data, uint16_t len)
+{
+    if (HAL_UART_Transmit_DMA(uart->huart, data, len) != HAL_OK)
+        return -1;
+    return 0;
+}
+
 /**
  * @brief  格式化打印
  */
@@ -79,6 +142,29 @@ void BSP_UART_printf(UART_t *uart, const char *format, ...)
     BSP_UART_Send(uart, (uint8_t *)buf, len);
 }
 
+/**
+ * @brief  运行时修改波特率
+ * @note   先关空闲中断、按寄存器停 DMA 接收，再停发送并重新初始化外设，最后按 BSP_UART_Init
+ *         重开 DMA + 空闲中断 (只发不收的串口没有接收块，不开接收)。
+ *         旧波特率下收了一半的块作废，不会被当成一帧投出去
+ */
+void BSP_UART_SetBaud(UART_t *uart, uint32_t baud)
+{
+    __HAL_UART_DISABLE_IT(uart->huart, UART_IT_IDLE);
+    if (uart->rx_frame != RT_NULL)
+    {
+        UART_Rx_Stop(uart);
+        uart->rx_armed = 0;
+    }
+    HAL_UART_DMAStop(uart->huart); /* 接收已停 (DMAR 已清)，这里只停进行中的 DMA 发送 */
+
+    uart->huart->Init.BaudRate = baud;
+    HAL_UART_Init(uart->huart);
+
+    if (uart->rx_frame != RT_NULL)
+        BSP_UART_Init(uart);
+}
+
 /**
  * @brief  串口空闲中断回调
  */
@@ -86,34 +172,61 @@ void BSP_UART_IdleCallback(UART_t *uart)
 {
     if (__HAL_UART_GET_FLAG(uart->huart, UART_FLAG_IDLE) != RESET)
     {
-        /* 1. 清除空闲中断标志 (HAL 要求的特定序列：读状态再读数据) */
+        /* 1. 清除空闲中断标志 (HAL 要求的特定序列：读状态再读数据，顺带清掉溢出标志) */
         __HAL_UART_CLEAR_IDLEFLAG(uart->huart);
+        if (uart->rx_frame == RT_NULL)
+            return; /* 没开接收的串口 */
 
-        /* 2. 停止 DMA 接收，计算长度 */
-        HAL_UART_DMAStop(uart->huart);
+        /* 2~3. 停止 DMA 接收 (只停接收：DMAStop 会把同一串口正在进行的 DMA 发送一起掐断)，
+         *      接收到的字节数 = 总长度 - 剩余传输计数；DMA 没在往这个块里收时一律不投 */
+        uint16_t len = UART_Rx_Stop(uart);
+        uart->rx_len = uart->rx_armed ? len : 0;
+        uart->rx_armed = 0;
 
-        /* 3. 计算接收到的字节数 = 总长度 - 剩余传输计数 */
-        uart->rx_len = UART_RX_BUF_SIZE - __HAL_DMA_GET_COUNTER(uart->huart->hdmarx);
-
-        /* 4. 【核心路由】通过消息队列通知 App 线程 (生产者模式) */
-        uint32_t msg = uart->rx_len; /* 携带本次接收的数据长度 */
+        /* 4. 【核心路由】把收满的帧块投给 App 线程 (生产者模式)，换新块接着收 */
+        rt_mq_t mq = RT_NULL;
         if (uart->huart == &huart2)
-        {
-            rt_mq_send(imu_mq, &msg, sizeof(msg));
-        }
+            mq = imu_mq;
         else if (uart->huart == &huart1)
+            mq = qr_mq; /* 二维码数据就绪 */
+        else if (uart->huart == &huart6)
+            mq = vision_mq;
+
+        Frame_t *next = (mq != RT_NULL && uart->rx_len > 0) ? Frame_Alloc() : RT_NULL;
+        if (next != RT_NULL)
         {
-            rt_mq_send(qr_mq, &msg, sizeof(msg)); /* 二维码数据就绪 */
+            Frame_t *done = uart->rx_frame;
+            done->len = uart->rx_len;
+            if (rt_mq_send(mq, &done, sizeof(done)) == RT_EOK)
+            {
+                uart->rx_frame = next;
+            }
+            else
+            {
+                Frame_Free(next); /* 队列满：丢本帧，原块继续用 */
+                uart->rx_drop++;
+            }
         }
-        else if (uart->huart == &huart6)
+        else if (mq != RT_NULL && uart->rx_len > 0)
         {
-            rt_mq_send(vision_mq, &msg, sizeof(msg));
+            uart->rx_drop++; /* 池空：丢本帧，原块继续用 */
         }
 
         /* 5. 设置标志位给应用层 */
         uart->rx_flag = 1;
 
-        /* 5. 重新开启 DMA 接收 */
-        HAL_UART_Receive_DMA(uart->huart, uart->rx_buffer, UART_RX_BUF_SIZE);
+        /* 6. 重新开启 DMA 接收 */
+        UART_Rx_Start(uart);
+    }
+}
+
+/**
+ * @brief  HAL 串口发送完成回调 (DMA 发送结束后在中断中调用)
+ */
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+    if (huart == &huart3)
+    {
+        App_Telem_TxDone(); /* 遥测线程可以发下一段 */
     }
 }
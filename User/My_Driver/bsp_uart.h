@@ -10,34 +10,48 @@
 #define __BSP_UART_H
 
 #include "main.h"
+#include "../Components/frame_pool.h"
 
 /**
  * @usage 使用说明:
- * 1. 初始化: 调用 BSP_UART_Init(&uart2_imu)
+ * 1. 初始化: 调用 BSP_UART_Init(&uart2_imu) (须在帧内存池与对应 App 的消息队列创建之后)
  * 2. 发送:   调用 BSP_UART_Send(&uart2_imu, data, len)
- * 3. 接收:   数据自动进入 rx_buffer，通过 rx_flag 判断新数据
+ * 3. 接收:   DMA 收进 rx_frame (帧内存池的块)，空闲中断把块指针投给对应 App 的消息队列，
+ *            换一个新块继续收；App 解析完调用 Frame_Free 归还 (见 frame_pool.h)。
+ *            池空或队列满时丢弃本帧 (rx_drop 计数)，沿用原块接收。
+ *            HAL_UART_IRQHandler 不处理 IDLE，须在 USARTx_IRQHandler 里先调 BSP_UART_IdleCallback。
+ *            接收 DMA 直接按寄存器开停，不经 HAL 状态机，发送 (阻塞或 DMA) 进行中也能照常重开
+ * 4. 改波特率: 调用 BSP_UART_SetBaud(&uart2_imu, 230400) (已开启接收的串口会重新开启 DMA 接收)
+ * 5. DMA 发送: 调用 BSP_UART_Send_DMA(&uart3_telem, data, len)，立即返回，
+ *    发送完成由 HAL_UART_TxCpltCallback 通知对应 App；发送期间 data 不得改动
  */
 
-#define UART_RX_BUF_SIZE 128
+#define UART_RX_BUF_SIZE FRAME_DATA_SIZE
 
 /* 串口控制结构体 */
 typedef struct
 {
     UART_HandleTypeDef *huart; /* HAL 串口句柄 */
 
-    uint8_t rx_buffer[UART_RX_BUF_SIZE]; /* 接收缓冲区 */
-    uint16_t rx_len;                     /* 最近一次接收长度 */
-    uint8_t rx_flag;                     /* 接收完成标志 */
+    Frame_t *rx_frame; /* DMA 正在接收的帧块 */
+    uint32_t rx_drop;  /* 池空 / 队列满丢弃的帧数 */
+    uint16_t rx_len;   /* 最近一次接收长度 */
+    uint8_t rx_flag;   /* 接收完成标志 */
+    uint8_t rx_armed;  /* DMA 正在往 rx_frame 里收 (否则空闲时不投递) */
 } UART_t;
 
 /* 声明外部可用串口实例 */
 extern UART_t uart1_qr;     /* 串口 1: 二维码识别摄像头 */
 extern UART_t uart2_imu;    /* 串口 2: IMU 陀螺仪 */
+extern UART_t uart3_telem;  /* 串口 3: 二进制遥测输出 */
 extern UART_t uart6_vision; /* 串口 6: 物料识别摄像头 */
 
 /* 函数接口 */
 void BSP_UART_Init(UART_t *uart);
 void BSP_UART_Send(UART_t *uart, uint8_t *data, uint16_t len);
+int BSP_UART_Send_DMA(UART_t *uart, uint8_t *data, uint16_t len);
 void BSP_UART_printf(UART_t *uart, const char *format, ...);
+void BSP_UART_SetBaud(UART_t *uart, uint32_t baud);
+void BSP_UART_IdleCallback(UART_t *uart);
 
 #endif /* __BSP_UART_H */
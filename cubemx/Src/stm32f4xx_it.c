@@ -22,6 +22,13 @@
 #include "stm32f4xx_it.h"
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+/* 外设中断统一用 rt_interrupt_enter/leave 包裹：中断里发出的 IPC 把调度推迟到退出中断时，
+ * 内核的中断进出钩子 (trace 记录器) 也依赖这一对调用。
+ * 例外是 TIM1_CC：步进中断不调 IPC，每次翻转都跑钩子不划算，见 MOTOR_CC_IRQ_HOOK */
+#include <rtthread.h>
+#include "../../User/Components/irq_lat.h"
+#include "../../User/My_Driver/bsp_motor.h"
+#include "../../User/My_Driver/bsp_uart.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -65,6 +72,7 @@ extern DMA_HandleTypeDef hdma_usart3_tx;
 extern DMA_HandleTypeDef hdma_usart6_rx;
 extern DMA_HandleTypeDef hdma_usart6_tx;
 extern UART_HandleTypeDef huart1;
+extern UART_HandleTypeDef huart2;
 extern UART_HandleTypeDef huart3;
 extern UART_HandleTypeDef huart6;
 /* USER CODE BEGIN EV */
@@ -221,11 +229,13 @@ void SysTick_Handler(void)
 void DMA1_Stream1_IRQHandler(void)
 {
   /* USER CODE BEGIN DMA1_Stream1_IRQn 0 */
-
+  rt_interrupt_enter();
+  IRQ_LAT_ENTER();
   /* USER CODE END DMA1_Stream1_IRQn 0 */
   HAL_DMA_IRQHandler(&hdma_usart3_rx);
   /* USER CODE BEGIN DMA1_Stream1_IRQn 1 */
-
+  IRQ_LAT_LEAVE();
+  rt_interrupt_leave();
   /* USER CODE END DMA1_Stream1_IRQn 1 */
 }
 
@@ -235,11 +245,13 @@ void DMA1_Stream1_IRQHandler(void)
 void DMA1_Stream3_IRQHandler(void)
 {
   /* USER CODE BEGIN DMA1_Stream3_IRQn 0 */
-
+  rt_interrupt_enter();
+  IRQ_LAT_ENTER();
   /* USER CODE END DMA1_Stream3_IRQn 0 */
   HAL_DMA_IRQHandler(&hdma_usart3_tx);
   /* USER CODE BEGIN DMA1_Stream3_IRQn 1 */
-
+  IRQ_LAT_LEAVE();
+  rt_interrupt_leave();
   /* USER CODE END DMA1_Stream3_IRQn 1 */
 }
 
@@ -249,11 +261,13 @@ void DMA1_Stream3_IRQHandler(void)
 void DMA1_Stream5_IRQHandler(void)
 {
   /* USER CODE BEGIN DMA1_Stream5_IRQn 0 */
-
+  rt_interrupt_enter();
+  IRQ_LAT_ENTER();
   /* USER CODE END DMA1_Stream5_IRQn 0 */
   HAL_DMA_IRQHandler(&hdma_usart2_rx);
   /* USER CODE BEGIN DMA1_Stream5_IRQn 1 */
-
+  IRQ_LAT_LEAVE();
+  rt_interrupt_leave();
   /* USER CODE END DMA1_Stream5_IRQn 1 */
 }
 
@@ -263,11 +277,13 @@ void DMA1_Stream5_IRQHandler(void)
 void DMA1_Stream6_IRQHandler(void)
 {
   /* USER CODE BEGIN DMA1_Stream6_IRQn 0 */
-
+  rt_interrupt_enter();
+  IRQ_LAT_ENTER();
   /* USER CODE END DMA1_Stream6_IRQn 0 */
   HAL_DMA_IRQHandler(&hdma_usart2_tx);
   /* USER CODE BEGIN DMA1_Stream6_IRQn 1 */
-
+  IRQ_LAT_LEAVE();
+  rt_interrupt_leave();
   /* USER CODE END DMA1_Stream6_IRQn 1 */
 }
 
@@ -277,11 +293,26 @@ void DMA1_Stream6_IRQHandler(void)
 void TIM1_CC_IRQHandler(void)
 {
   /* USER CODE BEGIN TIM1_CC_IRQn 0 */
-
+#if MOTOR_CC_IRQ_HOOK
+  rt_interrupt_enter();
+#endif
+  IRQ_LAT_ENTER_TIM(TIM1, 1);
+#if MOTOR_CC_LL
+  /* 步进比较中断走寄存器级入口，跳过下面 HAL_TIM_IRQHandler 的逐标志分派 */
+  BSP_Motor_CC_IRQHandler(TIM1);
+  IRQ_LAT_LEAVE();
+#if MOTOR_CC_IRQ_HOOK
+  rt_interrupt_leave();
+#endif
+  return;
+#endif
   /* USER CODE END TIM1_CC_IRQn 0 */
   HAL_TIM_IRQHandler(&htim1);
   /* USER CODE BEGIN TIM1_CC_IRQn 1 */
-
+  IRQ_LAT_LEAVE();
+#if MOTOR_CC_IRQ_HOOK
+  rt_interrupt_leave();
+#endif
   /* USER CODE END TIM1_CC_IRQn 1 */
 }
 
@@ -291,25 +322,47 @@ void TIM1_CC_IRQHandler(void)
 void USART1_IRQHandler(void)
 {
   /* USER CODE BEGIN USART1_IRQn 0 */
-
+  rt_interrupt_enter();
+  IRQ_LAT_ENTER();
+  BSP_UART_IdleCallback(&uart1_qr); /* HAL_UART_IRQHandler 不处理 IDLE，帧结束在这里投递 */
   /* USER CODE END USART1_IRQn 0 */
   HAL_UART_IRQHandler(&huart1);
   /* USER CODE BEGIN USART1_IRQn 1 */
-
+  IRQ_LAT_LEAVE();
+  rt_interrupt_leave();
   /* USER CODE END USART1_IRQn 1 */
 }
 
+/**
+ * @brief This function handles USART2 global interrupt.
+ */
+void USART2_IRQHandler(void)
+{
+  /* USER CODE BEGIN USART2_IRQn 0 */
+  rt_interrupt_enter();
+  IRQ_LAT_ENTER();
+  BSP_UART_IdleCallback(&uart2_imu);
+  /* USER CODE END USART2_IRQn 0 */
+  HAL_UART_IRQHandler(&huart2);
+  /* USER CODE BEGIN USART2_IRQn 1 */
+  IRQ_LAT_LEAVE();
+  rt_interrupt_leave();
+  /* USER CODE END USART2_IRQn 1 */
+}
+
 /**
  * @brief This function handles USART3 global interrupt.
  */
 void USART3_IRQHandler(void)
 {
   /* USER CODE BEGIN USART3_IRQn 0 */
-
+  rt_interrupt_enter();
+  IRQ_LAT_ENTER();
   /* USER CODE END USART3_IRQn 0 */
   HAL_UART_IRQHandler(&huart3);
   /* USER CODE BEGIN USART3_IRQn 1 */
-
+  IRQ_LAT_LEAVE();
+  rt_interrupt_leave();
   /* USER CODE END USART3_IRQn 1 */
 }
 
@@ -319,11 +372,13 @@ void USART3_IRQHandler(void)
 void DMA2_Stream1_IRQHandler(void)
 {
   /* USER CODE BEGIN DMA2_Stream1_IRQn 0 */
-
+  rt_interrupt_enter();
+  IRQ_LAT_ENTER();
   /* USER CODE END DMA2_Stream1_IRQn 0 */
   HAL_DMA_IRQHandler(&hdma_usart6_rx);
   /* USER CODE BEGIN DMA2_Stream1_IRQn 1 */
-
+  IRQ_LAT_LEAVE();
+  rt_interrupt_leave();
   /* USER CODE END DMA2_Stream1_IRQn 1 */
 }
 
@@ -333,11 +388,13 @@ void DMA2_Stream1_IRQHandler(void)
 void DMA2_Stream2_IRQHandler(void)
 {
   /* USER CODE BEGIN DMA2_Stream2_IRQn 0 */
-
+  rt_interrupt_enter();
+  IRQ_LAT_ENTER();
   /* USER CODE END DMA2_Stream2_IRQn 0 */
   HAL_DMA_IRQHandler(&hdma_usart1_rx);
   /* USER CODE BEGIN DMA2_Stream2_IRQn 1 */
-
+  IRQ_LAT_LEAVE();
+  rt_interrupt_leave();
   /* USER CODE END DMA2_Stream2_IRQn 1 */
 }
 
@@ -347,11 +404,13 @@ void DMA2_Stream2_IRQHandler(void)
 void DMA2_Stream6_IRQHandler(void)
 {
   /* USER CODE BEGIN DMA2_Stream6_IRQn 0 */
-
+  rt_interrupt_enter();
+  IRQ_LAT_ENTER();
   /* USER CODE END DMA2_Stream6_IRQn 0 */
   HAL_DMA_IRQHandler(&hdma_usart6_tx);
   /* USER CODE BEGIN DMA2_Stream6_IRQn 1 */
-
+  IRQ_LAT_LEAVE();
+  rt_interrupt_leave();
   /* USER CODE END DMA2_Stream6_IRQn 1 */
 }
 
@@ -361,11 +420,13 @@ void DMA2_Stream6_IRQHandler(void)
 void DMA2_Stream7_IRQHandler(void)
 {
   /* USER CODE BEGIN DMA2_Stream7_IRQn 0 */
-
+  rt_interrupt_enter();
+  IRQ_LAT_ENTER();
   /* USER CODE END DMA2_Stream7_IRQn 0 */
   HAL_DMA_IRQHandler(&hdma_usart1_tx);
   /* USER CODE BEGIN DMA2_Stream7_IRQn 1 */
-
+  IRQ_LAT_LEAVE();
+  rt_interrupt_leave();
   /* USER CODE END DMA2_Stream7_IRQn 1 */
 }
 
@@ -375,11 +436,14 @@ void DMA2_Stream7_IRQHandler(void)
 void USART6_IRQHandler(void)
 {
   /* USER CODE BEGIN USART6_IRQn 0 */
-
+  rt_interrupt_enter();
+  IRQ_LAT_ENTER();
+  BSP_UART_IdleCallback(&uart6_vision);
   /* USER CODE END USART6_IRQn 0 */
   HAL_UART_IRQHandler(&huart6);
   /* USER CODE BEGIN USART6_IRQn 1 */
-
+  IRQ_LAT_LEAVE();
+  rt_interrupt_leave();
   /* USER CODE END USART6_IRQn 1 */
 }
 
@@ -360,7 +360,7 @@ extern "C"
      *
      */
 
-    /*#define BSP_USING_ON_CHIP_FLASH*/
+#define BSP_USING_ON_CHIP_FLASH
 
     /*-------------------------- ON_CHIP_FLASH CONFIG END --------------------------*/
 
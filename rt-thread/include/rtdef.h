@@ -257,7 +257,7 @@ typedef int (*init_fn_t)(void);
                                 {__rti_level_##fn, fn };
     #endif
 #else
-    #if RT_DEBUG_INIT
+    #if RT_DEBUG_INIT || defined(RT_USING_INIT_PROFILE)
         struct rt_init_desc
         {
             const char* fn_name;
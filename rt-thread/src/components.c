@@ -53,6 +53,20 @@
  * INIT_APP_EXPORT(fn);
  * etc.
  */
+#ifdef RT_USING_INIT_PROFILE
+/*
+ * Called around every auto-initialization function. The default is empty;
+ * the application overrides them to time the boot sequence.
+ */
+RT_WEAK void rt_init_profile_begin(void)
+{
+}
+
+RT_WEAK void rt_init_profile_end(const char *fn_name, int result)
+{
+}
+#endif /* RT_USING_INIT_PROFILE */
+
 static int rti_start(void)
 {
     return 0;
@@ -93,6 +107,13 @@ void rt_components_board_init(void)
         result = desc->fn();
         rt_kprintf(":%d done\n", result);
     }
+#elif defined(RT_USING_INIT_PROFILE)
+    const struct rt_init_desc *desc;
+    for (desc = &__rt_init_desc_rti_board_start; desc < &__rt_init_desc_rti_board_end; desc ++)
+    {
+        rt_init_profile_begin();
+        rt_init_profile_end(desc->fn_name, desc->fn());
+    }
 #else
     volatile const init_fn_t *fn_ptr;
 
@@ -119,6 +140,13 @@ void rt_components_init(void)
         result = desc->fn();
         rt_kprintf(":%d done\n", result);
     }
+#elif defined(RT_USING_INIT_PROFILE)
+    const struct rt_init_desc *desc;
+    for (desc = &__rt_init_desc_rti_board_end; desc < &__rt_init_desc_rti_end; desc ++)
+    {
+        rt_init_profile_begin();
+        rt_init_profile_end(desc->fn_name, desc->fn());
+    }
 #else
     volatile const init_fn_t *fn_ptr;
 
@@ -26,6 +26,7 @@
 /* end of kservice optimization */
 #define RT_DEBUG
 #define RT_DEBUG_COLOR
+#define RT_USING_INIT_PROFILE
 
 /* Inter-Thread communication */
 
@@ -77,10 +78,16 @@
 #define MSH_USING_BUILT_IN_COMMANDS
 #define FINSH_USING_DESCRIPTION
 #define FINSH_ARG_MAX 10
+#define RT_USING_FAL
+#define FAL_DEBUG_CONFIG
+#define FAL_DEBUG 0
+#define FAL_PART_HAS_TABLE_CFG
 
 /* Device Drivers */
 
 #define RT_USING_DEVICE_IPC
+#define RT_USING_CPUTIME
+#define RT_USING_CPUTIME_CORTEXM
 
 /* Using USB */
 
@@ -0,0 +1,12 @@
+/**
+ * @file    board.h
+ * @brief   [仿真] 板级头文件占位
+ */
+
+#ifndef __SIM_BOARD_H
+#define __SIM_BOARD_H
+
+#include <rtthread.h>
+#include "stm32f4xx_hal.h"
+
+#endif /* __SIM_BOARD_H */
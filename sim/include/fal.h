@@ -0,0 +1,27 @@
+/**
+ * @file    fal.h
+ * @brief   [仿真] FAL 分区接口替身 (分区内容保存在内存中，可选落盘)
+ */
+
+#ifndef __SIM_FAL_H
+#define __SIM_FAL_H
+
+#include <rtthread.h>
+
+struct fal_partition
+{
+    rt_uint32_t magic_word;
+    char name[24];
+    char flash_name[24];
+    long offset;
+    size_t len;
+    rt_uint32_t reserved;
+};
+
+int fal_init(void);
+const struct fal_partition *fal_partition_find(const char *name);
+int fal_partition_read(const struct fal_partition *part, rt_uint32_t addr, rt_uint8_t *buf, size_t size);
+int fal_partition_write(const struct fal_partition *part, rt_uint32_t addr, const rt_uint8_t *buf, size_t size);
+int fal_partition_erase(const struct fal_partition *part, rt_uint32_t addr, size_t size);
+
+#endif /* __SIM_FAL_H */
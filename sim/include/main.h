@@ -0,0 +1,11 @@
+/**
+ * @file    main.h
+ * @brief   [仿真] CubeMX main.h 占位
+ */
+
+#ifndef __SIM_MAIN_H
+#define __SIM_MAIN_H
+
+#include "stm32f4xx_hal.h"
+
+#endif /* __SIM_MAIN_H */
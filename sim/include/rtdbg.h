@@ -0,0 +1,53 @@
+/**
+ * @file    rtdbg.h
+ * @brief   [仿真] RT-Thread 调试日志宏替身，时间戳使用仿真虚拟时钟
+ */
+
+#ifndef __SIM_RTDBG_H
+#define __SIM_RTDBG_H
+
+#include <rtthread.h>
+
+#define DBG_ERROR 3
+#define DBG_WARNING 4
+#define DBG_INFO 6
+#define DBG_LOG 7
+
+#ifndef DBG_TAG
+#define DBG_TAG "DBG"
+#endif
+
+#ifndef DBG_LVL
+#define DBG_LVL DBG_WARNING
+#endif
+
+void rt_sim_log(char level, const char *tag, const char *fmt, ...)
+    __attribute__((format(printf, 3, 4)));
+
+#if (DBG_LVL >= DBG_LOG)
+#define LOG_D(...) rt_sim_log('D', DBG_TAG, __VA_ARGS__)
+#else
+#define LOG_D(...)
+#endif
+
+#if (DBG_LVL >= DBG_INFO)
+#define LOG_I(...) rt_sim_log('I', DBG_TAG, __VA_ARGS__)
+#else
+#define LOG_I(...)
+#endif
+
+#if (DBG_LVL >= DBG_WARNING)
+#define LOG_W(...) rt_sim_log('W', DBG_TAG, __VA_ARGS__)
+#else
+#define LOG_W(...)
+#endif
+
+#if (DBG_LVL >= DBG_ERROR)
+#define LOG_E(...) rt_sim_log('E', DBG_TAG, __VA_ARGS__)
+#else
+#define LOG_E(...)
+#endif
+
+#define LOG_RAW(...) rt_kprintf(__VA_ARGS__)
+
+#endif /* __SIM_RTDBG_H */
@@ -0,0 +1,21 @@
+/**
+ * @file    rthw.h
+ * @brief   [仿真] 关中断接口：协作式调度下同一时刻只有一个线程在跑，且没有中断，关中断为空操作
+ */
+
+#ifndef __SIM_RTHW_H
+#define __SIM_RTHW_H
+
+#include <rtthread.h>
+
+static inline rt_base_t rt_hw_interrupt_disable(void)
+{
+    return 0;
+}
+
+static inline void rt_hw_interrupt_enable(rt_base_t level)
+{
+    (void)level;
+}
+
+#endif /* __SIM_RTHW_H */
@@ -0,0 +1,223 @@
+/**
+ * @file    rtthread.h
+ * @brief   [仿真] RT-Thread API 的 POSIX 替身 (仅覆盖应用层用到的子集)
+ *
+ * 线程映射为 pthread，但同一时刻只允许一个线程运行 (按优先级协作调度)，
+ * 全部线程阻塞时直接把虚拟时钟拨到最近的超时点，因此仿真可远快于实时。
+ */
+
+#ifndef __SIM_RTTHREAD_H
+#define __SIM_RTTHREAD_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <pthread.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* --- 基础类型 --- */
+typedef int8_t rt_int8_t;
+typedef int16_t rt_int16_t;
+typedef int32_t rt_int32_t;
+typedef int64_t rt_int64_t;
+typedef uint8_t rt_uint8_t;
+typedef uint16_t rt_uint16_t;
+typedef uint32_t rt_uint32_t;
+typedef uint64_t rt_uint64_t;
+typedef int rt_bool_t;
+typedef long rt_base_t;
+typedef unsigned long rt_ubase_t;
+typedef rt_base_t rt_err_t;
+typedef rt_uint32_t rt_tick_t;
+typedef rt_ubase_t rt_size_t;
+
+#define RT_TRUE 1
+#define RT_FALSE 0
+#define RT_NULL 0
+
+#define RT_EOK 0
+#define RT_ERROR 1
+#define RT_ETIMEOUT 2
+#define RT_EFULL 3
+#define RT_EEMPTY 4
+#define RT_ENOMEM 5
+#define RT_ENOSYS 6
+#define RT_EBUSY 7
+#define RT_EIO 8
+#define RT_EINTR 9
+#define RT_EINVAL 10
+
+#define RT_TICK_PER_SECOND 1000
+#define RT_NAME_MAX 8
+#define RT_ALIGN_SIZE 4
+#define RT_THREAD_PRIORITY_MAX 32
+#define RT_WAITING_FOREVER -1
+#define RT_WAITING_NO 0
+#define RT_ALIGN(size, align) (((size) + (align)-1) & ~((align)-1))
+#define RT_ALIGN_DOWN(size, align) ((size) & ~((align)-1))
+
+#define RT_IPC_FLAG_FIFO 0x00
+#define RT_IPC_FLAG_PRIO 0x01
+#define RT_EVENT_FLAG_AND 0x01
+#define RT_EVENT_FLAG_OR 0x02
+#define RT_EVENT_FLAG_CLEAR 0x04
+
+#define rt_inline static inline
+#define ALIGN(n) __attribute__((aligned(n)))
+#define RT_UNUSED(x) ((void)(x))
+
+/* --- 内核对象 --- */
+struct rt_thread
+{
+    char name[RT_NAME_MAX];
+    rt_uint8_t current_priority;
+    void (*entry)(void *parameter);
+    void *parameter;
+    rt_uint32_t stack_size;
+
+    /* 仿真调度私有字段 */
+    pthread_t pthread;
+    pthread_cond_t cond;
+    int state;            /* 0:就绪 1:阻塞 2:结束 */
+    rt_uint64_t wake_tick; /* 超时唤醒时刻 (0 表示无超时) */
+    const void *wait_obj; /* 正在等待的 IPC 对象 */
+    rt_uint32_t wait_set; /* 等待的事件位 (仅事件集) */
+    int timed_out;
+    rt_uint64_t ready_seq; /* 同优先级 FIFO 排序 */
+};
+typedef struct rt_thread *rt_thread_t;
+
+struct rt_messagequeue
+{
+    char name[RT_NAME_MAX];
+    rt_size_t msg_size;
+    rt_size_t max_msgs;
+    rt_size_t count;
+    rt_size_t head;
+    rt_uint8_t *pool;
+};
+typedef struct rt_messagequeue *rt_mq_t;
+
+struct rt_event
+{
+    char name[RT_NAME_MAX];
+    rt_uint32_t set;
+};
+typedef struct rt_event *rt_event_t;
+
+struct rt_mutex
+{
+    char name[RT_NAME_MAX];
+    rt_thread_t owner;
+    rt_uint32_t hold;
+};
+typedef struct rt_mutex *rt_mutex_t;
+
+struct rt_mempool
+{
+    char name[RT_NAME_MAX];
+    rt_size_t block_size;
+    rt_uint8_t *block_list; /* 空闲块链表 (块前的指针头：空闲时指向下一块，占用时指向所属内存池) */
+    rt_size_t block_total_count;
+    rt_size_t block_free_count;
+};
+typedef struct rt_mempool *rt_mp_t;
+
+/* --- 时钟 --- */
+rt_tick_t rt_tick_get(void);
+rt_tick_t rt_tick_from_millisecond(rt_int32_t ms);
+
+/* --- 线程 --- */
+rt_err_t rt_thread_init(struct rt_thread *thread, const char *name, void (*entry)(void *parameter),
+                        void *parameter, void *stack_start, rt_uint32_t stack_size, rt_uint8_t priority,
+                        rt_uint32_t tick);
+rt_thread_t rt_thread_create(const char *name, void (*entry)(void *parameter), void *parameter,
+                             rt_uint32_t stack_size, rt_uint8_t priority, rt_uint32_t tick);
+rt_err_t rt_thread_startup(rt_thread_t thread);
+rt_thread_t rt_thread_self(void);
+rt_err_t rt_thread_mdelay(rt_int32_t ms);
+rt_err_t rt_thread_delay(rt_tick_t tick);
+rt_err_t rt_thread_yield(void);
+
+/* 调度锁：协作式调度下只有阻塞 / 唤醒调用才会切换线程，锁调度为空操作 */
+static inline void rt_enter_critical(void) {}
+static inline void rt_exit_critical(void) {}
+
+/* --- IPC --- */
+rt_err_t rt_event_init(rt_event_t event, const char *name, rt_uint8_t flag);
+rt_err_t rt_event_send(rt_event_t event, rt_uint32_t set);
+rt_err_t rt_event_recv(rt_event_t event, rt_uint32_t set, rt_uint8_t opt,
+                       rt_int32_t timeout, rt_uint32_t *recved);
+
+rt_err_t rt_mq_init(rt_mq_t mq, const char *name, void *msgpool, rt_size_t msg_size, rt_size_t pool_size,
+                    rt_uint8_t flag);
+rt_mq_t rt_mq_create(const char *name, rt_size_t msg_size, rt_size_t max_msgs, rt_uint8_t flag);
+rt_err_t rt_mq_send(rt_mq_t mq, const void *buffer, rt_size_t size);
+rt_err_t rt_mq_recv(rt_mq_t mq, void *buffer, rt_size_t size, rt_int32_t timeout);
+
+rt_err_t rt_mp_init(struct rt_mempool *mp, const char *name, void *start, rt_size_t size, rt_size_t block_size);
+rt_mp_t rt_mp_create(const char *name, rt_size_t block_count, rt_size_t block_size);
+void *rt_mp_alloc(rt_mp_t mp, rt_int32_t time);
+void rt_mp_free(void *block);
+
+rt_err_t rt_mutex_init(rt_mutex_t mutex, const char *name, rt_uint8_t flag);
+rt_mutex_t rt_mutex_create(const char *name, rt_uint8_t flag);
+rt_err_t rt_mutex_take(rt_mutex_t mutex, rt_int32_t timeout);
+rt_err_t rt_mutex_release(rt_mutex_t mutex);
+
+/* --- 内核服务 --- */
+int rt_kprintf(const char *fmt, ...);
+#define rt_memset memset
+#define rt_memcpy memcpy
+#define rt_strcmp strcmp
+#define rt_strncmp strncmp
+#define rt_strlen strlen
+#define rt_snprintf snprintf
+void *rt_malloc(rt_size_t size);
+void rt_free(void *ptr);
+
+/* --- 自动初始化与 msh 导出 (构造函数注册到仿真器) --- */
+typedef int (*rt_sim_init_fn_t)(void);
+void rt_sim_register_init(rt_sim_init_fn_t fn, int level, const char *name);
+void rt_sim_register_cmd(const char *name, void (*fn)(int argc, char **argv));
+
+#define RT_SIM_INIT_EXPORT(fn, level)                                      \
+    static void __attribute__((constructor)) __rt_sim_init_##fn(void)      \
+    {                                                                      \
+        rt_sim_register_init((rt_sim_init_fn_t)(fn), level, #fn);          \
+    }
+#define INIT_BOARD_EXPORT(fn) RT_SIM_INIT_EXPORT(fn, 1)
+#define INIT_PREV_EXPORT(fn) RT_SIM_INIT_EXPORT(fn, 2)
+#define INIT_DEVICE_EXPORT(fn) RT_SIM_INIT_EXPORT(fn, 3)
+#define INIT_COMPONENT_EXPORT(fn) RT_SIM_INIT_EXPORT(fn, 4)
+#define INIT_ENV_EXPORT(fn) RT_SIM_INIT_EXPORT(fn, 5)
+#define INIT_APP_EXPORT(fn) RT_SIM_INIT_EXPORT(fn, 6)
+#define INIT_DEFERRED_EXPORT(fn) RT_SIM_INIT_EXPORT(fn, 7) /* 仿真中紧接 APP 级顺序执行 */
+
+#define MSH_CMD_EXPORT(cmd, desc)                                          \
+    static void __attribute__((constructor)) __rt_sim_cmd_##cmd(void)      \
+    {                                                                      \
+        rt_sim_register_cmd(#cmd, (void (*)(int, char **))(cmd));          \
+    }
+#define MSH_CMD_EXPORT_ALIAS(cmd, alias, desc)                             \
+    static void __attribute__((constructor)) __rt_sim_cmd_##alias(void)    \
+    {                                                                      \
+        rt_sim_register_cmd(#alias, (void (*)(int, char **))(cmd));        \
+    }
+
+/* --- 仿真器控制接口 (仅 sim/ 使用) --- */
+rt_uint64_t rt_sim_now_ms(void);
+int rt_sim_thread_waiting(const char *name, const void *obj, rt_uint32_t set);
+int rt_sim_run_cmd(const char *line);
+void rt_sim_start(void (*harness)(void *parameter), void *parameter);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SIM_RTTHREAD_H */
@@ -0,0 +1,31 @@
+/**
+ * @file    stm32f4xx_hal.h
+ * @brief   [仿真] HAL 类型占位，仅满足 BSP 头文件的类型引用
+ */
+
+#ifndef __SIM_STM32F4XX_HAL_H
+#define __SIM_STM32F4XX_HAL_H
+
+#include <stdint.h>
+
+typedef struct
+{
+    uint32_t dummy;
+} GPIO_TypeDef;
+
+typedef struct
+{
+    uint32_t dummy;
+} TIM_TypeDef;
+
+typedef struct
+{
+    uint32_t dummy;
+} TIM_HandleTypeDef;
+
+typedef struct
+{
+    uint32_t dummy;
+} UART_HandleTypeDef;
+
+#endif /* __SIM_STM32F4XX_HAL_H */
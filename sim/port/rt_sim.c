@@ -0,0 +1,635 @@
+/**
+ * @file    rt_sim.c
+ * @brief   [仿真] RT-Thread 内核替身 (虚拟时钟 + 优先级协作调度)
+ *
+ * [调度模型]:
+ * 1. 每个 RT 线程对应一个 pthread，但全局只有一个线程持有 sim_lock 在运行。
+ * 2. 运行中的线程只在阻塞 (mdelay / IPC 等待) 或唤醒了更高优先级线程时让出，
+ *    下一个运行者按 "优先级数值小者优先，同优先级先就绪者优先" 选出。
+ * 3. 没有就绪线程时，虚拟时钟直接跳到最近的超时点，代码执行本身视为零耗时，
+ *    因此整场任务的仿真耗时只取决于宿主机执行代码的时间。
+ */
+
+#include <rtthread.h>
+#include <rtdbg.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define SIM_THREAD_MAX 32
+#define SIM_INIT_MAX 64
+#define SIM_CMD_MAX 64
+
+enum
+{
+    SIM_THREAD_INIT = 0,
+    SIM_THREAD_READY,
+    SIM_THREAD_BLOCKED,
+    SIM_THREAD_DONE
+};
+
+static pthread_mutex_t sim_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t sim_boot_cond = PTHREAD_COND_INITIALIZER;
+static int sim_stopped = 0;
+
+static rt_thread_t sim_threads[SIM_THREAD_MAX];
+static int sim_thread_num = 0;
+static rt_thread_t sim_current = RT_NULL;
+static rt_uint64_t sim_now = 0;
+static rt_uint64_t sim_ready_seq = 0;
+
+static struct
+{
+    rt_sim_init_fn_t fn;
+    int level;
+    const char *name;
+} sim_inits[SIM_INIT_MAX];
+static int sim_init_num = 0;
+
+static struct
+{
+    const char *name;
+    void (*fn)(int argc, char **argv);
+} sim_cmds[SIM_CMD_MAX];
+static int sim_cmd_num = 0;
+
+/* ------------------------------------------------------------------ */
+/* 调度核心                                                            */
+/* ------------------------------------------------------------------ */
+
+static void sim_make_ready(rt_thread_t t)
+{
+    t->state = SIM_THREAD_READY;
+    t->wake_tick = 0;
+    t->wait_obj = RT_NULL;
+    t->wait_set = 0;
+    t->ready_seq = ++sim_ready_seq;
+}
+
+/**
+ * @brief  选出下一个运行线程；无就绪线程时推进虚拟时钟
+ */
+static rt_thread_t sim_pick_next(void)
+{
+    for (;;)
+    {
+        rt_thread_t best = RT_NULL;
+        for (int i = 0; i < sim_thread_num; i++)
+        {
+            rt_thread_t t = sim_threads[i];
+            if (t->state != SIM_THREAD_READY)
+                continue;
+            if (best == RT_NULL || t->current_priority < best->current_priority ||
+                (t->current_priority == best->current_priority && t->ready_seq < best->ready_seq))
+                best = t;
+        }
+        if (best != RT_NULL)
+            return best;
+
+        rt_uint64_t next_tick = UINT64_MAX;
+        for (int i = 0; i < sim_thread_num; i++)
+        {
+            rt_thread_t t = sim_threads[i];
+            if (t->state == SIM_THREAD_BLOCKED && t->wake_tick != 0 && t->wake_tick < next_tick)
+                next_tick = t->wake_tick;
+        }
+        if (next_tick == UINT64_MAX)
+        {
+            fprintf(stderr, "[sim] deadlock at %llu ms: all threads blocked forever\n",
+                    (unsigned long long)sim_now);
+            for (int i = 0; i < sim_thread_num; i++)
+                fprintf(stderr, "[sim]   %-12s state=%d obj=%p\n", sim_threads[i]->name,
+                        sim_threads[i]->state, sim_threads[i]->wait_obj);
+            exit(2);
+        }
+
+        sim_now = next_tick;
+        for (int i = 0; i < sim_thread_num; i++)
+        {
+            rt_thread_t t = sim_threads[i];
+            if (t->state == SIM_THREAD_BLOCKED && t->wake_tick != 0 && t->wake_tick <= sim_now)
+            {
+                sim_make_ready(t);
+                t->timed_out = 1;
+            }
+        }
+    }
+}
+
+/**
+ * @brief  当前线程让出 CPU，直到再次被选中 (已结束的线程不再等待)
+ */
+static void sim_schedule(void)
+{
+    rt_thread_t self = sim_current;
+    rt_thread_t next = sim_pick_next();
+
+    sim_current = next;
+    if (next == self)
+        return;
+
+    pthread_cond_signal(&next->cond);
+    if (self == RT_NULL || self->state == SIM_THREAD_DONE)
+        return;
+    while (sim_current != self)
+        pthread_cond_wait(&self->cond, &sim_lock);
+}
+
+/**
+ * @brief  模拟抢占：存在更高优先级的就绪线程时立即切换
+ */
+static void sim_preempt_check(void)
+{
+    rt_thread_t self = sim_current;
+    if (self == RT_NULL)
+        return;
+    for (int i = 0; i < sim_thread_num; i++)
+    {
+        rt_thread_t t = sim_threads[i];
+        if (t->state == SIM_THREAD_READY && t->current_priority < self->current_priority)
+        {
+            sim_schedule();
+            return;
+        }
+    }
+}
+
+/**
+ * @brief  阻塞当前线程
+ * @param  obj: 等待对象 (RT_NULL 表示纯延时)
+ * @param  deadline: 绝对超时时刻 (0 表示永久)
+ * @return RT_EOK: 被对象唤醒, -RT_ETIMEOUT: 超时
+ */
+static rt_err_t sim_block(const void *obj, rt_uint32_t set, rt_uint64_t deadline)
+{
+    rt_thread_t self = sim_current;
+
+    self->state = SIM_THREAD_BLOCKED;
+    self->wait_obj = obj;
+    self->wait_set = set;
+    self->wake_tick = deadline;
+    self->timed_out = 0;
+    sim_schedule();
+
+    return self->timed_out ? -RT_ETIMEOUT : RT_EOK;
+}
+
+static void sim_wake_waiters(const void *obj)
+{
+    for (int i = 0; i < sim_thread_num; i++)
+    {
+        rt_thread_t t = sim_threads[i];
+        if (t->state == SIM_THREAD_BLOCKED && t->wait_obj == obj)
+            sim_make_ready(t);
+    }
+    sim_preempt_check();
+}
+
+static rt_uint64_t sim_deadline(rt_int32_t timeout)
+{
+    return (timeout > 0) ? sim_now + (rt_uint64_t)timeout : 0;
+}
+
+static void *sim_thread_trampoline(void *arg)
+{
+    rt_thread_t t = (rt_thread_t)arg;
+
+    pthread_mutex_lock(&sim_lock);
+    while (sim_current != t)
+        pthread_cond_wait(&t->cond, &sim_lock);
+
+    t->entry(t->parameter);
+
+    t->state = SIM_THREAD_DONE;
+    sim_schedule();
+    pthread_mutex_unlock(&sim_lock);
+    return RT_NULL;
+}
+
+/* ------------------------------------------------------------------ */
+/* 时钟与线程                                                          */
+/* ------------------------------------------------------------------ */
+
+rt_tick_t rt_tick_get(void) { return (rt_tick_t)sim_now; }
+
+rt_tick_t rt_tick_from_millisecond(rt_int32_t ms)
+{
+    return (ms < 0) ? (rt_tick_t)RT_WAITING_FOREVER : (rt_tick_t)ms;
+}
+
+rt_err_t rt_thread_init(struct rt_thread *thread, const char *name, void (*entry)(void *parameter),
+                        void *parameter, void *stack_start, rt_uint32_t stack_size, rt_uint8_t priority,
+                        rt_uint32_t tick)
+{
+    /* 栈由 pthread 提供，stack_start 只是占位 */
+    if (sim_thread_num >= SIM_THREAD_MAX)
+        return -RT_ERROR;
+
+    memset(thread, 0, sizeof(*thread));
+    strncpy(thread->name, name, RT_NAME_MAX - 1);
+    thread->entry = entry;
+    thread->parameter = parameter;
+    thread->stack_size = stack_size;
+    thread->current_priority = priority;
+    thread->state = SIM_THREAD_INIT;
+    pthread_cond_init(&thread->cond, RT_NULL);
+    sim_threads[sim_thread_num++] = thread;
+
+    return RT_EOK;
+}
+
+rt_thread_t rt_thread_create(const char *name, void (*entry)(void *parameter), void *parameter,
+                             rt_uint32_t stack_size, rt_uint8_t priority, rt_uint32_t tick)
+{
+    rt_thread_t t = calloc(1, sizeof(*t));
+    if (t == RT_NULL)
+        return RT_NULL;
+
+    if (rt_thread_init(t, name, entry, parameter, RT_NULL, stack_size, priority, tick) != RT_EOK)
+    {
+        free(t);
+        return RT_NULL;
+    }
+    return t;
+}
+
+rt_err_t rt_thread_startup(rt_thread_t thread)
+{
+    if (thread == RT_NULL || thread->state != SIM_THREAD_INIT)
+        return -RT_ERROR;
+
+    sim_make_ready(thread);
+    if (pthread_create(&thread->pthread, RT_NULL, sim_thread_trampoline, thread) != 0)
+        return -RT_ERROR;
+    pthread_detach(thread->pthread);
+
+    sim_preempt_check();
+    return RT_EOK;
+}
+
+rt_thread_t rt_thread_self(void) { return sim_current; }
+
+rt_err_t rt_thread_yield(void)
+{
+    sim_make_ready(sim_current);
+    sim_schedule();
+    return RT_EOK;
+}
+
+rt_err_t rt_thread_delay(rt_tick_t tick)
+{
+    if (tick == 0)
+        return rt_thread_yield();
+    sim_block(RT_NULL, 0, sim_now + tick);
+    return RT_EOK;
+}
+
+rt_err_t rt_thread_mdelay(rt_int32_t ms)
+{
+    return rt_thread_delay(rt_tick_from_millisecond(ms));
+}
+
+/* ------------------------------------------------------------------ */
+/* IPC                                                                 */
+/* ------------------------------------------------------------------ */
+
+rt_err_t rt_event_init(rt_event_t event, const char *name, rt_uint8_t flag)
+{
+    memset(event, 0, sizeof(*event));
+    strncpy(event->name, name, RT_NAME_MAX - 1);
+    return RT_EOK;
+}
+
+rt_err_t rt_event_send(rt_event_t event, rt_uint32_t set)
+{
+    event->set |= set;
+    sim_wake_waiters(event);
+    return RT_EOK;
+}
+
+rt_err_t rt_event_recv(rt_event_t event, rt_uint32_t set, rt_uint8_t opt,
+                       rt_int32_t timeout, rt_uint32_t *recved)
+{
+    rt_uint64_t deadline = sim_deadline(timeout);
+
+    for (;;)
+    {
+        rt_bool_t hit = (opt & RT_EVENT_FLAG_AND) ? ((event->set & set) == set)
+                                                  : ((event->set & set) != 0);
+        if (hit)
+        {
+            if (recved)
+                *recved = event->set & set;
+            if (opt & RT_EVENT_FLAG_CLEAR)
+                event->set &= ~set;
+            return RT_EOK;
+        }
+        if (timeout == 0 || sim_block(event, set, deadline) != RT_EOK)
+            return -RT_ETIMEOUT;
+    }
+}
+
+rt_err_t rt_mq_init(rt_mq_t mq, const char *name, void *msgpool, rt_size_t msg_size, rt_size_t pool_size,
+                    rt_uint8_t flag)
+{
+    /* 容量按内核的算法 (每条消息带一个链表指针)，与 rt_mq_create 的实际容量一致 */
+    memset(mq, 0, sizeof(*mq));
+    strncpy(mq->name, name, RT_NAME_MAX - 1);
+    mq->msg_size = RT_ALIGN(msg_size, RT_ALIGN_SIZE);
+    mq->max_msgs = pool_size / (mq->msg_size + sizeof(void *));
+    mq->pool = msgpool;
+    return (mq->max_msgs > 0) ? RT_EOK : -RT_ERROR;
+}
+
+rt_mq_t rt_mq_create(const char *name, rt_size_t msg_size, rt_size_t max_msgs, rt_uint8_t flag)
+{
+    rt_mq_t mq = calloc(1, sizeof(*mq));
+    if (mq == RT_NULL)
+        return RT_NULL;
+
+    strncpy(mq->name, name, RT_NAME_MAX - 1);
+    mq->msg_size = RT_ALIGN(msg_size, RT_ALIGN_SIZE);
+    mq->max_msgs = max_msgs;
+    mq->pool = calloc(max_msgs, mq->msg_size);
+    if (mq->pool == RT_NULL)
+    {
+        free(mq);
+        return RT_NULL;
+    }
+    return mq;
+}
+
+rt_err_t rt_mq_send(rt_mq_t mq, const void *buffer, rt_size_t size)
+{
+    if (size > mq->msg_size)
+        return -RT_ERROR;
+    if (mq->count >= mq->max_msgs)
+        return -RT_EFULL;
+
+    rt_size_t slot = (mq->head + mq->count) % mq->max_msgs;
+    memcpy(mq->pool + slot * mq->msg_size, buffer, size);
+    mq->count++;
+    sim_wake_waiters(mq);
+    return RT_EOK;
+}
+
+rt_err_t rt_mq_recv(rt_mq_t mq, void *buffer, rt_size_t size, rt_int32_t timeout)
+{
+    rt_uint64_t deadline = sim_deadline(timeout);
+
+    while (mq->count == 0)
+    {
+        if (timeout == 0 || sim_block(mq, 0, deadline) != RT_EOK)
+            return -RT_ETIMEOUT;
+    }
+
+    memcpy(buffer, mq->pool + mq->head * mq->msg_size, (size < mq->msg_size) ? size : mq->msg_size);
+    mq->head = (mq->head + 1) % mq->max_msgs;
+    mq->count--;
+    return RT_EOK;
+}
+
+rt_err_t rt_mp_init(struct rt_mempool *mp, const char *name, void *start, rt_size_t size, rt_size_t block_size)
+{
+    /* 块数按内核的算法 (每块前一个指针头)，与固件上的实际容量一致 */
+    memset(mp, 0, sizeof(*mp));
+    strncpy(mp->name, name, RT_NAME_MAX - 1);
+    mp->block_size = RT_ALIGN(block_size, RT_ALIGN_SIZE);
+    mp->block_total_count = RT_ALIGN_DOWN(size, RT_ALIGN_SIZE) / (mp->block_size + sizeof(rt_uint8_t *));
+    mp->block_free_count = mp->block_total_count;
+
+    rt_uint8_t *p = start;
+    for (rt_size_t i = 0; i < mp->block_total_count; i++)
+    {
+        rt_uint8_t *blk = p + i * (mp->block_size + sizeof(rt_uint8_t *));
+        *(rt_uint8_t **)blk = (i + 1 < mp->block_total_count) ? blk + mp->block_size + sizeof(rt_uint8_t *) : RT_NULL;
+    }
+    mp->block_list = (mp->block_total_count > 0) ? p : RT_NULL;
+    return (mp->block_total_count > 0) ? RT_EOK : -RT_ERROR;
+}
+
+rt_mp_t rt_mp_create(const char *name, rt_size_t block_count, rt_size_t block_size)
+{
+    rt_mp_t mp = calloc(1, sizeof(*mp));
+    if (mp == RT_NULL)
+        return RT_NULL;
+
+    rt_size_t size = block_count * (RT_ALIGN(block_size, RT_ALIGN_SIZE) + sizeof(rt_uint8_t *));
+    void *start = calloc(1, size);
+    if (start == RT_NULL || rt_mp_init(mp, name, start, size, block_size) != RT_EOK)
+    {
+        free(start);
+        free(mp);
+        return RT_NULL;
+    }
+    return mp;
+}
+
+void *rt_mp_alloc(rt_mp_t mp, rt_int32_t time)
+{
+    rt_uint64_t deadline = sim_deadline(time);
+
+    while (mp->block_free_count == 0)
+    {
+        if (time == 0 || sim_block(mp, 0, deadline) != RT_EOK)
+            return RT_NULL;
+    }
+
+    rt_uint8_t *blk = mp->block_list;
+    mp->block_list = *(rt_uint8_t **)blk;
+    *(rt_mp_t *)blk = mp;
+    mp->block_free_count--;
+    return blk + sizeof(rt_uint8_t *);
+}
+
+void rt_mp_free(void *block)
+{
+    rt_uint8_t *blk = (rt_uint8_t *)block - sizeof(rt_uint8_t *);
+    rt_mp_t mp = *(rt_mp_t *)blk;
+
+    *(rt_uint8_t **)blk = mp->block_list;
+    mp->block_list = blk;
+    mp->block_free_count++;
+    sim_wake_waiters(mp);
+}
+
+rt_err_t rt_mutex_init(rt_mutex_t mutex, const char *name, rt_uint8_t flag)
+{
+    memset(mutex, 0, sizeof(*mutex));
+    strncpy(mutex->name, name, RT_NAME_MAX - 1);
+    return RT_EOK;
+}
+
+rt_mutex_t rt_mutex_create(const char *name, rt_uint8_t flag)
+{
+    rt_mutex_t mutex = calloc(1, sizeof(*mutex));
+    if (mutex != RT_NULL)
+        strncpy(mutex->name, name, RT_NAME_MAX - 1);
+    return mutex;
+}
+
+rt_err_t rt_mutex_take(rt_mutex_t mutex, rt_int32_t timeout)
+{
+    rt_uint64_t deadline = sim_deadline(timeout);
+
+    while (mutex->owner != RT_NULL && mutex->owner != sim_current)
+    {
+        if (timeout == 0 || sim_block(mutex, 0, deadline) != RT_EOK)
+            return -RT_ETIMEOUT;
+    }
+    mutex->owner = sim_current;
+    mutex->hold++;
+    return RT_EOK;
+}
+
+rt_err_t rt_mutex_release(rt_mutex_t mutex)
+{
+    if (mutex->owner != sim_current)
+        return -RT_ERROR;
+    if (--mutex->hold == 0)
+    {
+        mutex->owner = RT_NULL;
+        sim_wake_waiters(mutex);
+    }
+    return RT_EOK;
+}
+
+/* ------------------------------------------------------------------ */
+/* 内核服务                                                            */
+/* ------------------------------------------------------------------ */
+
+int rt_kprintf(const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    int n = vprintf(fmt, args);
+    va_end(args);
+    return n;
+}
+
+void rt_sim_log(char level, const char *tag, const char *fmt, ...)
+{
+    va_list args;
+
+    printf("[%5llu.%03llu] %c/%s: ", (unsigned long long)(sim_now / 1000),
+           (unsigned long long)(sim_now % 1000), level, tag);
+    va_start(args, fmt);
+    vprintf(fmt, args);
+    va_end(args);
+    printf("\n");
+}
+
+void *rt_malloc(rt_size_t size) { return malloc(size); }
+void rt_free(void *ptr) { free(ptr); }
+
+/* ------------------------------------------------------------------ */
+/* 自动初始化 / msh 注册                                               */
+/* ------------------------------------------------------------------ */
+
+void rt_sim_register_init(rt_sim_init_fn_t fn, int level, const char *name)
+{
+    if (sim_init_num < SIM_INIT_MAX)
+    {
+        sim_inits[sim_init_num].fn = fn;
+        sim_inits[sim_init_num].level = level;
+        sim_inits[sim_init_num].name = name;
+        sim_init_num++;
+    }
+}
+
+void rt_sim_register_cmd(const char *name, void (*fn)(int argc, char **argv))
+{
+    if (sim_cmd_num < SIM_CMD_MAX)
+    {
+        sim_cmds[sim_cmd_num].name = name;
+        sim_cmds[sim_cmd_num].fn = fn;
+        sim_cmd_num++;
+    }
+}
+
+/**
+ * @brief  执行一条 msh 命令行 (空格分隔参数)
+ * @return 0: 成功, -1: 命令不存在
+ */
+int rt_sim_run_cmd(const char *line)
+{
+    char buf[128];
+    char *argv[10];
+    int argc = 0;
+
+    strncpy(buf, line, sizeof(buf) - 1);
+    buf[sizeof(buf) - 1] = '\0';
+    for (char *tok = strtok(buf, " "); tok != RT_NULL && argc < 10; tok = strtok(RT_NULL, " "))
+        argv[argc++] = tok;
+    if (argc == 0)
+        return -1;
+
+    for (int i = 0; i < sim_cmd_num; i++)
+    {
+        if (strcmp(sim_cmds[i].name, argv[0]) == 0)
+        {
+            sim_cmds[i].fn(argc, argv);
+            return 0;
+        }
+    }
+    return -1;
+}
+
+/* ------------------------------------------------------------------ */
+/* 仿真器控制                                                          */
+/* ------------------------------------------------------------------ */
+
+rt_uint64_t rt_sim_now_ms(void) { return sim_now; }
+
+int rt_sim_thread_waiting(const char *name, const void *obj, rt_uint32_t set)
+{
+    for (int i = 0; i < sim_thread_num; i++)
+    {
+        rt_thread_t t = sim_threads[i];
+        if (strcmp(t->name, name) == 0)
+            return t->state == SIM_THREAD_BLOCKED && t->wait_obj == obj &&
+                   (set == 0 || t->wait_set == set);
+    }
+    return 0;
+}
+
+static void (*sim_harness)(void *parameter);
+
+/**
+ * @brief  仿真 main 线程：按等级执行自动初始化，然后运行测试夹具
+ */
+static void sim_main_entry(void *parameter)
+{
+    for (int level = 1; level <= 7; level++)
+    {
+        for (int i = 0; i < sim_init_num; i++)
+        {
+            if (sim_inits[i].level == level)
+                sim_inits[i].fn();
+        }
+    }
+
+    sim_harness(parameter);
+
+    /* 夹具返回即结束仿真：不再交出 CPU，直接唤醒宿主 main */
+    sim_stopped = 1;
+    pthread_cond_signal(&sim_boot_cond);
+    while (1)
+        pthread_cond_wait(&sim_current->cond, &sim_lock);
+}
+
+void rt_sim_start(void (*harness)(void *parameter), void *parameter)
+{
+    pthread_mutex_lock(&sim_lock);
+
+    sim_harness = harness;
+    rt_thread_t main_thread = rt_thread_create("main", sim_main_entry, parameter, 2048, 10, 20);
+    rt_thread_startup(main_thread);
+
+    sim_current = sim_pick_next();
+    pthread_cond_signal(&sim_current->cond);
+    while (!sim_stopped)
+        pthread_cond_wait(&sim_boot_cond, &sim_lock);
+
+    pthread_mutex_unlock(&sim_lock);
+}
@@ -0,0 +1,534 @@
+/**
+ * @file    sim_bsp.c
+ * @brief   [仿真] BSP 层替身：步进电机、舵机、按键、串口实例
+ *
+ * 电机模型按真实驱动的比较推进方式建模：
+ * - 各通道独立步频，实际步频按 interval 取整量化 (rate = tick_hz / interval)；
+ * - 同一定时器按最慢运行通道选择预分频档位 (与 bsp_motor.c 的档位表一致)；
+ * - 每次比较翻转记 1 步，并按 bsp_motor_ramp.c 逐步推进加减速与换向
+ *   (与 HAL_TIM_OC_DelayElapsedCallback 的处理一致)。
+ */
+
+#include <rtthread.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../../User/My_Driver/bsp_motor.h"
+#include "../../User/My_Driver/bsp_servo.h"
+#include "../../User/My_Driver/bsp_key_led.h"
+#include "../../User/My_Driver/bsp_uart.h"
+#include "../../User/My_Driver/bsp_dwt.h"
+#include "../../User/My_Driver/bsp_ccm.h"
+#include "../../User/Components/trace_rec.h"
+#include "../../User/Components/boot_prof.h"
+#include "../../User/My_App/app_telem_proc.h"
+#include "sim_world.h"
+
+#define SIM_INTERVAL_MAX 65535u
+#define SIM_INTERVAL_MIN 4u
+#define SIM_RANGE_DEFAULT 1
+#define SIM_RANGE_HYST 0.9f
+
+/* 定时器输入时钟 (TIM1: APB2 x2, TIM2: APB1 x2) 与档位表 */
+static const uint32_t sim_tim_clk[2] = {168000000, 84000000};
+static const uint32_t sim_range_hz[] = {8000000, 1000000, 100000};
+#define SIM_RANGE_NUM (sizeof(sim_range_hz) / sizeof(sim_range_hz[0]))
+
+TIM_HandleTypeDef htim1;
+TIM_HandleTypeDef htim2;
+
+Motor_t motor_1;
+Motor_t motor_2;
+Motor_t motor_3;
+Motor_t motor_4;
+Motor_t motor_5;
+
+UART_t uart1_qr;
+UART_t uart2_imu;
+UART_t uart3_telem;
+UART_t uart6_vision;
+
+uint8_t g_key_val = 0;
+uint8_t g_key_down = 0;
+uint8_t g_key_up = 0;
+uint8_t g_key_old = 0;
+
+float sim_servo_angle[5] = {0};
+
+static Motor_t *const sim_motors[5] = {&motor_1, &motor_2, &motor_3, &motor_4, &motor_5};
+static int sim_range[2] = {SIM_RANGE_DEFAULT, SIM_RANGE_DEFAULT};
+static double sim_wait[5] = {0}; /* 距下一次翻转的时间 (s) */
+
+/* 联动插补 (与 bsp_motor.c 的 Motor_Coord_t 一致) */
+static struct
+{
+    int active;
+    int master;
+    uint32_t total, span, done;
+    int32_t steps[MOTOR_COORD_AXES];
+    int8_t trim_dir[MOTOR_COORD_AXES];
+    int32_t trim;
+    int32_t acc[MOTOR_COORD_AXES];
+    int8_t pending[MOTOR_COORD_AXES];
+} sim_coord;
+
+/* 固件中 BSP_Motor_Init 未必被调用，这里按实例区分定时器 */
+static int Sim_Motor_Timer(Motor_t *motor)
+{
+    return (motor == &motor_5) ? 1 : 0;
+}
+
+static uint32_t Sim_Range_Tick(int tim, int range)
+{
+    return sim_tim_clk[tim] / (sim_tim_clk[tim] / sim_range_hz[range]);
+}
+
+static uint32_t Sim_Clamp_Interval(uint32_t iv)
+{
+    return (iv < SIM_INTERVAL_MIN) ? SIM_INTERVAL_MIN : (iv > SIM_INTERVAL_MAX) ? SIM_INTERVAL_MAX : iv;
+}
+
+static uint32_t Sim_Calc_Interval(uint32_t tick, float rate)
+{
+    return Sim_Clamp_Interval((uint32_t)lrintf((float)tick / fabsf(rate)));
+}
+
+/**
+ * @brief  按最慢运行通道选档并刷新目标间隔 (与 bsp_motor.c 的 Motor_Timer_Update 一致)
+ */
+static void Sim_Timer_Update(int tim)
+{
+    float slowest = 0.0f;
+    for (int i = 0; i < 5; i++)
+    {
+        Motor_t *m = sim_motors[i];
+        if (m->dir != 0 && Sim_Motor_Timer(m) == tim && (slowest == 0.0f || fabsf(m->rate) < slowest))
+            slowest = fabsf(m->rate);
+    }
+    if (slowest == 0.0f)
+        return;
+
+    int range = SIM_RANGE_NUM - 1;
+    for (int i = 0; i < (int)SIM_RANGE_NUM; i++)
+    {
+        float limit = (float)SIM_INTERVAL_MAX * ((i < sim_range[tim]) ? SIM_RANGE_HYST : 1.0f);
+        if ((float)Sim_Range_Tick(tim, i) / slowest <= limit)
+        {
+            range = i;
+            break;
+        }
+    }
+
+    int rearm = (range != sim_range[tim]);
+    uint32_t tick_old = Sim_Range_Tick(tim, sim_range[tim]);
+    uint32_t tick = Sim_Range_Tick(tim, range);
+    sim_range[tim] = range;
+
+    for (int i = 0; i < 5; i++)
+    {
+        Motor_t *m = sim_motors[i];
+        if (Sim_Motor_Timer(m) != tim)
+            continue;
+        if (rearm)
+            Motor_Ramp_Config(&m->ramp, tick, m->accel);
+        if (m->dir == 0)
+            continue;
+
+        Motor_Ramp_SetTarget(&m->ramp, Sim_Calc_Interval(tick, m->rate));
+        if (rearm)
+        {
+            /* UG 清零计数器，CCR = interval */
+            Motor_Ramp_Rescale(&m->ramp, tick_old, tick);
+            m->interval = Sim_Clamp_Interval((m->ramp.c + (1u << (MOTOR_RAMP_Q - 1))) >> MOTOR_RAMP_Q);
+            sim_wait[i] = (double)m->interval / tick;
+        }
+    }
+}
+
+void BSP_Motor_Init(void)
+{
+    for (int i = 0; i < 5; i++)
+        sim_motors[i]->config.htim = (i == 4) ? &htim2 : &htim1;
+}
+
+static void Sim_Coord_Abort(void)
+{
+    if (!sim_coord.active)
+        return;
+    sim_coord.active = 0;
+    for (int i = 0; i < MOTOR_COORD_AXES; i++)
+        BSP_Motor_Stop(sim_motors[i]);
+}
+
+static int Sim_Coord_Member(Motor_t *motor)
+{
+    for (int i = 0; i < MOTOR_COORD_AXES; i++)
+        if (sim_motors[i] == motor)
+            return 1;
+    return 0;
+}
+
+static void Sim_Coord_Schedule(void)
+{
+    int32_t n = (int32_t)sim_coord.total;
+    int32_t hi = n - n / 2; /* 累加器保持在 [-n/2, n - n/2) 内，宽度恰为 n */
+    int32_t lo = -(n / 2);
+
+    for (int i = 0; i < MOTOR_COORD_AXES; i++)
+    {
+        int32_t acc = sim_coord.acc[i] + sim_coord.steps[i] + sim_coord.trim_dir[i] * sim_coord.trim;
+        int8_t p = 0;
+
+        if (acc >= hi)
+        {
+            acc -= n;
+            p = 1;
+        }
+        else if (acc < lo)
+        {
+            acc += n;
+            p = -1;
+        }
+        sim_coord.acc[i] = acc;
+        sim_coord.pending[i] = p;
+        if (p != 0)
+            sim_motors[i]->dir = sim_motors[i]->dir_target = p;
+    }
+}
+
+int BSP_Motor_Coord_Start(const int32_t steps[MOTOR_COORD_AXES], const int8_t trim_dir[MOTOR_COORD_AXES],
+                          float rate, float accel)
+{
+    uint32_t span = 0;
+    int mi = -1;
+
+    for (int i = 0; i < MOTOR_COORD_AXES; i++)
+    {
+        uint32_t n = (uint32_t)abs(steps[i]);
+        if (n > span)
+        {
+            span = n;
+            mi = i;
+        }
+    }
+    rate = fabsf(rate);
+    if (mi < 0 || rate < MOTOR_RATE_MIN)
+        return -1;
+
+    uint32_t total = span;
+    if (trim_dir != NULL)
+        total += (uint32_t)lrintf((float)span * MOTOR_COORD_TRIM_MAX);
+    float scale = (float)total / (float)span;
+    float clk_rate = rate * scale;
+    if (clk_rate > MOTOR_RATE_MAX)
+        clk_rate = MOTOR_RATE_MAX;
+
+    for (int i = 0; i < MOTOR_COORD_AXES; i++)
+        BSP_Motor_Stop(sim_motors[i]);
+
+    Motor_t *master = sim_motors[mi];
+    int tim = Sim_Motor_Timer(master);
+    master->dir = master->dir_target = (steps[mi] > 0) ? 1 : -1;
+    master->rate = clk_rate * master->dir;
+    master->accel = accel * scale;
+    Motor_Ramp_Reset(&master->ramp);
+    Sim_Timer_Update(tim);
+    uint32_t tick = Sim_Range_Tick(tim, sim_range[tim]);
+    Motor_Ramp_Config(&master->ramp, tick, master->accel);
+
+    sim_coord.master = mi;
+    sim_coord.total = total;
+    sim_coord.span = span;
+    sim_coord.done = 0;
+    sim_coord.trim = 0;
+    for (int i = 0; i < MOTOR_COORD_AXES; i++)
+    {
+        sim_coord.steps[i] = steps[i];
+        sim_coord.trim_dir[i] = (trim_dir != NULL) ? trim_dir[i] : 0;
+        sim_coord.acc[i] = 0;
+        sim_coord.pending[i] = 0;
+        if (i != mi)
+            sim_motors[i]->rate = clk_rate * (float)steps[i] / (float)total;
+    }
+    sim_coord.active = 1;
+
+    master->interval = Sim_Clamp_Interval(Motor_Ramp_Next(&master->ramp, 0));
+    sim_wait[mi] = (double)master->interval / tick;
+    Sim_Coord_Schedule();
+    return 0;
+}
+
+void BSP_Motor_Coord_Trim(float trim)
+{
+    int32_t lim = (int32_t)(sim_coord.total - sim_coord.span);
+    int32_t v = (int32_t)lrintf(trim * (float)sim_coord.span);
+
+    if (v > lim)
+        v = lim;
+    if (v < -lim)
+        v = -lim;
+    sim_coord.trim = v;
+}
+
+uint8_t BSP_Motor_Coord_Busy(void) { return (uint8_t)sim_coord.active; }
+
+uint8_t BSP_Motor_Busy(void)
+{
+    if (sim_coord.active)
+        return 1;
+    for (int i = 0; i < 5; i++)
+        if (sim_motors[i]->dir != 0)
+            return 1;
+    return 0;
+}
+
+/**
+ * @brief  推进联动插补 (主轴节拍驱动四轮，与 Motor_Coord_Step 一致)
+ */
+static void Sim_Coord_Advance(double dt, double rate[5])
+{
+    Motor_t *master = sim_motors[sim_coord.master];
+    int tim = Sim_Motor_Timer(master);
+    uint32_t tick = Sim_Range_Tick(tim, sim_range[tim]);
+    double remain = dt;
+
+    while (sim_coord.active && sim_wait[sim_coord.master] <= remain)
+    {
+        remain -= sim_wait[sim_coord.master];
+        for (int i = 0; i < MOTOR_COORD_AXES; i++)
+            sim_motors[i]->total_steps += sim_coord.pending[i];
+
+        if (++sim_coord.done >= sim_coord.total)
+        {
+            Sim_Coord_Abort();
+            break;
+        }
+        uint32_t left = sim_coord.total - sim_coord.done;
+        master->interval = Sim_Clamp_Interval(Motor_Ramp_Next(&master->ramp, left <= master->ramp.n));
+        sim_wait[sim_coord.master] = (double)master->interval / tick;
+        Sim_Coord_Schedule();
+    }
+    if (sim_coord.active)
+        sim_wait[sim_coord.master] -= remain;
+
+    /* 各轮的平均步频：节拍频率 x (steps + trim_dir * trim) / N */
+    for (int i = 0; i < MOTOR_COORD_AXES; i++)
+    {
+        double q = (double)sim_coord.steps[i] + sim_coord.trim_dir[i] * sim_coord.trim;
+        rate[i] = sim_coord.active ? (double)tick / master->interval * q / sim_coord.total : 0.0;
+    }
+}
+
+void BSP_Motor_SetRate(Motor_t *motor, float steps_per_s)
+{
+    if (sim_coord.active && Sim_Coord_Member(motor))
+        Sim_Coord_Abort();
+
+    if (fabsf(steps_per_s) < MOTOR_RATE_MIN)
+    {
+        BSP_Motor_Stop(motor);
+        return;
+    }
+    if (steps_per_s > MOTOR_RATE_MAX)
+        steps_per_s = MOTOR_RATE_MAX;
+    if (steps_per_s < -MOTOR_RATE_MAX)
+        steps_per_s = -MOTOR_RATE_MAX;
+
+    int tim = Sim_Motor_Timer(motor);
+    int was_running = (motor->dir != 0);
+    motor->rate = steps_per_s;
+    motor->dir_target = (steps_per_s > 0) ? 1 : -1;
+    if (!was_running)
+    {
+        motor->dir = motor->dir_target;
+        Motor_Ramp_Reset(&motor->ramp);
+    }
+    Sim_Timer_Update(tim);
+
+    if (!was_running)
+    {
+        motor->interval = Sim_Clamp_Interval(Motor_Ramp_Next(&motor->ramp, 0));
+        for (int i = 0; i < 5; i++)
+            if (sim_motors[i] == motor)
+                sim_wait[i] = (double)motor->interval / Sim_Range_Tick(tim, sim_range[tim]);
+    }
+}
+
+void BSP_Motor_SetAccel(Motor_t *motor, float steps_per_s2)
+{
+    if (steps_per_s2 == motor->accel)
+        return;
+
+    int tim = Sim_Motor_Timer(motor);
+    motor->accel = steps_per_s2;
+    Motor_Ramp_Config(&motor->ramp, Sim_Range_Tick(tim, sim_range[tim]), steps_per_s2);
+}
+
+void BSP_Motor_Stop(Motor_t *motor)
+{
+    if (sim_coord.active && Sim_Coord_Member(motor))
+        Sim_Coord_Abort();
+
+    motor->rate = 0;
+    motor->dir = 0;
+    motor->dir_target = 0;
+    motor->interval = 0;
+    Motor_Ramp_Reset(&motor->ramp);
+}
+
+void BSP_Motor_Enable(Motor_t *motor, uint8_t enable) {}
+
+int32_t BSP_Motor_GetSteps(Motor_t *motor) { return motor->total_steps; }
+
+void BSP_Motor_ResetSteps(Motor_t *motor) { motor->total_steps = 0; }
+
+/**
+ * @brief  推进电机脉冲 (由仿真世界每个物理步长调用)，逐次翻转执行与比较中断相同的处理
+ * @param  dt: 步长 (s)
+ * @param  rate: 输出各电机步长结束时的带符号瞬时步频 (步/s)，可为 NULL
+ */
+void Sim_Motor_Advance(double dt, double rate[5])
+{
+    double coord_rate[5] = {0};
+    int coord = sim_coord.active;
+
+    if (coord)
+        Sim_Coord_Advance(dt, coord_rate);
+
+    for (int i = 0; i < 5; i++)
+    {
+        Motor_t *m = sim_motors[i];
+        int tim = Sim_Motor_Timer(m);
+        double r = 0.0;
+
+        if (coord && i < MOTOR_COORD_AXES)
+        {
+            if (rate != RT_NULL)
+                rate[i] = coord_rate[i];
+            continue;
+        }
+
+        if (m->dir != 0)
+        {
+            uint32_t tick = Sim_Range_Tick(tim, sim_range[tim]);
+            double remain = dt;
+
+            while (sim_wait[i] <= remain)
+            {
+                remain -= sim_wait[i];
+                m->total_steps += m->dir;
+
+                uint8_t reversing = (m->dir_target != m->dir);
+                m->interval = Sim_Clamp_Interval(Motor_Ramp_Next(&m->ramp, reversing));
+                if (reversing && m->ramp.n == 0)
+                    m->dir = m->dir_target;
+                sim_wait[i] = (double)m->interval / tick;
+            }
+            sim_wait[i] -= remain;
+            r = m->dir * (double)tick / m->interval;
+        }
+        if (rate != RT_NULL)
+            rate[i] = r;
+    }
+}
+
+void Servo_SetAngle(uint8_t servo_id, float angle)
+{
+    if (servo_id < 5)
+        sim_servo_angle[servo_id] = angle;
+}
+
+int BSP_Servo_Init(void) { return 0; }
+
+void BSP_LED_Init(void) {}
+void BSP_LED_On(void) {}
+void BSP_LED_Off(void) {}
+void BSP_LED_Toggle(void) {}
+
+uint8_t BSP_Key_Read(void) { return Sim_World_KeyPressed() ? 1 : 0; }
+
+void BSP_Key_Scan(void)
+{
+    g_key_val = BSP_Key_Read();
+    g_key_down = g_key_val & (g_key_val ^ g_key_old);
+    g_key_up = ~g_key_val & (g_key_val ^ g_key_old);
+    g_key_old = g_key_val;
+}
+
+void BSP_UART_Init(UART_t *uart) {}
+void BSP_UART_printf(UART_t *uart, const char *format, ...) {}
+
+void BSP_UART_Send(UART_t *uart, uint8_t *data, uint16_t len)
+{
+    if (uart == &uart2_imu)
+        Sim_IMU_Write(data, len);
+}
+
+static FILE *sim_telem_file = RT_NULL; /* --telem 指定的遥测输出文件 */
+
+void Sim_Telem_Open(const char *path)
+{
+    sim_telem_file = fopen(path, "wb");
+    if (sim_telem_file == RT_NULL)
+        fprintf(stderr, "[sim] cannot open telemetry file %s\n", path);
+}
+
+void Sim_Telem_Close(void)
+{
+    if (sim_telem_file != RT_NULL)
+        fclose(sim_telem_file);
+    sim_telem_file = RT_NULL;
+}
+
+/**
+ * @brief  DMA 发送：遥测字节流写入文件，随即按发送完成回调通知 (仿真中发送瞬间完成)；
+ *         串口 6 的请求命令交给相机模型
+ */
+int BSP_UART_Send_DMA(UART_t *uart, uint8_t *data, uint16_t len)
+{
+    if (uart == &uart3_telem)
+    {
+        if (sim_telem_file != RT_NULL)
+            fwrite(data, 1, len, sim_telem_file);
+        App_Telem_TxDone();
+    }
+    else if (uart == &uart6_vision)
+    {
+        Sim_Vision_Write(data, len);
+    }
+    return 0;
+}
+
+void BSP_UART_SetBaud(UART_t *uart, uint32_t baud)
+{
+    if (uart == &uart2_imu)
+        Sim_IMU_SetHostBaud(baud);
+}
+
+/* DWT 周期计数器：按 168MHz 换算宿主机单调时钟，测得的是宿主机上的真实耗时 */
+#define SIM_CORE_HZ 168000000ull
+
+int BSP_DWT_Init(void) { return RT_EOK; }
+
+uint32_t BSP_DWT_GetCycles(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(((uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec) * SIM_CORE_HZ / 1000000000ull);
+}
+
+uint32_t BSP_DWT_CyclesToNs(uint32_t cycles)
+{
+    return (uint32_t)((uint64_t)cycles * 1000000000ull / SIM_CORE_HZ);
+}
+
+/* 追踪记录器依赖内核钩子，仿真中不记录，只保留用户标记接口 */
+void Trace_Event(uint8_t type, const void *obj) {}
+
+/* 启动剖析依赖内核自动初始化回调，仿真中不计时 */
+void Boot_Prof_Mark(const char *name) {}
+
+/* CCM 周期统计：仿真中 CCM_CYCLES() 恒为 0，只提供存储 */
+CCM_Bench_t ccm_bench_step;
+CCM_Bench_t ccm_bench_move;
@@ -0,0 +1,89 @@
+/**
+ * @file    sim_fal.c
+ * @brief   [仿真] FAL 替身：内存中的 "param" 分区，按 NOR Flash 语义写入 (只能 1->0)
+ */
+
+#include <fal.h>
+#include <stdio.h>
+#include "sim_world.h"
+
+#define SIM_PARAM_PART_SIZE (2 * 128 * 1024)
+
+static const struct fal_partition sim_param_part = {
+    0x45503130, "param", "onchip_flash_128k", 5 * 128 * 1024, SIM_PARAM_PART_SIZE, 0};
+static rt_uint8_t sim_flash[SIM_PARAM_PART_SIZE];
+static int sim_flash_ready = 0;
+
+int fal_init(void)
+{
+    if (!sim_flash_ready)
+    {
+        memset(sim_flash, 0xFF, sizeof(sim_flash));
+        sim_flash_ready = 1;
+    }
+    return 1;
+}
+
+const struct fal_partition *fal_partition_find(const char *name)
+{
+    return (strcmp(name, sim_param_part.name) == 0) ? &sim_param_part : RT_NULL;
+}
+
+static int Sim_Fal_Check(const struct fal_partition *part, rt_uint32_t addr, size_t size)
+{
+    return (part == &sim_param_part && addr + size <= part->len) ? 0 : -1;
+}
+
+int fal_partition_read(const struct fal_partition *part, rt_uint32_t addr, rt_uint8_t *buf, size_t size)
+{
+    if (Sim_Fal_Check(part, addr, size) < 0)
+        return -1;
+    memcpy(buf, sim_flash + addr, size);
+    return (int)size;
+}
+
+int fal_partition_write(const struct fal_partition *part, rt_uint32_t addr, const rt_uint8_t *buf, size_t size)
+{
+    if (Sim_Fal_Check(part, addr, size) < 0)
+        return -1;
+    for (size_t i = 0; i < size; i++)
+        sim_flash[addr + i] &= buf[i];
+    return (int)size;
+}
+
+int fal_partition_erase(const struct fal_partition *part, rt_uint32_t addr, size_t size)
+{
+    if (Sim_Fal_Check(part, addr, size) < 0)
+        return -1;
+    memset(sim_flash + addr, 0xFF, size);
+    return (int)size;
+}
+
+/**
+ * @brief  从镜像文件加载分区内容 (文件不存在时保持全擦除状态)
+ */
+void Sim_Fal_Load(const char *path)
+{
+    FILE *fp = fopen(path, "rb");
+
+    fal_init();
+    if (fp != RT_NULL)
+    {
+        if (fread(sim_flash, 1, sizeof(sim_flash), fp) != sizeof(sim_flash))
+            memset(sim_flash, 0xFF, sizeof(sim_flash));
+        fclose(fp);
+    }
+}
+
+/**
+ * @brief  把分区内容写回镜像文件
+ */
+void Sim_Fal_Save(const char *path)
+{
+    FILE *fp = fopen(path, "wb");
+    if (fp != RT_NULL)
+    {
+        fwrite(sim_flash, 1, sizeof(sim_flash), fp);
+        fclose(fp);
+    }
+}
@@ -0,0 +1,407 @@
+/**
+ * @file    sim_world.c
+ * @brief   [仿真] 物理世界线程 (最高优先级，1ms 步长，等效于定时器/串口中断源)
+ *
+ * [模型说明]:
+ * 1. 底盘：电机步频 -> 轮速 (按默认 PULSE_PER_MM 标定) -> 麦轮正运动学 -> 世界坐标位姿。
+ *    电机编号 1:左前 2:右前 3:左后 4:右后，与 app_move_proc.c 的混控符号一致。
+ * 2. IMU：按模块寄存器 (RSW/RRATE/BAUD) 输出帧，填进帧内存池的块，块指针经 imu_mq 投递 (与空闲中断一致)。
+ *    出厂为 115200 / 100Hz / 时间+角速度+角度；主机波特率与模块不一致时收不到数据，
+ *    主机写入的 0xFF 0xAA 寄存器命令只在波特率一致时生效。
+ *    角速度叠加固定零偏，角度输出按固定速率漂移 (模拟模块自身的积分漂移)。
+ * 3. 二维码：车体前进位置在 500~800mm 之间 (码在视野里) 时每 100ms 上报一次 qr_content。
+ * 4. 视觉：默认 30fps 轮流上报 ID 1~6。色块 (1~3) 始终居中；色环 (4~6) 的像素坐标
+ *    由 "对位误差" 决定，长距离移动停稳后重新随机，短距离修正则按车体位移抵消。
+ *    主控的 's' 请求改写类别位 / 区域 / 帧率，下一个物理步长回 'k' 应答；之后只轮流上报
+ *    请求的类别，区域外的目标不上报。
+ */
+
+#include <rtthread.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <rtdbg.h>
+#include "sim_world.h"
+#include "../../User/My_App/app_param.h"
+#include "../../User/My_App/app_imu_proc.h"
+#include "../../User/My_App/app_qr_proc.h"
+#include "../../User/My_App/app_vision_proc.h"
+#include "../../User/My_Driver/bsp_uart.h"
+
+#define SIM_WORLD_PRIORITY 0
+#define SIM_PHYS_DT_MS 1
+#define SIM_IMU_BAUD_DEFAULT 115200
+#define SIM_VISION_PERIOD_MS 33
+#define SIM_KEY_HOLD_MS 300
+
+#define SIM_WHEEL_K_MM 200.0    /* 麦轮 (Lx + Ly)，决定旋转角速度 */
+#define SIM_QR_TRIGGER_MM 500.0 /* 车体前进越过该位置时扫到二维码 */
+#define SIM_QR_SPAN_MM 300.0    /* 码留在视野里的行程 */
+#define SIM_QR_PERIOD_MS 100    /* 码在视野里时的上报周期 */
+#define SIM_LONG_MOVE_MM 100.0 /* 超过该距离的移动会重新产生对位误差 */
+
+#define SIM_DEG2RAD (3.14159265358979 / 180.0)
+
+static Sim_Config_t sim_cfg;
+static Sim_Stats_t sim_stats;
+
+/* IMU 模块寄存器 (可被 wit_c_sdk 命令改写) */
+static rt_uint32_t imu_period_ms = 10;          /* RRATE: 输出周期 */
+static rt_uint16_t imu_rsw = 0x01 | 0x04 | 0x08; /* RSW: 时间 + 角速度 + 角度 */
+static rt_uint32_t imu_baud = SIM_IMU_BAUD_DEFAULT;
+static rt_uint32_t imu_host_baud = SIM_IMU_BAUD_DEFAULT;
+static uint8_t imu_cmd[5];
+static int imu_cmd_len = 0;
+
+static double align_x_mm = 0.0; /* 色环相对相机中心的前后偏差 */
+static double align_y_mm = 0.0; /* 色环相对相机中心的左右偏差 */
+static double move_len_mm = 0.0;
+static int vision_id = 0;
+
+/* 相机请求 (可被主控 's' 命令改写) */
+static uint8_t vision_mask = 0x3F;
+static int vision_roi[4] = {0, 0, 319, 239};
+static rt_uint32_t vision_period_ms = SIM_VISION_PERIOD_MS;
+static int vision_ack_seq = -1; /* 待回的应答序号 */
+
+/* 运动段记录：底盘从静止到再次静止记为一段 */
+static int seg_moving = 0;
+static rt_uint32_t seg_start_tick = 0;
+static double seg_x0, seg_y0, seg_th0;
+
+static double Sim_Rand(double span)
+{
+    return ((double)rand() / (double)RAND_MAX * 2.0 - 1.0) * span;
+}
+
+int Sim_World_KeyPressed(void)
+{
+    rt_uint64_t now = rt_sim_now_ms();
+    return now >= sim_cfg.key_press_ms && now < sim_cfg.key_press_ms + SIM_KEY_HOLD_MS;
+}
+
+const Sim_Stats_t *Sim_World_Stats(void) { return &sim_stats; }
+
+/**
+ * @brief  底盘运动学积分
+ */
+static void Sim_Chassis_Step(double dt)
+{
+    double rate[5];
+    double v[4];
+
+    Sim_Motor_Advance(dt, rate);
+
+    for (int i = 0; i < 4; i++)
+        v[i] = rate[i] / PULSE_PER_MM;
+    v[0] *= 1.0 - sim_cfg.wheel_mismatch;
+    v[2] *= 1.0 - sim_cfg.wheel_mismatch;
+
+    double vx = (v[0] + v[1] + v[2] + v[3]) / 4.0;
+    double vy = (-v[0] + v[1] + v[2] - v[3]) / 4.0;
+    double wz = (-v[0] + v[1] - v[2] + v[3]) / (4.0 * SIM_WHEEL_K_MM);
+
+    double th = sim_stats.theta * SIM_DEG2RAD;
+    sim_stats.x += (vx * cos(th) - vy * sin(th)) * dt;
+    sim_stats.y += (vx * sin(th) + vy * cos(th)) * dt;
+    sim_stats.theta += wz * dt / SIM_DEG2RAD;
+    sim_stats.path_mm += sqrt(vx * vx + vy * vy) * dt;
+
+    /* 对位误差：短距离修正按车体坐标抵消，长距离移动停稳后重新随机 */
+    align_x_mm += vx * dt;
+    align_y_mm += vy * dt;
+    move_len_mm += sqrt(vx * vx + vy * vy) * dt;
+    int moving = (vx != 0.0 || vy != 0.0 || wz != 0.0);
+    if (moving)
+        sim_stats.chassis_s += dt;
+    if (rate[4] != 0.0)
+        sim_stats.lift_s += dt;
+    if (moving && !seg_moving)
+    {
+        seg_start_tick = rt_tick_get();
+        seg_x0 = sim_stats.x;
+        seg_y0 = sim_stats.y;
+        seg_th0 = sim_stats.theta;
+        sim_stats.segments++;
+    }
+    else if (!moving && seg_moving)
+    {
+        double dx = sim_stats.x - seg_x0, dy = sim_stats.y - seg_y0;
+        rt_sim_log('S', "sim.world", "segment %u: %.3f s, moved %.1f mm, yaw %.2f -> %.2f deg",
+                   sim_stats.segments, (rt_tick_get() - seg_start_tick) / 1000.0,
+                   sqrt(dx * dx + dy * dy), seg_th0, sim_stats.theta);
+    }
+    seg_moving = moving;
+
+    if (!moving && move_len_mm > 0.0)
+    {
+        if (move_len_mm > SIM_LONG_MOVE_MM)
+        {
+            align_x_mm = Sim_Rand(sim_cfg.vision_err_mm);
+            align_y_mm = Sim_Rand(sim_cfg.vision_err_mm);
+        }
+        move_len_mm = 0.0;
+    }
+}
+
+static void Sim_Put_I16(uint8_t *p, double v)
+{
+    int16_t raw = (int16_t)lrint(v);
+    p[0] = (uint8_t)(raw & 0xFF);
+    p[1] = (uint8_t)((raw >> 8) & 0xFF);
+}
+
+static void Sim_Wit_Frame(uint8_t *p, uint8_t type, double a, double b, double c, double scale)
+{
+    uint8_t sum = 0;
+
+    memset(p, 0, 11);
+    p[0] = 0x55;
+    p[1] = type;
+    Sim_Put_I16(&p[2], a / scale * 32768.0);
+    Sim_Put_I16(&p[4], b / scale * 32768.0);
+    Sim_Put_I16(&p[6], c / scale * 32768.0);
+    for (int i = 0; i < 10; i++)
+        sum += p[i];
+    p[10] = sum;
+}
+
+/**
+ * @brief  按 RSW 生成一组 IMU 帧并模拟空闲中断投递 (波特率不一致时主机收不到)
+ */
+static void Sim_IMU_Emit(double wz_dps)
+{
+    double yaw = fmod(sim_stats.theta + sim_cfg.angle_drift_dpm * rt_sim_now_ms() / 60000.0, 360.0);
+    if (yaw > 180.0)
+        yaw -= 360.0;
+    if (yaw <= -180.0)
+        yaw += 360.0;
+
+    if (imu_host_baud != imu_baud)
+        return;
+
+    Frame_t *f = Frame_Alloc();
+    if (f == RT_NULL)
+        return; /* 池空，与串口驱动一样丢帧 */
+
+    uint32_t len = 0;
+    if (imu_rsw & 0x01)
+    {
+        Sim_Wit_Frame(&f->data[len], 0x50, 0.0, 0.0, 0.0, 1.0);
+        len += 11;
+    }
+    if (imu_rsw & 0x02)
+    {
+        Sim_Wit_Frame(&f->data[len], 0x51, 0.0, 0.0, 1.0, 16.0);
+        len += 11;
+    }
+    if (imu_rsw & 0x04)
+    {
+        Sim_Wit_Frame(&f->data[len], 0x52, 0.0, 0.0, wz_dps + sim_cfg.gyro_bias_dps, 2000.0);
+        len += 11;
+    }
+    if (imu_rsw & 0x08)
+    {
+        Sim_Wit_Frame(&f->data[len], 0x53, 0.0, 0.0, yaw, 180.0);
+        len += 11;
+    }
+    if (len == 0)
+    {
+        Frame_Free(f);
+        return;
+    }
+    f->len = (uint16_t)len;
+    uart2_imu.rx_len = (uint16_t)len;
+
+    if (imu_mq == RT_NULL || rt_mq_send(imu_mq, &f, sizeof(f)) != RT_EOK)
+        Frame_Free(f);
+    sim_stats.imu_frames++;
+}
+
+/**
+ * @brief  应用一条 0xFF 0xAA 寄存器写命令 (只建模配置相关的寄存器)
+ */
+static void Sim_IMU_Apply(uint8_t reg, uint16_t val)
+{
+    static const rt_uint32_t rrate_ms[] = {[0x06] = 100, [0x07] = 50, [0x08] = 20, [0x09] = 10, [0x0b] = 5};
+    static const rt_uint32_t baud_bps[] = {[1] = 4800, [2] = 9600, [3] = 19200, [4] = 38400,
+                                           [5] = 57600, [6] = 115200, [7] = 230400};
+
+    switch (reg)
+    {
+    case 0x02: /* RSW */
+        imu_rsw = val;
+        break;
+    case 0x03: /* RRATE */
+        if (val < sizeof(rrate_ms) / sizeof(rrate_ms[0]) && rrate_ms[val] != 0)
+            imu_period_ms = rrate_ms[val];
+        break;
+    case 0x04: /* BAUD */
+        if (val < sizeof(baud_bps) / sizeof(baud_bps[0]) && baud_bps[val] != 0)
+            imu_baud = baud_bps[val];
+        break;
+    default:
+        return;
+    }
+    rt_sim_log('S', "sim.imu", "reg 0x%02x = 0x%04x (%u baud, %u ms, rsw 0x%03x)", reg, val,
+               imu_baud, imu_period_ms, imu_rsw);
+}
+
+void Sim_IMU_Write(const uint8_t *data, uint16_t len)
+{
+    if (imu_host_baud != imu_baud)
+        return; /* 波特率不一致，模块收到的是乱码 */
+
+    for (uint16_t i = 0; i < len; i++)
+    {
+        uint8_t b = data[i];
+        if ((imu_cmd_len == 0 && b != 0xFF) || (imu_cmd_len == 1 && b != 0xAA))
+        {
+            imu_cmd_len = (b == 0xFF) ? 1 : 0;
+            if (imu_cmd_len)
+                imu_cmd[0] = b;
+            continue;
+        }
+        imu_cmd[imu_cmd_len++] = b;
+        if (imu_cmd_len == 5)
+        {
+            Sim_IMU_Apply(imu_cmd[2], (uint16_t)(imu_cmd[3] | (imu_cmd[4] << 8)));
+            imu_cmd_len = 0;
+        }
+    }
+}
+
+void Sim_IMU_SetHostBaud(uint32_t baud)
+{
+    imu_host_baud = baud;
+    imu_cmd_len = 0;
+}
+
+static void Sim_QR_Emit(void)
+{
+    size_t n = strlen(sim_cfg.qr_content);
+    if (n >= UART_RX_BUF_SIZE)
+        n = UART_RX_BUF_SIZE - 1;
+
+    Frame_t *f = Frame_Alloc();
+    if (f == RT_NULL)
+        return;
+    memcpy(f->data, sim_cfg.qr_content, n);
+    f->len = (uint16_t)n;
+    uart1_qr.rx_len = (uint16_t)n;
+
+    if (qr_mq == RT_NULL || rt_mq_send(qr_mq, &f, sizeof(f)) != RT_EOK)
+        Frame_Free(f);
+    if (sim_stats.qr_tick == 0)
+        sim_stats.qr_tick = rt_tick_get();
+}
+
+static int Sim_Clamp_Px(double v, int max)
+{
+    int px = (int)lrint(v);
+    return (px < 0) ? 0 : (px > max) ? max : px;
+}
+
+/**
+ * @brief  解析主控的请求命令 (格式见 app_vision_proc.h)，应答留到下一个物理步长发出
+ */
+void Sim_Vision_Write(const uint8_t *data, uint16_t len)
+{
+    unsigned seq, mask, x0, y0, x1, y1, fps;
+    char cmd[VISION_CMD_LEN + 1], tail;
+
+    if (len != VISION_CMD_LEN)
+        return;
+    memcpy(cmd, data, len);
+    cmd[len] = '\0';
+    if (sscanf(cmd, "s%1u%2u%3u%3u%3u%3u%2u%c", &seq, &mask, &x0, &y0, &x1, &y1, &fps, &tail) != 8 || tail != 'e' || fps == 0)
+        return;
+
+    vision_mask = (mask == 0) ? 0x3F : (uint8_t)mask;
+    vision_roi[0] = (int)x0;
+    vision_roi[1] = (int)y0;
+    vision_roi[2] = (int)x1;
+    vision_roi[3] = (int)y1;
+    vision_period_ms = 1000 / fps;
+    vision_ack_seq = (int)seq;
+    rt_sim_log('S', "sim.vision", "request %u: ids 0x%02x roi (%u,%u)-(%u,%u) %u fps", seq, mask, x0, y0, x1, y1,
+               fps);
+}
+
+static void Sim_Vision_Ack(void)
+{
+    Frame_t *f = Frame_Alloc();
+    if (f == RT_NULL)
+        return;
+    f->len = (uint16_t)snprintf((char *)f->data, UART_RX_BUF_SIZE, "k%dc", vision_ack_seq);
+    vision_ack_seq = -1;
+
+    if (vision_mq == RT_NULL || rt_mq_send(vision_mq, &f, sizeof(f)) != RT_EOK)
+        Frame_Free(f);
+}
+
+static void Sim_Vision_Emit(void)
+{
+    int x = 160, y = 140;
+
+    do
+        vision_id = vision_id % 6 + 1;
+    while (!(vision_mask & (1u << (vision_id - 1))));
+
+    if (vision_id >= 4)
+    {
+        x = Sim_Clamp_Px(160.0 + align_x_mm * sim_cfg.vision_px_per_mm, 319);
+        y = Sim_Clamp_Px(140.0 + align_y_mm * sim_cfg.vision_px_per_mm, 239);
+    }
+    if (x < vision_roi[0] || y < vision_roi[1] || x > vision_roi[2] || y > vision_roi[3])
+        return; /* 区域外，相机看不到 */
+
+    Frame_t *f = Frame_Alloc();
+    if (f == RT_NULL)
+        return;
+    int n = snprintf((char *)f->data, UART_RX_BUF_SIZE, "a%d%03d%03dc", vision_id, x, y);
+    f->len = (uint16_t)n;
+    uart6_vision.rx_len = (uint16_t)n;
+
+    if (vision_mq == RT_NULL || rt_mq_send(vision_mq, &f, sizeof(f)) != RT_EOK)
+        Frame_Free(f);
+    sim_stats.vision_frames++;
+}
+
+static void sim_world_entry(void *parameter)
+{
+    double dt = SIM_PHYS_DT_MS / 1000.0;
+    double last_theta = 0.0;
+    rt_uint32_t tick = 0;
+
+    while (1)
+    {
+        Sim_Chassis_Step(dt);
+        tick += SIM_PHYS_DT_MS;
+
+        if (tick % imu_period_ms == 0)
+        {
+            Sim_IMU_Emit((sim_stats.theta - last_theta) / (imu_period_ms / 1000.0));
+            last_theta = sim_stats.theta;
+        }
+        if (vision_ack_seq >= 0)
+            Sim_Vision_Ack();
+        if (tick % vision_period_ms == 0)
+            Sim_Vision_Emit();
+        if (tick % SIM_QR_PERIOD_MS == 0 && sim_stats.x > SIM_QR_TRIGGER_MM &&
+            sim_stats.x < SIM_QR_TRIGGER_MM + SIM_QR_SPAN_MM)
+            Sim_QR_Emit();
+
+        rt_thread_mdelay(SIM_PHYS_DT_MS);
+    }
+}
+
+void Sim_World_Start(const Sim_Config_t *cfg)
+{
+    sim_cfg = *cfg;
+    srand(cfg->seed);
+
+    rt_thread_t tid = rt_thread_create("sim_world", sim_world_entry, RT_NULL, 4096, SIM_WORLD_PRIORITY, 10);
+    if (tid != RT_NULL)
+        rt_thread_startup(tid);
+}
@@ -0,0 +1,56 @@
+/**
+ * @file    sim_world.h
+ * @brief   [仿真] 物理世界：麦轮底盘运动学 + IMU / 二维码 / 视觉传感器模型
+ */
+
+#ifndef __SIM_WORLD_H
+#define __SIM_WORLD_H
+
+#include <rtthread.h>
+
+/**
+ * @brief 仿真配置 (由命令行填写)
+ */
+typedef struct
+{
+    unsigned int seed;        /* 随机种子 (视觉对位误差) */
+    const char *qr_content;   /* 二维码内容，例如 "123+231" */
+    double wheel_mismatch;    /* 左侧轮有效半径相对误差 (制造航向扰动) */
+    double vision_err_mm;     /* 长距离移动后的对位误差上限 (mm) */
+    double vision_px_per_mm;  /* 相机在色环平面的像素比例 */
+    rt_uint32_t key_press_ms; /* 按下 S1 的仿真时刻 */
+    double gyro_bias_dps;     /* IMU 角速度输出零偏 (度/s) */
+    double angle_drift_dpm;   /* IMU 角度输出漂移 (度/分钟) */
+} Sim_Config_t;
+
+/**
+ * @brief 仿真统计 (供报告使用)
+ */
+typedef struct
+{
+    double x, y;          /* 车体位置 (mm)，起点为原点，x 为初始车头方向 */
+    double theta;         /* 车体航向 (度，逆时针为正，连续) */
+    double path_mm;       /* 累计行驶路程 (mm) */
+    rt_uint32_t segments; /* 底盘运动段数 */
+    double chassis_s;     /* 底盘运动累计时间 (s) */
+    double lift_s;        /* 升降电机运动累计时间 (s) */
+    rt_uint32_t imu_frames;
+    rt_uint32_t vision_frames;
+    rt_uint32_t qr_tick;  /* 二维码发出时刻 (0 表示未发出) */
+} Sim_Stats_t;
+
+void Sim_World_Start(const Sim_Config_t *cfg);
+int Sim_World_KeyPressed(void);
+const Sim_Stats_t *Sim_World_Stats(void);
+
+/* BSP 替身导出的钩子 */
+void Sim_Motor_Advance(double dt, double rate[5]);
+void Sim_IMU_Write(const uint8_t *data, uint16_t len);
+void Sim_IMU_SetHostBaud(uint32_t baud);
+void Sim_Vision_Write(const uint8_t *data, uint16_t len);
+void Sim_Telem_Open(const char *path);
+void Sim_Telem_Close(void);
+void Sim_Fal_Load(const char *path);
+void Sim_Fal_Save(const char *path);
+
+#endif /* __SIM_WORLD_H */
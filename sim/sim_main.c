@@ -0,0 +1,178 @@
+/**
+ * @file    sim_main.c
+ * @brief   宿主机仿真入口：在 PC 上以虚拟时钟跑完整场任务并输出耗时报告
+ *
+ * @usage 使用说明:
+ * 1. 构建: cmake -S sim -B build_sim && cmake --build build_sim
+ * 2. 运行: ./build_sim/car_sim [选项]
+ *    --qr <str>        二维码内容 (默认 "123+231")
+ *    --seed <n>        视觉对位误差随机种子 (默认 1)
+ *    --mismatch <r>    左侧轮半径相对误差 (默认 0.005)
+ *    --vision-err <mm> 停车对位误差上限 (默认 12)
+ *    --px-per-mm <k>   相机像素比例 (默认 0.5)
+ *    --gyro-bias <dps> IMU 角速度零偏 (默认 0.2)
+ *    --imu-drift <dpm> IMU 角度输出漂移，度/分钟 (默认 0.5)
+ *    --timeout <s>     仿真时长上限 (默认 7200)
+ *    --flash <file>    参数分区镜像文件 (启动前加载，结束后写回)
+ *    --telem <file>    USART3 二进制遥测输出文件 (用 tools/telem_decode.py 解码)
+ *    --cmd "<msh>"     任务开始前执行的 msh 命令，可重复 (例如 "param set move_accel 300")
+ *    --quiet           只输出最终报告
+ * 3. 退出码: 0 任务完成, 1 超时, 2 死锁
+ */
+
+#include <rtthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "port/sim_world.h"
+#include "../User/My_App/app_task_proc.h"
+
+#define SIM_MAX_CMDS 16
+#define SIM_POLL_MS 50
+
+static Sim_Config_t sim_cfg = {
+    .seed = 1,
+    .qr_content = "123+231",
+    .wheel_mismatch = 0.005,
+    .vision_err_mm = 12.0,
+    .vision_px_per_mm = 0.5,
+    .key_press_ms = 500,
+    .gyro_bias_dps = 0.2,
+    .angle_drift_dpm = 0.5,
+};
+static const char *sim_flash_path = RT_NULL;
+static const char *sim_telem_path = RT_NULL;
+static const char *sim_cmds[SIM_MAX_CMDS];
+static int sim_cmd_num = 0;
+static rt_uint32_t sim_timeout_ms = 7200000;
+static int sim_result = 1;
+static rt_uint32_t sim_start_tick = 0;
+static rt_uint32_t sim_end_tick = 0;
+
+static void Sim_Usage(const char *prog)
+{
+    fprintf(stderr, "Usage: %s [--qr str] [--seed n] [--mismatch r] [--vision-err mm] [--px-per-mm k]\n"
+                    "          [--gyro-bias dps] [--imu-drift dpm]\n"
+                    "          [--timeout s] [--flash file] [--telem file] [--cmd \"msh line\"]... [--quiet]\n",
+            prog);
+}
+
+/**
+ * @brief  仿真夹具 (运行在仿真 main 线程中，自动初始化已完成)
+ */
+static void sim_harness(void *parameter)
+{
+    for (int i = 0; i < sim_cmd_num; i++)
+    {
+        rt_kprintf("msh >%s\n", sim_cmds[i]);
+        if (rt_sim_run_cmd(sim_cmds[i]) != 0)
+            rt_kprintf("%s: command not found.\n", sim_cmds[i]);
+    }
+
+    Sim_World_Start(&sim_cfg);
+
+    /* 大脑离开 IDLE 视为任务开始，重新回到 IDLE 等待启动信号视为任务结束 */
+    int started = 0;
+    while (rt_tick_get() < sim_timeout_ms)
+    {
+        rt_thread_mdelay(SIM_POLL_MS);
+
+        int idle = rt_sim_thread_waiting("brain", &mission_event, EV_MISSION_START);
+        if (!started && !idle && rt_tick_get() >= sim_cfg.key_press_ms)
+        {
+            started = 1;
+            sim_start_tick = sim_cfg.key_press_ms;
+        }
+        else if (started && idle)
+        {
+            sim_end_tick = rt_tick_get();
+            sim_result = 0;
+            break;
+        }
+    }
+    if (sim_result != 0)
+        sim_end_tick = rt_tick_get();
+}
+
+int main(int argc, char **argv)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const char *opt = argv[i];
+        const char *val = (i + 1 < argc) ? argv[i + 1] : RT_NULL;
+
+        if (strcmp(opt, "--quiet") == 0)
+        {
+            if (freopen("/dev/null", "w", stdout) == RT_NULL)
+                return 2;
+            continue;
+        }
+        if (val == RT_NULL)
+        {
+            Sim_Usage(argv[0]);
+            return 2;
+        }
+        i++;
+
+        if (strcmp(opt, "--qr") == 0)
+            sim_cfg.qr_content = val;
+        else if (strcmp(opt, "--seed") == 0)
+            sim_cfg.seed = (unsigned int)strtoul(val, RT_NULL, 0);
+        else if (strcmp(opt, "--mismatch") == 0)
+            sim_cfg.wheel_mismatch = atof(val);
+        else if (strcmp(opt, "--vision-err") == 0)
+            sim_cfg.vision_err_mm = atof(val);
+        else if (strcmp(opt, "--px-per-mm") == 0)
+            sim_cfg.vision_px_per_mm = atof(val);
+        else if (strcmp(opt, "--gyro-bias") == 0)
+            sim_cfg.gyro_bias_dps = atof(val);
+        else if (strcmp(opt, "--imu-drift") == 0)
+            sim_cfg.angle_drift_dpm = atof(val);
+        else if (strcmp(opt, "--timeout") == 0)
+            sim_timeout_ms = (rt_uint32_t)(atof(val) * 1000.0);
+        else if (strcmp(opt, "--flash") == 0)
+            sim_flash_path = val;
+        else if (strcmp(opt, "--telem") == 0)
+            sim_telem_path = val;
+        else if (strcmp(opt, "--cmd") == 0 && sim_cmd_num < SIM_MAX_CMDS)
+            sim_cmds[sim_cmd_num++] = val;
+        else
+        {
+            Sim_Usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (sim_flash_path != RT_NULL)
+        Sim_Fal_Load(sim_flash_path);
+
+    if (sim_telem_path != RT_NULL)
+        Sim_Telem_Open(sim_telem_path);
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    rt_sim_start(sim_harness, RT_NULL);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    if (sim_flash_path != RT_NULL)
+        Sim_Fal_Save(sim_flash_path);
+    Sim_Telem_Close();
+
+    const Sim_Stats_t *st = Sim_World_Stats();
+    double wall_s = (double)(t1.tv_sec - t0.tv_sec) + (double)(t1.tv_nsec - t0.tv_nsec) / 1e9;
+    double sim_s = (double)rt_sim_now_ms() / 1000.0;
+    double mission_s = (double)(sim_end_tick - sim_start_tick) / 1000.0;
+
+    fprintf(stderr, "==================== car_sim report ====================\n");
+    fprintf(stderr, "result        : %s\n", (sim_result == 0) ? "MISSION COMPLETED" : "TIMEOUT");
+    fprintf(stderr, "mission time  : %.3f s (start %.3f s, end %.3f s)\n", mission_s,
+            sim_start_tick / 1000.0, sim_end_tick / 1000.0);
+    fprintf(stderr, "qr received   : %.3f s\n", st->qr_tick / 1000.0);
+    fprintf(stderr, "final pose    : x=%.1f mm  y=%.1f mm  yaw=%.2f deg\n", st->x, st->y, st->theta);
+    fprintf(stderr, "path length   : %.1f mm in %u segments\n", st->path_mm, st->segments);
+    fprintf(stderr, "busy time     : chassis %.3f s, arm lift %.3f s\n", st->chassis_s, st->lift_s);
+    fprintf(stderr, "frames        : imu=%u vision=%u\n", st->imu_frames, st->vision_frames);
+    fprintf(stderr, "wall time     : %.3f s (%.1fx real time)\n", wall_s, (wall_s > 0.0) ? sim_s / wall_s : 0.0);
+
+    return sim_result;
+}
@@ -0,0 +1,33 @@
+/**
+ ******************************************************************************
+ * @file    check.h
+ * @brief   宿主机测试公用断言
+ ******************************************************************************
+ * CHECK(cond, fmt, ...)   不成立时计数并打印位置与说明 (只打印前 CHECK_PRINT_MAX 条，扫描类测试不刷屏)
+ * return CHECK_DONE();    打印 PASSED / FAILED 汇总，返回进程退出码
+ ******************************************************************************
+ */
+
+#ifndef __SIM_TEST_CHECK_H
+#define __SIM_TEST_CHECK_H
+
+#include <stdio.h>
+
+#define CHECK_PRINT_MAX 20
+
+static int check_fails = 0;
+
+#define CHECK(cond, ...)                                                                                               \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (!(cond) && check_fails++ < CHECK_PRINT_MAX)                                                                \
+        {                                                                                                              \
+            printf("FAIL %s:%d: ", __FILE__, __LINE__);                                                                \
+            printf(__VA_ARGS__);                                                                                       \
+            printf("\n");                                                                                              \
+        }                                                                                                              \
+    } while (0)
+
+#define CHECK_DONE() (printf("%s (%d failures)\n", check_fails ? "FAILED" : "PASSED", check_fails), check_fails ? 1 : 0)
+
+#endif /* __SIM_TEST_CHECK_H */
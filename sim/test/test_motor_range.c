@@ -0,0 +1,86 @@
+/**
+ ******************************************************************************
+ * @file    test_motor_range.c
+ * @brief   宿主机测试：步进预分频档位选择与比较间隔的量化误差
+ ******************************************************************************
+ * 对 TIM1 (168MHz) / TIM2 (84MHz)，从每个初始档位出发，按对数步长扫 1.53 ~ 20000 步/s：
+ * - 选中的档位必须是能装下该间隔的最细档位 (考虑切细时的回差)；
+ * - 间隔在 [MIN, MAX] 内，且同一档位内随步频单调不增；
+ * - 实际步频 tick / iv 与目标的相对误差不超过四舍五入界 0.5 / iv；
+ * - 8MHz 档 (>= 122 步/s) 误差 < 0.25%。
+ ******************************************************************************
+ */
+
+#include "bsp_motor_range.h"
+#include "check.h"
+#include <math.h>
+#include <stdio.h>
+
+#define RATE_MIN 1.53f
+#define RATE_MAX 20000.0f
+#define SWEEP_POINTS 4000
+
+static void Sweep(uint32_t clk_hz, uint8_t start)
+{
+    uint8_t range = start;
+    uint32_t last_iv = MOTOR_INTERVAL_MAX + 1;
+    uint8_t last_range = 0xFF;
+    double worst = 0.0;
+
+    for (int i = 0; i <= SWEEP_POINTS; i++)
+    {
+        float rate = RATE_MIN * powf(RATE_MAX / RATE_MIN, (float)i / SWEEP_POINTS);
+        uint8_t prev = range;
+        range = Motor_Range_Select(clk_hz, prev, rate);
+
+        /* 最细可用档位：更细的档位 (含回差) 都装不下 */
+        uint32_t tick = Motor_Range_Tick(clk_hz, range);
+        CHECK(tick / rate <= MOTOR_INTERVAL_MAX, "clk %u rate %.3f: range %u overflows", clk_hz, rate, range);
+        for (uint8_t j = 0; j < range; j++)
+        {
+            float limit = (float)MOTOR_INTERVAL_MAX * ((j < prev) ? MOTOR_RANGE_HYST : 1.0f);
+            CHECK(Motor_Range_Tick(clk_hz, j) / rate > limit, "clk %u rate %.3f: range %u fits but chose %u", clk_hz,
+                  rate, j, range);
+        }
+
+        uint32_t iv = Motor_Range_Interval(tick, rate);
+        CHECK(iv >= MOTOR_INTERVAL_MIN && iv <= MOTOR_INTERVAL_MAX, "clk %u rate %.3f: iv %u out of bounds", clk_hz,
+              rate, iv);
+
+        if (range == last_range)
+            CHECK(iv <= last_iv, "clk %u rate %.3f: iv %u > previous %u", clk_hz, rate, iv, last_iv);
+        last_range = range;
+        last_iv = iv;
+
+        double err = fabs((double)tick / iv - rate) / rate;
+        CHECK(err <= 0.5 / iv + 1e-6, "clk %u rate %.3f: err %.5f%% > rounding bound (iv %u)", clk_hz, rate,
+              err * 100.0, iv);
+        if (rate >= 122.0f)
+            CHECK(err < 0.0025, "clk %u rate %.3f: err %.5f%% >= 0.25%%", clk_hz, rate, err * 100.0);
+        if (err > worst)
+            worst = err;
+    }
+    printf("clk %9u start %u: worst err %.4f%%\n", clk_hz, start, worst * 100.0);
+}
+
+int main(void)
+{
+    const uint32_t clks[] = {168000000, 84000000};
+
+    for (unsigned c = 0; c < sizeof(clks) / sizeof(clks[0]); c++)
+    {
+        /* 实际计数频率须由整数 PSC 精确得到，且不低于标称值 (84MHz 下 8MHz 档实为 8.4MHz) */
+        for (uint8_t r = 0; r < MOTOR_RANGE_NUM; r++)
+        {
+            uint32_t tick = Motor_Range_Tick(clks[c], r);
+            CHECK(tick * (clks[c] / motor_range_hz[r]) == clks[c], "clk %u range %u: tick %u not exact", clks[c], r,
+                  tick);
+            CHECK(tick >= motor_range_hz[r], "clk %u range %u: tick %u below nominal", clks[c], r, tick);
+        }
+
+        for (uint8_t s = 0; s < MOTOR_RANGE_NUM; s++)
+            Sweep(clks[c], s);
+    }
+
+    return CHECK_DONE();
+}
@@ -0,0 +1,86 @@
+/**
+ ******************************************************************************
+ * @file    test_yaw_est.c
+ * @brief   宿主机测试：航向估计器在静止日志上的零偏 / 漂移收敛
+ ******************************************************************************
+ * 手头没有实车静止日志，用按 HWT101 输出特性合成的 200Hz 日志代替 (同一帧先 Predict 角速度、再 Correct 角度，与 imu_proc 一致)：
+ * - 陀螺 = 真实角速度 + 零偏 0.3 度/s + 噪声；
+ * - 角度 = 真实航向 + 漂移 0.6 度/分钟，量化为 180/32768 度；
+ * 1. 静止 120s：零偏、漂移率收敛到真值附近，估计航向不随漂移走；
+ * 2. 转 90 度后不再标记静止 60s：按学到的零偏与漂移率外推，航向误差仍在容差内。
+ ******************************************************************************
+ */
+
+#include "yaw_est.h"
+#include "check.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define FRAME_MS 5u
+#define GYRO_BIAS 0.3f    /* 度/s */
+#define GYRO_NOISE 0.05f  /* 度/s，均匀分布半幅 */
+#define ABS_DRIFT 0.01f   /* 度/s (0.6 度/分钟) */
+#define ABS_LSB (180.0f / 32768.0f)
+#define YAW0 37.0f
+
+#define TOL_BIAS 0.01f  /* 度/s */
+#define TOL_DRIFT 0.002f /* 度/s */
+#define TOL_YAW 0.1f    /* 度 */
+
+static uint32_t lcg = 12345u;
+
+/* [-1, 1) 均匀噪声，固定种子保证可复现 */
+static float Noise(void)
+{
+    lcg = lcg * 1664525u + 1013904223u;
+    return (float)(lcg >> 8) / (float)(1u << 23) - 1.0f;
+}
+
+/* 合成日志的状态：真实航向与时刻 */
+static float truth = YAW0;
+static uint32_t now_ms = 0;
+
+/**
+ * @brief  按真实角速度 w (度/s) 推进 ms 毫秒，每帧喂一次估计器
+ */
+static void Feed(Yaw_Est_t *est, float w, uint32_t ms)
+{
+    for (uint32_t t = 0; t < ms; t += FRAME_MS)
+    {
+        now_ms += FRAME_MS;
+        truth += w * FRAME_MS / 1000.0f;
+
+        float gz = w + GYRO_BIAS + GYRO_NOISE * Noise();
+        float abs_yaw = truth + ABS_DRIFT * now_ms / 1000.0f;
+        abs_yaw = roundf(abs_yaw / ABS_LSB) * ABS_LSB;
+
+        Yaw_Est_Predict(est, gz, now_ms);
+        Yaw_Est_Correct(est, abs_yaw);
+    }
+}
+
+int main(void)
+{
+    Yaw_Est_t est;
+    Yaw_Est_Init(&est, 0.3f, 10.0f); /* 与 YAW_EST_TAU / YAW_EST_LEARN_TAU 相同 */
+
+    /* 1. 静止学习 */
+    Yaw_Est_SetStill(&est, 1);
+    Feed(&est, 0.0f, 120000);
+    printf("still   : bias %.4f drift %.5f yaw err %.4f\n", est.bias, est.drift, est.yaw - truth);
+    CHECK(fabsf(est.bias - GYRO_BIAS) < TOL_BIAS, "bias %.4f, expected %.4f", est.bias, GYRO_BIAS);
+    CHECK(fabsf(est.drift - ABS_DRIFT) < TOL_DRIFT, "drift %.5f, expected %.5f", est.drift, ABS_DRIFT);
+    CHECK(fabsf(est.yaw - truth) < TOL_YAW, "still yaw err %.4f", est.yaw - truth);
+    CHECK(fabsf(Yaw_Est_At(&est, now_ms + 20) - truth) < TOL_YAW, "extrapolated yaw err %.4f",
+          Yaw_Est_At(&est, now_ms + 20) - truth);
+
+    /* 2. 运动：转 90 度后停住但不再标记静止，漂移只能靠学到的漂移率外推 */
+    Yaw_Est_SetStill(&est, 0);
+    Feed(&est, 45.0f, 2000);
+    Feed(&est, 0.0f, 60000);
+    printf("moving  : bias %.4f drift %.5f yaw err %.4f\n", est.bias, est.drift, est.yaw - truth);
+    CHECK(fabsf(est.yaw - truth) < 2.0f * TOL_YAW, "moving yaw err %.4f", est.yaw - truth);
+
+    return CHECK_DONE();
+}
@@ -0,0 +1,197 @@
+#!/usr/bin/env python3
+"""
+USART3 二进制遥测解码 (帧格式见 User/My_App/app_telem_proc.h)
+
+用法:
+    python3 tools/telem_decode.py telem.bin -o telem.csv          # 仿真输出 (car_sim --telem telem.bin) 或串口抓包文件
+    python3 tools/telem_decode.py /dev/ttyUSB0 --baud 460800 -o live.csv   # 直接读串口 (需要 pyserial)，Ctrl+C 结束
+    python3 tools/telem_decode.py telem.bin --plot                # 绘制航向/轮速/PID 曲线 (需要 matplotlib)
+
+输出 CSV 每行一帧，另附由里程与航向积分出的车体位姿 x/y (mm，发车坐标系)。
+"""
+
+import argparse
+import csv
+import math
+import struct
+import sys
+
+SYNC = b"\xA5\x5A"
+TYPE_CTRL = 0x01
+CTRL = struct.Struct("<2sBBHBBIf4f4i3f4fBBHHH")
+assert CTRL.size == 84, "must match TELEM_CTRL_SIZE"
+
+FIELDS = (["seq", "tick", "mode", "flags", "leg", "speed"]
+          + ["wheel%d" % i for i in range(1, 5)]
+          + ["steps%d" % i for i in range(1, 5)]
+          + ["yaw", "yaw_rate", "yaw_ref", "pid_p", "pid_i", "pid_d", "pid_out",
+             "vis_id", "vis_x", "vis_y"])
+
+MODES = ["STOP", "FORWARD", "BACKWARD", "SLIDE_LEFT", "SLIDE_RIGHT", "DIAG_FL", "DIAG_FR",
+         "DIAG_BL", "DIAG_BR", "TURN_LEFT", "TURN_RIGHT", "TURN_ABS", "RELAY_TUNE"]
+
+
+def crc16_ccitt(data):
+    crc = 0xFFFF
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) & 0xFFFF if crc & 0x8000 else (crc << 1) & 0xFFFF
+    return crc
+
+
+def parse_ctrl(frame):
+    (_, _, _, seq, mode, flags, tick, speed,
+     w1, w2, w3, w4, s1, s2, s3, s4,
+     yaw, yaw_rate, yaw_ref, p, i, d, out,
+     vis_id, leg, vis_x, vis_y, _) = CTRL.unpack(frame)
+    return {
+        "seq": seq, "tick": tick, "mode": mode, "flags": flags, "leg": leg, "speed": speed,
+        "wheel1": w1, "wheel2": w2, "wheel3": w3, "wheel4": w4,
+        "steps1": s1, "steps2": s2, "steps3": s3, "steps4": s4,
+        "yaw": yaw, "yaw_rate": yaw_rate, "yaw_ref": yaw_ref,
+        "pid_p": p, "pid_i": i, "pid_d": d, "pid_out": out,
+        "vis_id": vis_id, "vis_x": vis_x, "vis_y": vis_y,
+    }
+
+
+class Decoder:
+    """字节流重同步解码：按帧头找帧，CRC 不过则丢 1 字节继续找"""
+
+    def __init__(self):
+        self.buf = bytearray()
+        self.crc_err = 0
+        self.lost = 0
+        self.last_seq = None
+
+    def feed(self, data):
+        self.buf += data
+        while True:
+            pos = self.buf.find(SYNC)
+            if pos < 0:
+                del self.buf[:-1]
+                return
+            del self.buf[:pos]
+            if len(self.buf) < 4:
+                return
+            length = self.buf[3]
+            if self.buf[2] != TYPE_CTRL or length != CTRL.size:
+                del self.buf[:1]
+                continue
+            if len(self.buf) < length:
+                return
+            frame = bytes(self.buf[:length])
+            if crc16_ccitt(frame[2:-2]) != struct.unpack_from("<H", frame, length - 2)[0]:
+                self.crc_err += 1
+                del self.buf[:1]
+                continue
+            del self.buf[:length]
+            rec = parse_ctrl(frame)
+            if self.last_seq is not None:
+                self.lost += (rec["seq"] - self.last_seq - 1) & 0xFFFF
+            self.last_seq = rec["seq"]
+            yield rec
+
+
+class Pose:
+    """由四轮里程 (麦轮正解) 与航向积分车体位姿；段序号变化时里程从 0 重新计"""
+
+    def __init__(self, pulse_per_mm):
+        self.k = 1.0 / pulse_per_mm
+        self.x = self.y = 0.0
+        self.leg = None
+        self.prev = (0, 0, 0, 0)
+
+    def update(self, rec):
+        steps = (rec["steps1"], rec["steps2"], rec["steps3"], rec["steps4"])
+        if rec["leg"] != self.leg:
+            self.leg = rec["leg"]
+            self.prev = (0, 0, 0, 0)
+        d = [a - b for a, b in zip(steps, self.prev)]
+        self.prev = steps
+        dx = (d[0] + d[1] + d[2] + d[3]) * 0.25 * self.k
+        dy = (-d[0] + d[1] + d[2] - d[3]) * 0.25 * self.k
+        th = math.radians(rec["yaw"])
+        self.x += dx * math.cos(th) - dy * math.sin(th)
+        self.y += dx * math.sin(th) + dy * math.cos(th)
+        return self.x, self.y
+
+
+def read_chunks(args):
+    if args.input.startswith("/dev/") or args.input.upper().startswith("COM"):
+        import serial  # pyserial
+        with serial.Serial(args.input, args.baud, timeout=0.1) as port:
+            try:
+                while True:
+                    yield port.read(4096)
+            except KeyboardInterrupt:
+                return
+    else:
+        with open(args.input, "rb") as f:
+            while True:
+                chunk = f.read(65536)
+                if not chunk:
+                    return
+                yield chunk
+
+
+def plot(rows):
+    import matplotlib.pyplot as plt
+
+    t = [r["tick"] / 1000.0 for r in rows]
+    fig, ax = plt.subplots(4, 1, sharex=True, figsize=(10, 9))
+    ax[0].plot(t, [r["yaw"] for r in rows], label="yaw")
+    ax[0].plot(t, [r["yaw_ref"] for r in rows], "--", label="yaw_ref")
+    ax[0].set_ylabel("deg")
+    for i in range(1, 5):
+        ax[1].plot(t, [r["wheel%d" % i] for r in rows], label="M%d" % i)
+    ax[1].set_ylabel("mm/s")
+    for k in ("pid_p", "pid_i", "pid_d", "pid_out"):
+        ax[2].plot(t, [r[k] for r in rows], label=k)
+    ax[2].set_ylabel("mm/s")
+    ax[3].plot(t, [r["yaw_rate"] for r in rows], label="yaw_rate")
+    ax[3].set_ylabel("deg/s")
+    ax[3].set_xlabel("t (s)")
+    for a in ax:
+        a.legend(loc="upper right", fontsize="small")
+        a.grid(True)
+    plt.tight_layout()
+    plt.show()
+
+
+def main():
+    ap = argparse.ArgumentParser(description="decode USART3 binary telemetry")
+    ap.add_argument("input", help="capture file or serial port")
+    ap.add_argument("-o", "--output", help="CSV output (default stdout)")
+    ap.add_argument("--baud", type=int, default=460800, help="serial baud (default 460800)")
+    ap.add_argument("--ppm", type=float, default=15.6, help="pulse_per_mm for pose (default 15.6)")
+    ap.add_argument("--plot", action="store_true", help="plot after decoding")
+    args = ap.parse_args()
+
+    out = open(args.output, "w", newline="") if args.output else sys.stdout
+    writer = csv.writer(out)
+    writer.writerow(FIELDS + ["mode_name", "x", "y"])
+
+    dec = Decoder()
+    pose = Pose(args.ppm)
+    rows = []
+    frames = 0
+    for chunk in read_chunks(args):
+        for rec in dec.feed(chunk):
+            frames += 1
+            x, y = pose.update(rec)
+            name = MODES[rec["mode"]] if rec["mode"] < len(MODES) else str(rec["mode"])
+            writer.writerow([("%.3f" % rec[k]) if isinstance(rec[k], float) else rec[k] for k in FIELDS]
+                            + [name, "%.1f" % x, "%.1f" % y])
+            if args.plot:
+                rows.append(rec)
+
+    if out is not sys.stdout:
+        out.close()
+    sys.stderr.write("frames: %d, lost: %d, crc errors: %d\n" % (frames, dec.lost, dec.crc_err))
+    if args.plot and rows:
+        plot(rows)
+
+
+if __name__ == "__main__":
+    main()
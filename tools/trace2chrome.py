@@ -0,0 +1,172 @@
+#!/usr/bin/env python3
+"""
+内核追踪导出 -> Chrome trace / Perfetto JSON (导出格式见 User/Components/trace_rec.h)
+
+用法:
+    python3 tools/trace2chrome.py console.log -o trace.json   # msh `trace dump` 的控制台输出 (十六进制)
+    python3 tools/trace2chrome.py uart3.bin -o trace.json     # `trace dump uart3` 的 USART3 抓包 (可夹杂遥测帧)
+
+生成的 JSON 用 chrome://tracing 或 https://ui.perfetto.dev 打开：
+- 每个线程一条轨道，运行区间为色块，IPC 操作为瞬时事件；
+- 每个中断一条轨道 (ISR 进程下)，显示每次中断的持续时间；
+- TRACE_BEGIN/END 区间显示在发起线程的轨道上。
+"""
+
+import argparse
+import json
+import re
+import struct
+import sys
+
+HDR = struct.Struct("<4sHHIIIHH")
+NAME = struct.Struct("<IB15s")
+EV = struct.Struct("<IBBHI")
+
+EV_SWITCH, EV_ISR_ENTER, EV_ISR_EXIT, EV_IPC_TRY, EV_IPC_TAKE, EV_IPC_PUT, EV_BEGIN, EV_END, EV_MARK = range(1, 10)
+IPC_LABEL = {EV_IPC_TRY: "try", EV_IPC_TAKE: "take", EV_IPC_PUT: "put"}
+
+# STM32F407 异常号 (IRQn + 16) -> 名称，只列出本工程用到的中断
+IRQ_NAMES = {
+    15: "SysTick", 28: "DMA1_Stream1", 30: "DMA1_Stream3", 32: "DMA1_Stream5", 33: "DMA1_Stream6",
+    43: "TIM1_CC", 44: "TIM2", 53: "USART1", 54: "USART2", 55: "USART3",
+    73: "DMA2_Stream1", 74: "DMA2_Stream2", 85: "DMA2_Stream6", 86: "DMA2_Stream7", 87: "USART6",
+}
+
+PID_THREADS = 1
+PID_ISR = 2
+
+
+def load_blob(path):
+    """返回导出的二进制块：二进制抓包里直接找 RTTR，控制台日志里取 TRACE BEGIN/END 之间的十六进制"""
+    data = open(path, "rb").read()
+    pos = data.find(b"RTTR")
+    if pos >= 0:
+        return data[pos:]
+
+    text = data.decode("ascii", errors="ignore")
+    m = re.search(r"TRACE BEGIN\s*\n(.*?)TRACE END", text, re.S)
+    if not m:
+        sys.exit("no trace dump found in %s" % path)
+    hexstr = "".join(re.findall(r"^[0-9a-f]+$", m.group(1), re.M))
+    return bytes.fromhex(hexstr)
+
+
+def parse(blob):
+    magic, version, ev_size, core_hz, count, lost, name_count, name_size = HDR.unpack_from(blob, 0)
+    if magic != b"RTTR" or version != 1 or ev_size != EV.size or name_size != NAME.size:
+        sys.exit("unsupported trace dump (version %d)" % version)
+
+    off = HDR.size
+    names = {}
+    for _ in range(name_count):
+        obj, kind, raw = NAME.unpack_from(blob, off)
+        names[obj] = (kind, raw.split(b"\0", 1)[0].decode("ascii", errors="replace"))
+        off += NAME.size
+
+    need = off + count * EV.size
+    if len(blob) < need:
+        sys.stderr.write("dump truncated: %d of %d events\n" % ((len(blob) - off) // EV.size, count))
+        count = (len(blob) - off) // EV.size
+
+    events = []
+    wrap = 0
+    last = None
+    for i in range(count):
+        cyc, typ, irq, _, obj = EV.unpack_from(blob, off + i * EV.size)
+        # CYCCNT 约 25s 回绕一次，按单调递增展开
+        if last is not None and cyc < last:
+            wrap += 1 << 32
+        last = cyc
+        events.append((cyc + wrap, typ, irq, obj))
+    return core_hz, lost, names, events
+
+
+def convert(core_hz, names, events):
+    out = []
+    if not events:
+        return out
+    t0 = events[0][0]
+    us = lambda c: (c - t0) * 1e6 / core_hz
+
+    def name_of(obj):
+        return names.get(obj, (0, "0x%08x" % obj))[1]
+
+    tids = {}
+
+    def tid_of(obj):
+        if obj not in tids:
+            tids[obj] = len(tids) + 1
+            out.append({"ph": "M", "name": "thread_name", "pid": PID_THREADS, "tid": tids[obj],
+                        "args": {"name": name_of(obj)}})
+        return tids[obj]
+
+    out.append({"ph": "M", "name": "process_name", "pid": PID_THREADS, "args": {"name": "threads"}})
+    out.append({"ph": "M", "name": "process_name", "pid": PID_ISR, "args": {"name": "ISR"}})
+
+    running, run_start = None, None
+    isr_stack = []
+    isr_seen = set()
+    open_marks = {}  # (线程, 名称) -> 开始时刻
+
+    for cyc, typ, irq, obj in events:
+        t = us(cyc)
+        if typ == EV_SWITCH:
+            if running is not None and t > run_start:
+                out.append({"ph": "X", "name": name_of(running), "cat": "run", "pid": PID_THREADS,
+                            "tid": tid_of(running), "ts": run_start, "dur": t - run_start})
+            running, run_start = obj, t
+        elif typ == EV_ISR_ENTER:
+            isr_stack.append((irq, t))
+        elif typ == EV_ISR_EXIT and isr_stack:
+            num, start = isr_stack.pop()
+            if num not in isr_seen:
+                isr_seen.add(num)
+                out.append({"ph": "M", "name": "thread_name", "pid": PID_ISR, "tid": num,
+                            "args": {"name": IRQ_NAMES.get(num, "IRQ%d" % (num - 16))}})
+            out.append({"ph": "X", "name": IRQ_NAMES.get(num, "IRQ%d" % (num - 16)), "cat": "isr",
+                        "pid": PID_ISR, "tid": num, "ts": start, "dur": t - start})
+        elif typ in IPC_LABEL:
+            where = {"pid": PID_ISR, "tid": irq} if irq else {"pid": PID_THREADS, "tid": tid_of(running or 0)}
+            out.append(dict({"ph": "i", "s": "t", "name": "%s %s" % (IPC_LABEL[typ], name_of(obj)),
+                             "cat": "ipc", "ts": t}, **where))
+        elif typ in (EV_BEGIN, EV_END, EV_MARK):
+            owner = running or 0
+            label = name_of(obj)
+            if typ == EV_MARK:
+                out.append({"ph": "i", "s": "t", "name": label, "cat": "mark", "pid": PID_THREADS,
+                            "tid": tid_of(owner), "ts": t})
+                continue
+            key = (owner, obj)
+            # 同名区间未结束又开始 (中途 continue 跳过了 END)：把上一段截断在这里
+            if key in open_marks:
+                start = open_marks.pop(key)
+                out.append({"ph": "X", "name": label, "cat": "mark", "pid": PID_THREADS,
+                            "tid": tid_of(owner), "ts": start, "dur": t - start})
+            if typ == EV_BEGIN:
+                open_marks[key] = t
+
+    if running is not None:
+        t = us(events[-1][0])
+        out.append({"ph": "X", "name": name_of(running), "cat": "run", "pid": PID_THREADS,
+                    "tid": tid_of(running), "ts": run_start, "dur": t - run_start})
+    return out
+
+
+def main():
+    ap = argparse.ArgumentParser(description="convert RT-Thread trace dump to Chrome trace JSON")
+    ap.add_argument("input", help="console log with hex dump, or USART3 binary capture")
+    ap.add_argument("-o", "--output", default="trace.json", help="JSON output (default trace.json)")
+    args = ap.parse_args()
+
+    core_hz, lost, names, events = parse(load_blob(args.input))
+    trace = convert(core_hz, names, events)
+    with open(args.output, "w") as f:
+        json.dump({"traceEvents": trace, "displayTimeUnit": "ns"}, f)
+
+    span = (events[-1][0] - events[0][0]) / core_hz * 1e3 if events else 0.0
+    sys.stderr.write("%d events (%d overwritten), %.3f ms, %d names -> %s\n"
+                     % (len(events), lost, span, len(names), args.output))
+
+
+if __name__ == "__main__":
+    main()